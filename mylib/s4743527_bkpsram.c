@@ -0,0 +1,158 @@
+/** 
+ **************************************************************
+ * @file mylib/s4743527_bkpsram.c
+ * @author agent
+ * @date 18102026
+ * @brief Backup SRAM Register Driver for saving data across resets.
+ * REFERENCE: RM0090 Reference Manual, 5.1.2 Battery backup domain
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4743527_reg_bkpsram_init() - Enables access to backup SRAM.
+ * s4743527_lib_bkpsram_write() - Saves data to backup SRAM.
+ * s4743527_lib_bkpsram_read() - Restores data from backup SRAM.
+ *************************************************************** 
+ */
+
+#include "s4743527_bkpsram.h"
+#include <stdint.h>
+
+#ifdef BKPSRAM_SIM
+// Simulated backup SRAM for running without the board.
+static BkpsramRecord simulatedSram[BKPSRAM_NUM_OF_SLOTS];
+#define BKPSRAM_SLOTS simulatedSram
+#else
+#include "processor_hal.h"
+#define BKPSRAM_SLOTS ((volatile BkpsramRecord*) BKPSRAM_BASE)
+#endif
+
+// Global variables
+// Slot with the newest record.
+static int currentSlot = -1;
+// Sequence number of the newest record.
+static uint16_t currentSequence = 0;
+
+/**
+ * Calculates the Fletcher-16 checksum of a record.
+ * 
+ * record: the record in backup SRAM.
+ * 
+ * Returns: the checksum of the record's size, sequence, and data.
+ */
+uint16_t bkpsram_checksum(volatile BkpsramRecord* record) {
+
+    uint16_t sum1 = record->size;
+    uint16_t sum2 = sum1;
+
+    sum1 = (sum1 + (record->sequence & 0xFF)) % 255;
+    sum2 = (sum2 + sum1) % 255;
+    sum1 = (sum1 + (record->sequence >> 8)) % 255;
+    sum2 = (sum2 + sum1) % 255;
+
+    for (uint8_t i = 0; i < record->size; i++) {
+        sum1 = (sum1 + record->data[i]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+
+    return (sum2 << 8) | sum1;
+}
+
+/**
+ * Enables access to backup SRAM and its regulator, so it keeps its data
+ * while VBAT is powered.
+ * 
+ * Returns: None
+ */
+extern void s4743527_reg_bkpsram_init(void) {
+
+#ifndef BKPSRAM_SIM
+    // Enable power interface clock and access to backup domain.
+    RCC->APB1ENR |= RCC_APB1ENR_PWREN;
+    PWR->CR |= PWR_CR_DBP;
+
+    // Enable backup SRAM clock.
+    RCC->AHB1ENR |= RCC_AHB1ENR_BKPSRAMEN;
+
+    // Enable backup regulator and wait for it to be ready.
+    PWR->CSR |= PWR_CSR_BRE;
+    while ((PWR->CSR & PWR_CSR_BRR) == 0);
+#endif
+
+    currentSlot = -1;
+}
+
+/**
+ * Saves data to the slot after the newest record in backup SRAM.
+ * 
+ * data: the data to save.
+ * size: the number of bytes to save (up to BKPSRAM_MAX_DATA_SIZE).
+ * 
+ * Returns: None
+ */
+extern void s4743527_lib_bkpsram_write(const void* data, int size) {
+
+    const uint8_t* bytes = data;
+
+    if (size > BKPSRAM_MAX_DATA_SIZE) {
+        return;
+    }
+
+    currentSlot = (currentSlot + 1) % BKPSRAM_NUM_OF_SLOTS;
+    currentSequence++;
+
+    volatile BkpsramRecord* record = &BKPSRAM_SLOTS[currentSlot];
+
+    // Invalidate slot first so a partly written record is never restored.
+    record->magic = 0;
+    record->size = size;
+    record->sequence = currentSequence;
+    for (uint8_t i = 0; i < size; i++) {
+        record->data[i] = bytes[i];
+    }
+    record->checksum = bkpsram_checksum(record);
+    record->magic = BKPSRAM_MAGIC;
+}
+
+/**
+ * Restores the newest valid data from backup SRAM.
+ * 
+ * data: set to the data restored.
+ * size: the number of bytes expected.
+ * 
+ * Returns: 0 if valid data was restored, -1 if there is none.
+ */
+extern int s4743527_lib_bkpsram_read(void* data, int size) {
+
+    uint8_t* bytes = data;
+    int newest = -1;
+
+    for (int slot = 0; slot < BKPSRAM_NUM_OF_SLOTS; slot++) {
+
+        volatile BkpsramRecord* record = &BKPSRAM_SLOTS[slot];
+
+        if (record->magic != BKPSRAM_MAGIC || record->size != size ||
+                record->checksum != bkpsram_checksum(record)) {
+            continue;
+        }
+
+        // Sequence numbers are compared as a difference so wrapping works.
+        if (newest == -1 || 
+                (int16_t) (record->sequence - BKPSRAM_SLOTS[newest].sequence) > 0) {
+            newest = slot;
+        }
+    }
+
+    if (newest == -1) {
+        return -1;
+    }
+
+    for (uint8_t i = 0; i < size; i++) {
+        bytes[i] = BKPSRAM_SLOTS[newest].data[i];
+    }
+
+    // Continue writing after the restored record.
+    currentSlot = newest;
+    currentSequence = BKPSRAM_SLOTS[newest].sequence;
+
+    return 0;
+}
\ No newline at end of file
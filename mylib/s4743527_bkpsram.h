@@ -0,0 +1,59 @@
+/** 
+ **************************************************************
+ * @file mylib/s4743527_bkpsram.h
+ * @author agent
+ * @date 18102026
+ * @brief Backup SRAM Register Driver for saving data across resets.
+ * REFERENCE: RM0090 Reference Manual, 5.1.2 Battery backup domain
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4743527_reg_bkpsram_init() - Enables access to backup SRAM.
+ * s4743527_lib_bkpsram_write() - Saves data to backup SRAM.
+ * s4743527_lib_bkpsram_read() - Restores data from backup SRAM.
+ *************************************************************** 
+ */
+
+#ifndef S4743527_BKPSRAM_H
+#define S4743527_BKPSRAM_H
+
+#include <stdint.h>
+
+// Number of slots used in turn, so a reset during a write keeps the
+// previous record.
+#define BKPSRAM_NUM_OF_SLOTS    2
+
+// Size of each slot in bytes.
+#define BKPSRAM_SLOT_SIZE       64
+
+// Bytes in a slot used by the record header.
+#define BKPSRAM_HEADER_SIZE     8
+
+// Maximum size of data that can be saved.
+#define BKPSRAM_MAX_DATA_SIZE   (BKPSRAM_SLOT_SIZE - BKPSRAM_HEADER_SIZE)
+
+// Value marking a slot that has been written.
+#define BKPSRAM_MAGIC           0xB5
+
+// Struct for the record stored in each slot.
+typedef struct {
+    uint8_t magic;
+    uint8_t size;
+    uint16_t sequence;
+    uint16_t checksum;
+    uint16_t reserved;
+    uint8_t data[BKPSRAM_MAX_DATA_SIZE];
+} BkpsramRecord;
+
+// Function prototypes
+
+// Enables access to backup SRAM.
+extern void s4743527_reg_bkpsram_init(void);
+
+// Saves data to the next slot of backup SRAM.
+extern void s4743527_lib_bkpsram_write(const void* data, int size);
+
+// Restores the newest valid data from backup SRAM.
+extern int s4743527_lib_bkpsram_read(void* data, int size);
+
+#endif
\ No newline at end of file
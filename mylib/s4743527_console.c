@@ -10,29 +10,126 @@
  * EXTERNAL FUNCTIONS 
  ***************************************************************
  * s4743527_lib_console_ascii2hex() - Converts ASCII to hex value.
+ * s4743527_lib_console_hex2bytes() - Converts hex text to bytes.
+ * s4743527_lib_console_bytes2hex() - Converts bytes to hex text.
  * s4743527_lib_console_dec2ascii() - Converts digit to ASCII.
+ * s4743527_lib_console_next_token() - Finds next token in a line.
+ * s4743527_lib_console_token2int() - Converts token to integer.
+ * s4743527_lib_console_escape() - Parses terminal escape sequence.
+ * s4743527_lib_console_keymap_load() - Compiles and switches keymap.
+ * s4743527_lib_console_shell_register() - Registers shell command.
  * s4743527_tsk_console_init() - Intialises RCM console task.
  *************************************************************** 
  */
 
 #include "s4743527_console.h"
 #include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
 
 #ifdef FreeRTOS
 #include "s4743527_mfs_led.h"
 #include "s4743527_rcmdisplay.h"
+#include "s4743527_rcmcont.h"
+#include "s4743527_rcmscan.h"
+#include "s4743527_rcmbookmark.h"
+#include "s4743527_rcmkeepout.h"
+#include "s4743527_rcmscript.h"
+#include "s4743527_uartrx.h"
+#include "s4743527_txradio.h"
+#include "s4743527_hostproto.h"
 #include "FreeRTOS.h"
 #include "task.h"
 #include "event_groups.h"
 #include "queue.h"
 #include "board.h"
-#include "debug_log.h"
+#include "s4743527_uarttx.h"
 #endif
 
-// Global variable
+// Global variables
 // Event group for user input.
 EventGroupHandle_t s4743527GroupEventConsoleInput;
 
+// Time the key of each input bit arrived, set before the bit is set.
+TickType_t s4743527ConsoleInputTicks[NUM_OF_INPUT_BITS];
+
+// Value of each hexadecimal character, or -1 for other characters.
+static const int8_t hexValues[256] = {
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+         0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+        -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+// Hexadecimal character of each value.
+static const char hexChars[16] = "0123456789ABCDEF";
+
+#ifdef FreeRTOS
+// Lowercase of a letter key, or the key itself otherwise.
+#define KEY_LOWER(key) ((((key) >= 'A') && ((key) <= 'Z')) ? ((key) + 32) : (key))
+
+// Entries of the key action table for a key in upper and lower case.
+#define KEY_ENTRY(key, action) \
+        [(uint8_t) (key)] = (action), [(uint8_t) KEY_LOWER(key)] = (action),
+#define BOOKMARK_ENTRY(key, number) KEY_ENTRY(key, KEY_BOOKMARK(number))
+
+// Action of every byte for keys that are not in a keymap, built at compile
+// time. Other bytes are KEY_NONE.
+static const uint8_t fixedKeyActions[256] = {
+    KEY_ENTRY(CMD_LINE_KEY, KEY_LINE)
+    KEY_ENTRY(SCRIPT_KEY, KEY_SCRIPT)
+    KEY_ENTRY(UNDO_KEY, KEY_UNDO)
+    KEY_ENTRY(REDO_KEY, KEY_REDO)
+    KEY_ENTRY(FRAME_KEY, KEY_FRAME)
+    KEY_ENTRY(SHELL_KEY, KEY_SHELL)
+    BOOKMARK_KEYMAP(BOOKMARK_ENTRY)
+};
+
+// Action tables of the current keymap and the next one to be loaded. The
+// console task reads the pointer once per byte, so a byte is never
+// classified with a table that is partly loaded.
+static uint8_t keyTables[2][256];
+static const uint8_t* volatile keyActions = keyTables[0];
+
+// Keys of the current keymap, in order of event group bit.
+static char keymapKeys[NUM_OF_INPUT_BITS + 1];
+
+// Keymaps that can be selected by name.
+static const char* const keymapNames[NUM_OF_KEYMAPS] = {"QWERTY", "AZERTY"};
+static const char* const keymaps[NUM_OF_KEYMAPS] = {KEYMAP_QWERTY, KEYMAP_AZERTY};
+
+// Keystrokes recorded for replay.
+static TraceEntry trace[TRACE_LENGTH];
+static int traceLength = 0;
+static int traceState = TRACE_OFF;
+static int traceIndex;
+static TickType_t traceStart;
+
+// Commands registered with the shell.
+static const ShellCommand* shellCommands[SHELL_MAX_COMMANDS];
+static int shellCount = 0;
+
+// Buffer that each part of the output of a shell command is written into.
+static char shellOutput[configCOMMAND_INT_MAX_OUTPUT_SIZE];
+
+// Tasks listed by the tasks command.
+static TaskStatus_t shellTasks[SHELL_MAX_TASKS];
+static int shellTaskCount;
+#endif
+
 /**
  * Converts an ASCII hexadecimal value to binary hexadecimal value.
  * 
@@ -41,16 +138,71 @@ EventGroupHandle_t s4743527GroupEventConsoleInput;
  * Returns: the binary hexadecimal value for the input. 
  */
 extern int s4743527_lib_console_ascii2hex(char value) {
+    return hexValues[(uint8_t) value];
+}
 
-    if (value >= 'A' && value <= 'F') {
-        return value - 55;
-    } else if (value >= 'a' && value <= 'f') {
-        return value - 87;
-    } else if (value >= '0' && value <= '9') {
-        return value - 48;
-    } else {
+/**
+ * Converts hexadecimal text to bytes, two characters per byte with the
+ * high digit first. The text is checked in the same pass.
+ * 
+ * hex: the hexadecimal text, in either case.
+ * length: the number of characters in the text.
+ * bytes: where the bytes are written, with room for length / 2 bytes.
+ * offset: set to the offset of the first invalid character, or to length
+ * if the text has an odd number of valid characters.
+ * 
+ * Returns: the number of bytes written, or -1 if the text is invalid.
+ */
+extern int s4743527_lib_console_hex2bytes(const char* hex, int length, uint8_t* bytes,
+        int* offset) {
+
+    int high;
+    int low;
+
+    for (int i = 0; i < length / 2; i++) {
+
+        high = hexValues[(uint8_t) hex[i * 2]];
+        low = hexValues[(uint8_t) hex[(i * 2) + 1]];
+
+        // Both values are checked with one branch, as -1 sets the sign bit.
+        if ((high | low) < 0) {
+            *offset = (i * 2) + (high >= 0);
+            return -1;
+        }
+
+        bytes[i] = (high << 4) | low;
+    }
+
+    // An invalid last character is reported before the odd length.
+    if (length % 2) {
+        *offset = (hexValues[(uint8_t) hex[length - 1]] < 0) ? length - 1 : length;
         return -1;
     }
+
+    return length / 2;
+}
+
+/**
+ * Converts bytes to uppercase hexadecimal text, two characters per byte
+ * with the high digit first.
+ * 
+ * bytes: the bytes.
+ * length: the number of bytes.
+ * hex: where the text is written, with room for length * 2 characters and
+ * a null character.
+ * 
+ * Returns: the number of characters written, without the null character.
+ */
+extern int s4743527_lib_console_bytes2hex(const uint8_t* bytes, int length, char* hex) {
+
+    for (int i = 0; i < length; i++) {
+        hex[i * 2] = hexChars[bytes[i] >> 4];
+        hex[(i * 2) + 1] = hexChars[bytes[i] & 0x0F];
+    }
+
+    hex[length * 2] = '\0';
+
+    return length * 2;
 }
 
 /**
@@ -69,67 +221,1318 @@ extern char s4743527_lib_console_dec2ascii(int value) {
     return 0;
 }
 
+/**
+ * Finds the next space separated token in a line without copying it.
+ * 
+ * line: pointer to the position in the line to search from, which is moved
+ *       to the end of the token found.
+ * length: set to the number of characters in the token found.
+ * 
+ * Returns: pointer to the start of the token, or NULL if there are no tokens left.
+ */
+extern const char* s4743527_lib_console_next_token(const char** line, int* length) {
+
+    const char* token = *line;
+
+    // Skip spaces before the token.
+    while (*token == ' ') {
+        token++;
+    }
+
+    if (*token == '\0') {
+        *line = token;
+        *length = 0;
+        return NULL;
+    }
+
+    // Find the end of the token.
+    const char* end = token;
+    while (*end != ' ' && *end != '\0') {
+        end++;
+    }
+
+    *line = end;
+    *length = end - token;
+
+    return token;
+}
+
+/**
+ * Converts a decimal token, with an optional minus sign, to an integer.
+ * 
+ * token: the start of the token.
+ * length: the number of characters in the token.
+ * value: set to the integer value of the token.
+ * 
+ * Returns: 0 if the token is a valid integer, -1 otherwise.
+ */
+extern int s4743527_lib_console_token2int(const char* token, int length, int* value) {
+
+    int sign = 1;
+    int result = 0;
+    int i = 0;
+
+    if (length > 0 && token[0] == '-') {
+        sign = -1;
+        i = 1;
+    }
+
+    // Token must have at least one digit and fit in an int.
+    if (i == length || (length - i) > 9) {
+        return -1;
+    }
+
+    for (; i < length; i++) {
+        if (token[i] < '0' || token[i] > '9') {
+            return -1;
+        }
+        result = (result * 10) + (token[i] - '0');
+    }
+
+    *value = result * sign;
+    return 0;
+}
+
 #ifdef FreeRTOS
 
 /**
- * Task for RCM console that takes input from user and sets event bits.
+ * Reads the remaining tokens in a command line as integers.
  * 
- * Returns: None
+ * line: pointer to the position in the line to read from.
+ * values: array to store the integers in.
+ * maxValues: the maximum number of integers to read.
+ * 
+ * Returns: the number of integers read, or -1 if a token is invalid or
+ *          there are too many tokens.
  */
-void console_task(void) {
+int console_line_ints(const char** line, int* values, int maxValues) {
 
-    // Intialise event group for input.
-    s4743527GroupEventConsoleInput = xEventGroupCreate();
+    const char* token;
+    int length;
+    int count = 0;
 
-    // Initialise array with valid input characters.
-    char validInput[25] = INPUT;
+    while ((token = s4743527_lib_console_next_token(line, &length)) != NULL) {
 
-    // Variable to receive character from console.
-    char recv;
+        if (count == maxValues ||
+                s4743527_lib_console_token2int(token, length, &values[count]) != 0) {
+            return -1;
+        }
+        count++;
+    }
 
-    // Event group bits that are set when key is pressed.
-    EventBits_t uxBits;
+    return count;
+}
 
-    for (;;) {
+/**
+ * Checks if a token matches a word, in either case.
+ * 
+ * token: the start of the token.
+ * length: the number of characters in the token.
+ * word: the word to compare with, ending with a null character.
+ * 
+ * Returns: 1 if the token matches the word, 0 otherwise.
+ */
+int console_token_is(const char* token, int length, const char* word) {
+
+    for (int i = 0; i < length; i++) {
+        if (KEY_LOWER(word[i]) != KEY_LOWER(token[i])) {
+            return 0;
+        }
+    }
+
+    return word[length] == '\0';
+}
+
+/**
+ * Compiles a keymap into the key action table that is not in use, then
+ * switches the console to it. The keymap is rejected if any event group bit
+ * is not bound, or a key is bound twice or clashes with a fixed key.
+ * 
+ * keys: the key of each event group bit, in order of bit.
+ * 
+ * Returns: 0 if the keymap is loaded, or -1 if it is invalid.
+ */
+extern int s4743527_lib_console_keymap_load(const char* keys) {
+
+    uint8_t* table = (uint8_t*) ((keyActions == keyTables[0]) ? keyTables[1] : keyTables[0]);
+    uint8_t key;
+    int bit;
+
+    for (int i = 0; i < 256; i++) {
+        table[i] = fixedKeyActions[i];
+    }
+
+    for (bit = 0; bit < NUM_OF_INPUT_BITS && keys[bit] != EMPTY; bit++) {
+
+        key = (uint8_t) keys[bit];
+
+        // Only printable keys can be bound, once each.
+        if (key <= ' ' || key >= 0x7F || table[key] != KEY_NONE) {
+            return -1;
+        }
+
+        table[key] = KEY_INPUT(bit);
+        table[(uint8_t) KEY_LOWER(key)] = KEY_INPUT(bit);
+        if (key >= 'a' && key <= 'z') {
+            table[key - 32] = KEY_INPUT(bit);
+        }
+    }
+
+    // Every bit must be bound, with no keys left over.
+    if (bit != NUM_OF_INPUT_BITS || keys[bit] != EMPTY) {
+        return -1;
+    }
+
+    for (bit = 0; bit <= NUM_OF_INPUT_BITS; bit++) {
+        keymapKeys[bit] = keys[bit];
+    }
+
+    keyActions = table;
+
+    return 0;
+}
+
+/**
+ * Parses a byte of a terminal escape sequence, sent for arrow, page, home,
+ * and function keys. Arrows move X and Y, page up and down move Z, home
+ * resets the position, and F1 to F4 zoom and rotate, all by a small step.
+ * A sequence that stops for longer than ESCAPE_TIMEOUT is dropped, so the
+ * bytes after a lone ESC are plain keys.
+ * 
+ * parser: the escape sequence parser.
+ * recv: the byte received.
+ * tick: the time the byte was received.
+ * 
+ * Returns: the action of a complete sequence, which is KEY_NONE if the 
+ * sequence is not known, ESCAPE_MORE if the sequence is not complete, or
+ * ESCAPE_PLAIN if the byte is not part of a sequence.
+ */
+extern int s4743527_lib_console_escape(EscapeParser* parser, char recv, TickType_t tick) {
+
+    int state = parser->state;
+    int final = EMPTY;
+
+    if (state != ESCAPE_IDLE && tick - parser->tick > ESCAPE_TIMEOUT) {
+        state = ESCAPE_IDLE;
+    }
+
+    parser->state = ESCAPE_IDLE;
+    parser->tick = tick;
+
+    if (recv == ESC) {
+        parser->state = ESCAPE_START;
+        parser->param = 0;
+        return ESCAPE_MORE;
+    }
+
+    switch (state) {
 
-        // Receive user input
-        if ((recv = BRD_debuguart_getc(0)) != EMPTY) {
+        case ESCAPE_START:
 
-            // Convert lowercase letter to uppercase.
-            if ((recv >= 'a') && (recv <= 'z')) {
-                recv -= 32;
+            if (recv == '[') {
+                parser->state = ESCAPE_CSI;
+            } else if (recv == 'O') {
+                parser->state = ESCAPE_SS3;
+            } else {
+                return ESCAPE_PLAIN;
             }
-            
-            S4743527_REG_MFS_LED_D2_TOGGLE();
+            return ESCAPE_MORE;
 
-            // Send key pressed to display task to print in console
-            xQueueSend(s4743527QueueDisplayKey, (void*) &recv, (portTickType) 10);
+        case ESCAPE_CSI:
+        case ESCAPE_PARAMS:
 
-            // Validate user input
-            for (uint8_t i = 0; i < 24; i++) {
+            // Only the first parameter is used, so modifiers are ignored.
+            if (recv >= '0' && recv <= '9') {
+                if (state == ESCAPE_CSI && parser->param < 100) {
+                    parser->param = parser->param * 10 + (recv - '0');
+                }
+                parser->state = state;
+                return ESCAPE_MORE;
+            } else if (recv == ';' || (recv >= ' ' && recv <= '?')) {
+                parser->state = ESCAPE_PARAMS;
+                return ESCAPE_MORE;
+            } else if (recv < '@' || recv > '~') {
+                return ESCAPE_PLAIN;
+            }
+
+            // ESC [ n ~ sequences are translated to the final byte of the
+            // ESC O sequence of the same key.
+            final = recv;
+            if (recv == '~') {
+                switch (parser->param) {
+                    case 1: case 7: final = 'H'; break;
+                    case 5: final = '5'; break;
+                    case 6: final = '6'; break;
+                    case 11: final = 'P'; break;
+                    case 12: final = 'Q'; break;
+                    case 13: final = 'R'; break;
+                    case 14: final = 'S'; break;
+                }
+            }
+            break;
+
+        case ESCAPE_SS3:
+
+            if (recv < '@' || recv > '~') {
+                return ESCAPE_PLAIN;
+            }
+            final = recv;
+            break;
+
+        default:
+            return ESCAPE_PLAIN;
+    }
+
+    switch (final) {
+        case 'C': return KEY_INPUT(0); // Right
+        case 'D': return KEY_INPUT(1); // Left
+        case 'A': return KEY_INPUT(2); // Up
+        case 'B': return KEY_INPUT(3); // Down
+        case '5': return KEY_INPUT(4); // Page up
+        case '6': return KEY_INPUT(5); // Page down
+        case 'P': return KEY_INPUT(INPUT_BIT_ZOOM); // F1
+        case 'Q': return KEY_INPUT(INPUT_BIT_ZOOM + 1); // F2
+        case 'R': return KEY_INPUT(INPUT_BIT_ROTATE); // F3
+        case 'S': return KEY_INPUT(INPUT_BIT_ROTATE + 1); // F4
+        case 'H': return KEY_INPUT(INPUT_BIT_RESET); // Home
+    }
+
+    return KEY_NONE;
+}
+
+/**
+ * Selects a keymap by name, loads keys given in a line, or shows the
+ * current keymap.
+ * 
+ * line: pointer to the position in the line after the command.
+ * 
+ * Returns: None
+ */
+void console_keymap(const char** line) {
+
+    const char* token;
+    int length;
+    char keys[NUM_OF_INPUT_BITS + 1];
+    int result = 0;
+
+    if ((token = s4743527_lib_console_next_token(line, &length)) != NULL) {
+
+        if (console_token_is(token, length, "SET")) {
+
+            if ((token = s4743527_lib_console_next_token(line, &length)) == NULL ||
+                    length != NUM_OF_INPUT_BITS) {
+                result = -1;
+            } else {
+                for (int i = 0; i < length; i++) {
+                    keys[i] = token[i];
+                }
+                keys[length] = EMPTY;
+                result = s4743527_lib_console_keymap_load(keys);
+            }
 
-                if (recv == validInput[i]) {
+        } else {
 
-                    // Set event group bit.
-                    uxBits = xEventGroupSetBits(s4743527GroupEventConsoleInput, 1 << i);
+            result = -1;
+            for (int i = 0; i < NUM_OF_KEYMAPS; i++) {
+                if (console_token_is(token, length, keymapNames[i])) {
+                    result = s4743527_lib_console_keymap_load(keymaps[i]);
                     break;
                 }
             }
         }
+    }
+
+    s4743527_lib_uarttx_printf("\e[%d;%dHKeymap: %s%s", KEYMAP_REPORT_Y, KEYMAP_REPORT_X, keymapKeys, 
+            (result == 0) ? "          " : " (invalid)");
+}
+
+/**
+ * Moves the RCM to a position given in a line: x y z [zoom] [rotate].
+ * 
+ * line: pointer to the position in the line after the command.
+ * 
+ * Returns: 0 if the move is sent, or -1 if the position is invalid.
+ */
+int console_goto(const char** line) {
 
-        vTaskDelay(50);
+    int values[5] = {0};
+    int count;
+    RCMCommand command;
+
+    // Zoom and rotate are optional.
+    count = console_line_ints(line, values, 5);
+    if (count < 3) {
+        return -1;
     }
+
+    command.type = RCM_CMD_GOTO;
+    command.target.xPos = values[0];
+    command.target.yPos = values[1];
+    command.target.zPos = values[2];
+    command.target.zoom = values[3];
+    command.target.rotate = values[4];
+    command.axes = RCM_AXES_FIRST(count);
+
+    xQueueSend(s4743527QueueRcmCommand, (void*) &command, (portTickType) 10);
+
+    return 0;
 }
 
 /**
- * Intialises the RCM console task and event group bits.
+ * Sets the limits and step sizes of an axis, or saves them to flash.
  * 
- * Returns: None.
+ * line: pointer to the position in the line after the command.
+ * 
+ * Returns: None
  */
-extern void s4743527_tsk_console_init(void) {
+void console_config(const char** line) {
 
-    xTaskCreate((void *) &console_task, (const signed char *) "Console Input",
-            TASK_CONSOLE_STACK_SIZE, NULL, TASK_CONSOLE_PRIORITY, NULL);
+    const char* axisNames[NUM_OF_AXES] = {"X", "Y", "Z", "ZOOM", "ROT"};
+    const char* token;
+    int length;
+    int values[2 + NUM_OF_STEPS];
+    int count;
+    AxisConfig config;
+
+    if ((token = s4743527_lib_console_next_token(line, &length)) == NULL) {
+        return;
+    }
+
+    if (console_token_is(token, length, "SAVE")) {
+        s4743527_lib_rcmcont_config_save();
+        return;
+    }
+
+    for (int axis = 0; axis < NUM_OF_AXES; axis++) {
+
+        if (console_token_is(token, length, axisNames[axis])) {
+
+            // Steps not given keep their current size.
+            count = console_line_ints(line, values, 2 + NUM_OF_STEPS);
+            if (count < 2) {
+                return;
+            }
+
+            config = s4743527RcmConfig.axis[axis];
+            config.min = values[0];
+            config.max = values[1];
+            for (int i = 2; i < count; i++) {
+                config.step[i - 2] = values[i];
+            }
+
+            s4743527_lib_rcmcont_config_set(axis, &config);
+            return;
+        }
+    }
+}
+
+/**
+ * Moves the RCM to a bookmark in one update.
+ * 
+ * number: the bookmark number.
+ * 
+ * Returns: None
+ */
+void console_bookmark_recall(int number) {
+
+    const Bookmark* bookmark = s4743527_lib_rcmbookmark_get(number);
+    RCMCommand command;
+
+    if (bookmark != NULL) {
+        command.type = RCM_CMD_GOTO;
+        command.target = bookmark->rcm;
+        command.axes = RCM_AXES_ALL;
+        xQueueSend(s4743527QueueRcmCommand, (void*) &command, (portTickType) 10);
+    }
+}
+
+/**
+ * Displays all bookmarks on the VT100 display.
+ * 
+ * Returns: None
+ */
+void console_bookmark_list(void) {
+
+    const Bookmark* bookmark;
+
+    for (int number = 0; number < NUM_OF_BOOKMARKS; number++) {
+
+        if ((bookmark = s4743527_lib_rcmbookmark_get(number)) != NULL) {
+            s4743527_lib_uarttx_printf("\e[%d;%dH%d %-8s %3d %3d %2d %d %3d", BOOKMARK_LIST_Y + number, 
+                    BOOKMARK_LIST_X, number, bookmark->name, bookmark->rcm.xPos, 
+                    bookmark->rcm.yPos, bookmark->rcm.zPos, bookmark->rcm.zoom, 
+                    bookmark->rcm.rotate);
+        } else {
+            s4743527_lib_uarttx_printf("\e[%d;%dH%d %-26s", BOOKMARK_LIST_Y + number, BOOKMARK_LIST_X, 
+                    number, "-");
+        }
+    }
+}
+
+/**
+ * Recalls, saves, deletes, or lists bookmarks.
+ * 
+ * line: pointer to the position in the line after the command.
+ * 
+ * Returns: None
+ */
+void console_bookmark(const char** line) {
+
+    const char* token;
+    const char* name;
+    int length;
+    int nameLength;
+    int number;
+
+    // List bookmarks if no other command is given.
+    if ((token = s4743527_lib_console_next_token(line, &length)) == NULL ||
+            console_token_is(token, length, "LIST")) {
+        console_bookmark_list();
+
+    } else if (console_token_is(token, length, "SAVE")) {
+
+        if ((token = s4743527_lib_console_next_token(line, &length)) == NULL ||
+                s4743527_lib_console_token2int(token, length, &number) != 0) {
+            return;
+        }
+
+        // Name is optional.
+        if ((name = s4743527_lib_console_next_token(line, &nameLength)) == NULL) {
+            name = "";
+        }
+
+        s4743527_lib_rcmbookmark_save(number, name, nameLength, &s4743527RcmState);
+
+    } else if (console_token_is(token, length, "DEL")) {
+
+        if ((token = s4743527_lib_console_next_token(line, &length)) == NULL ||
+                s4743527_lib_console_token2int(token, length, &number) != 0) {
+            return;
+        }
+
+        s4743527_lib_rcmbookmark_delete(number);
+
+    } else {
+
+        // Recall by number or name.
+        if (s4743527_lib_console_token2int(token, length, &number) != 0) {
+            number = s4743527_lib_rcmbookmark_find(token, length);
+        }
+
+        console_bookmark_recall(number);
+    }
+}
+
+/**
+ * Adds time-lapse positions, clears them, or runs a time-lapse.
+ * 
+ * line: pointer to the position in the line after the command.
+ * 
+ * Returns: None
+ */
+void console_timelapse(const char** line) {
+
+    const char* token;
+    int length;
+    int values[5];
+    int count;
+    RCMData position;
+    int axes;
+    ScanConfig scan;
+
+    if ((token = s4743527_lib_console_next_token(line, &length)) == NULL) {
+        return;
+    }
+
+    if (console_token_is(token, length, "ADD")) {
+
+        // Add current position if none is given.
+        position = s4743527RcmState;
+        axes = RCM_AXES_ALL;
+        count = console_line_ints(line, values, 5);
+
+        if (count > 0 && count < 3) {
+            return;
+        } else if (count >= 3) {
+            position.xPos = values[0];
+            position.yPos = values[1];
+            position.zPos = values[2];
+            position.zoom = (count > 3) ? values[3] : position.zoom;
+            position.rotate = (count > 4) ? values[4] : position.rotate;
+            axes = RCM_AXES_FIRST(count);
+        }
+
+        s4743527_lib_rcmscan_timelapse_add(&position, axes);
+
+    } else if (console_token_is(token, length, "CLEAR")) {
+        s4743527_lib_rcmscan_timelapse_clear();
+
+    } else if (console_token_is(token, length, "RUN")) {
+
+        // Period and dwell time can't be negative.
+        count = console_line_ints(line, values, 3);
+        if (count < 2 || values[0] < 0 || values[1] < 0) {
+            return;
+        }
+
+        scan.type = SCAN_TIMELAPSE;
+        scan.period = values[0];
+        scan.dwell = values[1];
+        scan.cycles = (count > 2) ? values[2] : 0;
+
+        xQueueSend(s4743527QueueScan, (void*) &scan, (portTickType) 10);
+    }
+}
+
+/**
+ * Shows the keep-out zones and the number of paths stopped at them.
+ * 
+ * Returns: None
+ */
+void console_keepout_list(void) {
+
+    const KeepoutZone* zone;
+
+    s4743527_lib_uarttx_printf("\e[%d;%dHKeep-out: %lu moves, %lu setpoints   ", KEEPOUT_LIST_Y, 
+            KEEPOUT_LIST_X, (unsigned long) s4743527KeepoutStats.moves, 
+            (unsigned long) s4743527KeepoutStats.setpoints);
+
+    for (int number = 0; number < NUM_OF_KEEPOUT_ZONES; number++) {
+
+        if ((zone = s4743527_lib_rcmkeepout_get(number)) != NULL) {
+            s4743527_lib_uarttx_printf("\e[%d;%dH%d %3d-%3d %3d-%3d %2d-%2d", KEEPOUT_LIST_Y + 1 + number,
+                    KEEPOUT_LIST_X, number, zone->xMin, zone->xMax, zone->yMin, 
+                    zone->yMax, zone->zMin, zone->zMax);
+        } else {
+            s4743527_lib_uarttx_printf("\e[%d;%dH%d %-25s", KEEPOUT_LIST_Y + 1 + number, KEEPOUT_LIST_X, 
+                    number, "-");
+        }
+    }
+}
+
+/**
+ * Executes a keep-out command: K ADD xMin yMin xMax yMax zMin zMax, 
+ * K CLEAR, or K LIST.
+ * 
+ * line: the rest of the command line after the command letter.
+ * 
+ * Returns: None
+ */
+void console_keepout(const char** line) {
+
+    const char* token;
+    int length;
+    int values[6];
+    KeepoutZone zone;
+
+    if ((token = s4743527_lib_console_next_token(line, &length)) == NULL) {
+        return;
+    }
+
+    if (console_token_is(token, length, "ADD")) {
+
+        if (console_line_ints(line, values, 6) != 6) {
+            return;
+        }
+
+        zone.xMin = values[0];
+        zone.yMin = values[1];
+        zone.xMax = values[2];
+        zone.yMax = values[3];
+        zone.zMin = values[4];
+        zone.zMax = values[5];
+
+        s4743527_lib_rcmkeepout_add(&zone);
+
+    } else if (console_token_is(token, length, "CLEAR")) {
+        s4743527_lib_rcmkeepout_clear();
+
+    } else if (!console_token_is(token, length, "LIST")) {
+        return;
+    }
+
+    console_keepout_list();
+}
+
+/**
+ * Receives a key from the console. Keys are added to the trace while
+ * recording, and come from the trace at their recorded times while
+ * replaying. Any key typed during a replay stops it.
+ * 
+ * tick: set to the time the key arrived, or the time a replayed key is
+ * due.
+ * 
+ * Returns: the key received, or EMPTY if there is none.
+ */
+char console_getc(TickType_t* tick) {
+
+    TickType_t now = xTaskGetTickCount();
+    char recv;
+
+    *tick = now;
+    recv = s4743527_lib_uartrx_getc(tick);
+
+    if (traceState == TRACE_REPLAY) {
+
+        if (recv != EMPTY || traceIndex >= traceLength) {
+            traceState = TRACE_OFF;
+        } else if (now - traceStart >= trace[traceIndex].tick - trace[0].tick) {
+            return trace[traceIndex++].key;
+        }
+
+    } else if (traceState == TRACE_RECORD && recv != EMPTY && 
+            traceLength < TRACE_LENGTH) {
+        // A key may have arrived before recording started.
+        trace[traceLength].tick = ((int32_t) (*tick - traceStart) > 0) ? 
+                *tick - traceStart : 0;
+        trace[traceLength].key = recv;
+        traceLength++;
+    }
+
+    return recv;
+}
+
+/**
+ * Executes a trace command: R REC, R STOP, R DUMP, or R PLAY.
+ * 
+ * line: the rest of the command line after the command letter.
+ * 
+ * Returns: None
+ */
+void console_trace(const char** line) {
+
+    const char* token;
+    int length;
+
+    if ((token = s4743527_lib_console_next_token(line, &length)) == NULL) {
+        return;
+    }
+
+    if (console_token_is(token, length, "REC")) {
+        traceLength = 0;
+        traceStart = xTaskGetTickCount();
+        traceState = TRACE_RECORD;
+
+    } else if (console_token_is(token, length, "STOP")) {
+
+        // Remove the command line that stopped recording.
+        while (traceState == TRACE_RECORD && traceLength > 0) {
+            if (trace[--traceLength].key == CMD_LINE_KEY) {
+                break;
+            }
+        }
+        traceState = TRACE_OFF;
+
+    } else if (console_token_is(token, length, "DUMP")) {
+
+        // One line per key with the time since the last key (ms).
+        s4743527_lib_uarttx_printf("\n\rTrace: %d keys\n\r", traceLength);
+        for (int i = 0; i < traceLength; i++) {
+
+            // Wait for room rather than drop lines of a long trace.
+            if (s4743527_lib_uarttx_free() < UARTTX_LINE_SIZE) {
+                s4743527_lib_uarttx_flush(portMAX_DELAY);
+            }
+            s4743527_lib_uarttx_printf("%lu %02X\n\r", (unsigned long) 
+                    (trace[i].tick - ((i > 0) ? trace[i - 1].tick : 0)), trace[i].key);
+        }
+
+    } else if (console_token_is(token, length, "PLAY") && traceState == TRACE_OFF &&
+            traceLength > 0) {
+        traceIndex = 0;
+        traceStart = xTaskGetTickCount();
+        traceState = TRACE_REPLAY;
+    }
+}
+
+/**
+ * Parses a character of a script and sends each decoded command to the
+ * script task.
+ * 
+ * parser: the script parser.
+ * recv: the character received.
+ * 
+ * Returns: 1 if the script continues, 0 if it has ended.
+ */
+int console_script(ScriptParser* parser, char recv) {
+
+    ScriptCommand command;
+
+    if (recv == SCRIPT_KEY) {
+
+        // Finish a last line without a newline.
+        if (s4743527_lib_rcmscript_parse(parser, '\n', &command) == 1) {
+            s4743527_lib_rcmscript_send(&command);
+        }
+
+        command.type = SCRIPT_END;
+        command.value = parser->errors;
+        s4743527_lib_rcmscript_send(&command);
+        return 0;
+    }
+
+    if (s4743527_lib_rcmscript_parse(parser, recv, &command) == 1) {
+        s4743527_lib_rcmscript_send(&command);
+    }
+
+    return 1;
+}
+
+/**
+ * Shell command that shows the position of the RCM and the scan state.
+ * 
+ * output: buffer the output is written into.
+ * size: the size of the buffer.
+ * line: the arguments after the command name.
+ * part: the number of the part of the output to write.
+ * 
+ * Returns: 1 if there is more output, 0 otherwise.
+ */
+int shell_status(char* output, int size, const char* line, int part) {
+
+    const char* scanStates[] = {"idle", "running", "paused"};
+
+    if (part == 0) {
+        snprintf(output, size, "Position: x %d y %d z %d zoom %d rotate %d\n\r", 
+                s4743527RcmState.xPos, s4743527RcmState.yPos, s4743527RcmState.zPos, 
+                s4743527RcmState.zoom, s4743527RcmState.rotate);
+        return 1;
+    }
+
+    snprintf(output, size, "Scan: %s, %d of %d moves\n\r", 
+            scanStates[s4743527ScanStats.state], s4743527ScanStats.moves, 
+            s4743527ScanStats.totalMoves);
+
+    return 0;
+}
+
+/**
+ * Shell command that shows the counters kept by each part of the RCM.
+ * 
+ * output: buffer the output is written into.
+ * size: the size of the buffer.
+ * line: the arguments after the command name.
+ * part: the number of the part of the output to write.
+ * 
+ * Returns: 1 if there is more output, 0 otherwise.
+ */
+int shell_stats(char* output, int size, const char* line, int part) {
+
+    switch (part) {
+
+        case 0:
+            snprintf(output, size, "UART: %lu received, %lu ring overruns, "
+                    "%lu UART overruns\n\r", 
+                    (unsigned long) s4743527UartRxStats.received,
+                    (unsigned long) s4743527UartRxStats.ringOverruns,
+                    (unsigned long) s4743527UartRxStats.uartOverruns);
+            return 1;
+
+        case 1:
+            snprintf(output, size, "UART TX: %lu sent in %lu transfers, %lu dropped "
+                    "in %lu writes\n\r", 
+                    (unsigned long) s4743527UartTxStats.sent,
+                    (unsigned long) s4743527UartTxStats.transfers,
+                    (unsigned long) s4743527UartTxStats.dropped,
+                    (unsigned long) s4743527UartTxStats.dropWrites);
+            return 1;
+
+        case 2:
+            snprintf(output, size, "Keep-out: %lu moves, %lu setpoints\n\r", 
+                    (unsigned long) s4743527KeepoutStats.moves,
+                    (unsigned long) s4743527KeepoutStats.setpoints);
+            return 1;
+
+        case 3:
+            snprintf(output, size, "Scan: %lu ms, %d cycles, %d ms drift\n\r", 
+                    (unsigned long) s4743527ScanStats.elapsed, 
+                    s4743527ScanStats.cycles, s4743527ScanStats.drift);
+            return 1;
+    }
+
+    snprintf(output, size, "Heap: %lu bytes free\n\r", 
+            (unsigned long) xPortGetFreeHeapSize());
+
+    return 0;
+}
+
+/**
+ * Shell command that lists the tasks with their state, priority and least
+ * free stack, one task per part.
+ * 
+ * output: buffer the output is written into.
+ * size: the size of the buffer.
+ * line: the arguments after the command name.
+ * part: the number of the part of the output to write.
+ * 
+ * Returns: 1 if there is more output, 0 otherwise.
+ */
+int shell_tasks(char* output, int size, const char* line, int part) {
+
+    const char states[] = "XRBSD"; // Running, ready, blocked, suspended, deleted
+    TaskStatus_t* task;
+
+    // Take a snapshot of all tasks, so the list is consistent. No snapshot
+    // is taken if there are more tasks than can be listed.
+    if (part == 0) {
+        shellTaskCount = uxTaskGetSystemState(shellTasks, SHELL_MAX_TASKS, NULL);
+        if (shellTaskCount == 0) {
+            snprintf(output, size, "Tasks: %lu, more than %d can be listed\n\r", 
+                    (unsigned long) uxTaskGetNumberOfTasks(), SHELL_MAX_TASKS);
+            return 0;
+        }
+        snprintf(output, size, "%-16s State Priority Stack\n\r", "Task");
+        return 1;
+    }
+
+    task = &shellTasks[part - 1];
+    snprintf(output, size, "%-16s %c     %8lu %5u\n\r", task->pcTaskName, 
+            (task->eCurrentState <= 4) ? states[task->eCurrentState] : '?',
+            (unsigned long) task->uxCurrentPriority, 
+            (unsigned int) task->usStackHighWaterMark);
+
+    return part < shellTaskCount;
+}
+
+/**
+ * Shell command that shows the packets sent and waiting to be sent by the
+ * radio.
+ * 
+ * output: buffer the output is written into.
+ * size: the size of the buffer.
+ * line: the arguments after the command name.
+ * part: the number of the part of the output to write.
+ * 
+ * Returns: 1 if there is more output, 0 otherwise.
+ */
+int shell_radio(char* output, int size, const char* line, int part) {
+
+    snprintf(output, size, "Radio: %lu packets sent, %lu queued\n\r", 
+            (unsigned long) s4743527RadioStats.sent, 
+            (unsigned long) uxQueueMessagesWaiting(s4743527QueueRadioPacket));
+
+    return 0;
+}
+
+/**
+ * Shell command that moves the RCM to a position.
+ * 
+ * output: buffer the output is written into.
+ * size: the size of the buffer.
+ * line: the arguments after the command name.
+ * part: the number of the part of the output to write.
+ * 
+ * Returns: 1 if there is more output, 0 otherwise.
+ */
+int shell_goto(char* output, int size, const char* line, int part) {
+
+    if (console_goto(&line) != 0) {
+        snprintf(output, size, "Usage: goto x y z [zoom] [rotate]\n\r");
+    }
+
+    return 0;
+}
+
+/**
+ * Shell command that sets the limits and step sizes of an axis, or saves
+ * them, then lists the config of each axis, one axis per part.
+ * 
+ * output: buffer the output is written into.
+ * size: the size of the buffer.
+ * line: the arguments after the command name.
+ * part: the number of the part of the output to write.
+ * 
+ * Returns: 1 if there is more output, 0 otherwise.
+ */
+int shell_config(char* output, int size, const char* line, int part) {
+
+    const char* axisNames[NUM_OF_AXES] = {"X", "Y", "Z", "ZOOM", "ROT"};
+    const AxisConfig* axis;
+
+    if (part < 0 || part >= NUM_OF_AXES) {
+        return 0;
+    }
+
+    if (part == 0) {
+        console_config(&line);
+    }
+
+    axis = &s4743527RcmConfig.axis[part];
+
+    snprintf(output, size, "%-4s %4d to %4d, steps %d %d %d\n\r", axisNames[part], 
+            axis->min, axis->max, axis->step[0], axis->step[1], axis->step[2]);
+
+    return part < NUM_OF_AXES - 1;
+}
+
+/**
+ * Shell command that lists the commands of the shell, one per part.
+ * 
+ * output: buffer the output is written into.
+ * size: the size of the buffer.
+ * line: the arguments after the command name.
+ * part: the number of the part of the output to write.
+ * 
+ * Returns: 1 if there is more output, 0 otherwise.
+ */
+int shell_help(char* output, int size, const char* line, int part) {
+
+    snprintf(output, size, "%-8s %s\n\r", shellCommands[part]->name, 
+            shellCommands[part]->help);
+
+    return part < shellCount - 1;
+}
+
+// Commands built into the shell.
+static const ShellCommand shellBuiltins[] = {
+    {"help", "List commands", shell_help},
+    {"status", "Show position and scan state", shell_status},
+    {"stats", "Show counters", shell_stats},
+    {"tasks", "List tasks", shell_tasks},
+    {"radio", "Show radio packets", shell_radio},
+    {"goto", "goto x y z [zoom] [rotate]", shell_goto},
+    {"config", "config [axis min max [steps] | save]", shell_config},
+};
+
+/**
+ * Registers a command of the shell. The command must stay valid while the
+ * shell runs.
+ * 
+ * command: the command to register.
+ * 
+ * Returns: 0 if registered, or -1 if the name is taken or there is no room.
+ */
+extern int s4743527_lib_console_shell_register(const ShellCommand* command) {
+
+    const char* name = command->name;
+    int length = 0;
+
+    while (name[length] != EMPTY) {
+        length++;
+    }
+
+    for (int i = 0; i < shellCount; i++) {
+        if (console_token_is(name, length, shellCommands[i]->name)) {
+            return -1;
+        }
+    }
+
+    if (shellCount == SHELL_MAX_COMMANDS) {
+        return -1;
+    }
+
+    shellCommands[shellCount++] = command;
+
+    return 0;
+}
+
+/**
+ * Runs the shell command named in a line. Output is written into one
+ * buffer a part at a time, and each part is sent before the next is
+ * written.
+ * 
+ * line: the line entered.
+ * 
+ * Returns: None
+ */
+void console_shell_execute(const char* line) {
+
+    const char* token;
+    int length;
+    int part = 0;
+    int more;
+
+    if ((token = s4743527_lib_console_next_token(&line, &length)) == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < shellCount; i++) {
+
+        if (console_token_is(token, length, shellCommands[i]->name)) {
+
+            do {
+                shellOutput[0] = EMPTY;
+                more = shellCommands[i]->function(shellOutput, sizeof(shellOutput), 
+                        line, part++);
+
+                // Wait for room rather than drop parts of a long listing.
+                s4743527_lib_uarttx_write_wait(shellOutput, strlen(shellOutput));
+            } while (more);
+
+            return;
+        }
+    }
+
+    s4743527_lib_uarttx_printf("Unknown command, try help\n\r");
+}
+
+/**
+ * Executes a command line entered in the console.
+ * 
+ * line: the command line, ending with a null character.
+ * 
+ * Returns: None
+ */
+void console_line_execute(const char* line) {
+
+    const char* token;
+    int length;
+    int values[7];
+    ScanConfig scan;
+
+    if ((token = s4743527_lib_console_next_token(&line, &length)) == NULL) {
+        return;
+    }
+
+    if (length == 1 && token[0] == CMD_GOTO) {
+
+        console_goto(&line);
+
+    } else if (length == 1 && token[0] == CMD_SCAN) {
+
+        // Dwell time can't be negative.
+        if (console_line_ints(&line, values, 7) != 7 || values[6] < 0) {
+            return;
+        }
+
+        scan.type = SCAN_TILE;
+        scan.xStart = values[0];
+        scan.yStart = values[1];
+        scan.xEnd = values[2];
+        scan.yEnd = values[3];
+        scan.step = values[4];
+        scan.zPos = values[5];
+        scan.zEnd = values[5];
+        scan.dwell = values[6];
+
+        xQueueSend(s4743527QueueScan, (void*) &scan, (portTickType) 10);
+
+    } else if (length == 1 && token[0] == CMD_ZSTACK) {
+
+        if (console_line_ints(&line, values, 4) != 4 || values[3] < 0) {
+            return;
+        }
+
+        scan.type = SCAN_ZSTACK;
+        scan.zPos = values[0];
+        scan.zEnd = values[1];
+        scan.step = values[2];
+        scan.dwell = values[3];
+
+        xQueueSend(s4743527QueueScan, (void*) &scan, (portTickType) 10);
+
+    } else if (length == 1 && token[0] == CMD_CONFIG) {
+        console_config(&line);
+
+    } else if (length == 1 && token[0] == CMD_BOOKMARK) {
+        console_bookmark(&line);
+
+    } else if (length == 1 && token[0] == CMD_TIMELAPSE) {
+        console_timelapse(&line);
+
+    } else if (length == 1 && token[0] == CMD_KEEPOUT) {
+        console_keepout(&line);
+
+    } else if (length == 1 && token[0] == CMD_TRACE) {
+        console_trace(&line);
+
+    } else if (length == 1 && token[0] == CMD_KEYMAP) {
+        console_keymap(&line);
+
+    } else if (length == 1 && token[0] == CMD_PAUSE) {
+        xEventGroupSetBits(s4743527GroupEventScan, SCAN_EVT_PAUSE);
+
+    } else if (length == 1 && token[0] == CMD_ABORT) {
+        xEventGroupSetBits(s4743527GroupEventScan, SCAN_EVT_ABORT);
+    }
+}
+
+/**
+ * Task for RCM console that takes input from user and sets event bits.
+ * 
+ * Returns: None
+ */
+void console_task(void) {
+
+    // Intialise event group for input.
+    s4743527GroupEventConsoleInput = xEventGroupCreate();
+
+    // Variable to receive character from console, and the time it arrived.
+    char recv;
+    TickType_t arrival;
+
+    // Action of the key received.
+    int action;
+
+    // Parser of escape sequences sent for arrow and function keys.
+    EscapeParser escape = {ESCAPE_IDLE, 0, 0};
+
+    // Decoder of frames sent by a host program, between keys.
+    HostDecoder host;
+    s4743527_lib_hostproto_decoder_init(&host);
+
+    // Command sent to RCM control.
+    RCMCommand command;
+
+    // Command line being entered.
+    char line[CMD_LINE_LENGTH];
+    int lineLength = 0;
+    int lineMode = 0;
+    int shellMode = 0;
+
+    // Script being streamed to the script task.
+    ScriptParser parser;
+    int scriptMode = 0;
+
+    for (;;) {
+
+        // Handle every byte received since the last wake.
+        while ((recv = console_getc(&arrival)) != EMPTY) {
+
+            if (s4743527_lib_hostproto_receive(&host, (uint8_t) recv)) {
+
+                // Frames from a host program are not keys.
+
+            } else if (scriptMode) {
+
+                // Script input is not echoed.
+                scriptMode = console_script(&parser, recv);
+
+            } else if ((action = s4743527_lib_console_escape(&escape, recv, 
+                    arrival)) != ESCAPE_MORE) {
+
+                S4743527_REG_MFS_LED_D2_TOGGLE();
+
+                if (action == ESCAPE_PLAIN) {
+
+                    action = keyActions[(uint8_t) recv];
+
+                    // Convert lowercase letter to uppercase, except in the
+                    // shell where commands are typed in lowercase.
+                    if (!shellMode && (recv >= 'a') && (recv <= 'z')) {
+                        recv -= 32;
+                    }
+
+                    // Send key pressed to display task to print in console.
+                    // Keys are not waited for, as only the latest key is shown.
+                    xQueueOverwrite(s4743527QueueDisplayKey, (void*) &recv);
+
+                } else {
+
+                    // Keys sent as escape sequences are not shown, or typed
+                    // into a command line.
+                    recv = EMPTY;
+                }
+
+                if (shellMode && recv == SHELL_KEY) {
+                    s4743527_lib_uarttx_printf("\n\r");
+                    lineMode = 0;
+                    shellMode = 0;
+
+                } else if (lineMode) {
+
+                    // Execute command line when enter is pressed. The shell
+                    // stays open for the next command.
+                    if (recv == '\r' || recv == '\n') {
+                        line[lineLength] = EMPTY;
+                        if (shellMode) {
+                            s4743527_lib_uarttx_printf("\n\r");
+                            console_shell_execute(line);
+                            s4743527_lib_uarttx_printf(SHELL_PROMPT);
+                            lineLength = 0;
+                        } else {
+                            console_line_execute(line);
+                            lineMode = 0;
+                        }
+                    } else if (recv == '\b' || recv == 0x7F) {
+                        if (lineLength > 0) {
+                            lineLength--;
+                            if (shellMode) {
+                                s4743527_lib_uarttx_printf("\b \b");
+                            }
+                        }
+                    } else if (recv >= ' ' && lineLength < CMD_LINE_LENGTH - 1) {
+                        line[lineLength++] = recv;
+                        if (shellMode) {
+                            s4743527_lib_uarttx_printf("%c", recv);
+                        }
+                    }
+
+                } else if (action == KEY_LINE) {
+                    lineMode = 1;
+                    lineLength = 0;
+
+                } else if (action == KEY_SHELL) {
+                    s4743527_lib_uarttx_printf("\n\r" SHELL_PROMPT);
+                    lineMode = 1;
+                    shellMode = 1;
+                    lineLength = 0;
+
+                } else if (action == KEY_SCRIPT) {
+                    s4743527_lib_rcmscript_parser_init(&parser);
+                    scriptMode = 1;
+
+                } else if (action == KEY_UNDO || action == KEY_REDO) {
+                    command.type = (action == KEY_UNDO) ? RCM_CMD_UNDO : RCM_CMD_REDO;
+                    xQueueSend(s4743527QueueRcmCommand, (void*) &command, (portTickType) 10);
+
+                } else if (action == KEY_FRAME) {
+                    command.type = RCM_CMD_FRAME;
+                    xQueueSend(s4743527QueueRcmCommand, (void*) &command, (portTickType) 10);
+
+                } else if (action >= KEY_INPUT(0)) {
+
+                    uint8_t bit = action - KEY_INPUT(0);
+
+                    // Let RCM control take a repeat of a key that is still
+                    // pending, so repeats are not merged.
+                    for (int wait = 0; wait < CONSOLE_REPEAT_WAIT && 
+                            (xEventGroupGetBits(s4743527GroupEventConsoleInput) & 
+                            (1 << bit)); wait++) {
+                        vTaskDelay(1);
+                    }
+
+                    // Set event group bit, with when the key arrived rather
+                    // than when it was handled.
+                    s4743527ConsoleInputTicks[bit] = arrival;
+                    xEventGroupSetBits(s4743527GroupEventConsoleInput, 1 << bit);
+
+                } else if (action >= KEY_BOOKMARK(0)) {
+
+                    // Recall bookmark
+                    console_bookmark_recall(action - KEY_BOOKMARK(0));
+                }
+            }
+        }
+
+        // Wait for more input, or until the next replayed key may be due. A
+        // frame that stops for this long is dropped, so keys are not lost.
+        if (ulTaskNotifyTake(pdTRUE, CONSOLE_WAIT_TIME) == 0) {
+            s4743527_lib_hostproto_decoder_init(&host);
+        }
+    }
+}
+
+/**
+ * Intialises the RCM console task and event group bits.
+ * 
+ * Returns: None.
+ */
+extern void s4743527_tsk_console_init(void) {
+
+    TaskHandle_t consoleTask;
+
+    s4743527_lib_console_keymap_load(KEYMAP_QWERTY);
+
+    for (int i = 0; i < sizeof(shellBuiltins) / sizeof(shellBuiltins[0]); i++) {
+        s4743527_lib_console_shell_register(&shellBuiltins[i]);
+    }
+
+    xTaskCreate((void *) &console_task, (const signed char *) "Console Input",
+            TASK_CONSOLE_STACK_SIZE, NULL, TASK_CONSOLE_PRIORITY, &consoleTask);
+
+    // Wake the console task when bytes are received.
+    s4743527_reg_uartrx_init(consoleTask);
 }
 
 #endif
\ No newline at end of file
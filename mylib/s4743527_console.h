@@ -10,7 +10,14 @@
  * EXTERNAL FUNCTIONS 
  ***************************************************************
  * s4743527_lib_console_ascii2hex() - Converts ASCII to hex value.
+ * s4743527_lib_console_hex2bytes() - Converts hex text to bytes.
+ * s4743527_lib_console_bytes2hex() - Converts bytes to hex text.
  * s4743527_lib_console_dec2ascii() - Converts digit to ASCII.
+ * s4743527_lib_console_next_token() - Finds next token in a line.
+ * s4743527_lib_console_token2int() - Converts token to integer.
+ * s4743527_lib_console_escape() - Parses terminal escape sequence.
+ * s4743527_lib_console_keymap_load() - Compiles and switches keymap.
+ * s4743527_lib_console_shell_register() - Registers shell command.
  * s4743527_tsk_console_init() - Intialises RCM console task.
  *************************************************************** 
  */
@@ -18,27 +25,188 @@
 #ifndef S4743527_CONSOLE_H
 #define S4743527_CONSOLE_H
 
+#include <stdint.h>
+
 #ifdef FreeRTOS
 #include "FreeRTOS.h"
 #include "task.h"
 #include "event_groups.h"
 
-// Global variable
+// Global variables
 // Event group for user input.
 extern EventGroupHandle_t s4743527GroupEventConsoleInput;
 
+// Time the key of each input bit arrived, set before the bit is set.
+extern TickType_t s4743527ConsoleInputTicks[];
+
 // Task Priority
 #define TASK_CONSOLE_PRIORITY  (tskIDLE_PRIORITY + 1)
 
-// Task Stack Allocation
-#define TASK_CONSOLE_STACK_SIZE    (configMINIMAL_STACK_SIZE * 5)
+// Task Stack Allocation, 1024 words (4096 bytes) on the board. Worst case:
+// - the console's own frames are at most 1008 bytes down to vsnprintf(),
+//   on its deepest path (console task, line, keep-out list, printf), from
+//   gcc -fcallgraph-info on x86-64, whose 8 byte slots and 16 byte aligned
+//   frames are no smaller than the Cortex-M4's.
+// - a context switch saves at most 204 bytes: 26 words of exception frame
+//   with the FPU in use, and r4-r11, lr and s16-s31 saved by the port.
+// That leaves 2884 bytes for vsnprintf() in the C library. Interrupts run
+// on the main stack. Check with the tasks shell command.
+#define TASK_CONSOLE_STACK_SIZE    (configMINIMAL_STACK_SIZE * 8)
+
+// Longest time the console sleeps without input, so replayed keys are on
+// time (ms).
+#define CONSOLE_WAIT_TIME 50
+
+// Longest time to wait for RCM control to take a repeated key (ms).
+#define CONSOLE_REPEAT_WAIT 20
 
 // Mask for event group bits.
 #define INPUT_EVT_MASK 0xFFFFFF
 
-// Valid input from console. 
+// No input from console.
 #define EMPTY '\0'
-#define INPUT "QWERTYASDFGHZXCVBN12345"
+
+// Keymaps, giving the key that sets each event group bit in order of bit.
+// Keys of letters match in either case.
+#define KEYMAP_QWERTY "QWERTYASDFGHZXCVBN12345"
+#define KEYMAP_AZERTY "AZERTYQSDFGHWXCVBN12345"
+#define NUM_OF_KEYMAPS 2
+
+// Event group bits of input keys. Bits below INPUT_BIT_ZOOM move position
+// along axis (bit % 6) / 2 with step size bit / 6, odd bits moving back.
+#define INPUT_BIT_ZOOM      18
+#define INPUT_BIT_ROTATE    20
+#define INPUT_BIT_RESET     22
+#define NUM_OF_INPUT_BITS   23
+
+// Actions of keys, looked up from each byte received.
+#define KEY_NONE        0
+#define KEY_LINE        1
+#define KEY_SCRIPT      2
+#define KEY_UNDO        3
+#define KEY_REDO        4
+#define KEY_FRAME       5
+#define KEY_SHELL       6
+#define KEY_BOOKMARK(number) (8 + (number))
+#define KEY_INPUT(bit)  (20 + (bit))
+
+// Character that starts a terminal escape sequence.
+#define ESC 0x1B
+
+// Longest time between bytes of an escape sequence, after which the
+// sequence is dropped (ms).
+#define ESCAPE_TIMEOUT 20
+
+// States of escape sequence parser
+#define ESCAPE_IDLE     0
+#define ESCAPE_START    1 // After ESC
+#define ESCAPE_CSI      2 // After ESC [
+#define ESCAPE_PARAMS   3 // After ; in ESC [ sequence
+#define ESCAPE_SS3      4 // After ESC O
+
+// Results of escape sequence parser, besides the action of a sequence.
+#define ESCAPE_PLAIN    -1 // Byte is not part of a sequence
+#define ESCAPE_MORE     -2 // Sequence is not complete
+
+// Struct for the escape sequence parser.
+typedef struct {
+    int state;
+    int param; // First parameter of ESC [ sequence
+    TickType_t tick; // Time the last byte was received
+} EscapeParser;
+
+// Keys to undo and redo moves.
+#define UNDO_KEY 'U'
+#define REDO_KEY 'I'
+
+// Key that toggles X/Y moves between the machine and sample frame.
+#define FRAME_KEY 'M'
+
+// Key that starts a command line, which is ended with enter.
+#define CMD_LINE_KEY '/'
+
+// Key that enters and leaves the shell, which runs a command from each
+// line entered.
+#define SHELL_KEY '\t'
+
+// Prompt shown by the shell for each command.
+#define SHELL_PROMPT "> "
+
+// Maximum number of shell commands that can be registered.
+#define SHELL_MAX_COMMANDS 16
+
+// Maximum number of tasks listed by the shell.
+#define SHELL_MAX_TASKS 16
+
+// Struct for a shell command. The function writes the next part of the
+// output into a buffer of configCOMMAND_INT_MAX_OUTPUT_SIZE bytes, and is
+// called with the next part number until it returns 0.
+typedef struct {
+    const char* name;
+    const char* help;
+    int (*function)(char* output, int size, const char* line, int part);
+} ShellCommand;
+
+// Maximum length of a command line.
+#define CMD_LINE_LENGTH 40
+
+// Command to move directly to a position: G x y z [zoom] [rotate]
+#define CMD_GOTO 'G'
+
+// Command to scan a rectangle: S xStart yStart xEnd yEnd step z dwell
+#define CMD_SCAN 'S'
+
+// Command to run a Z stack: Z zStart zEnd step dwell
+#define CMD_ZSTACK 'Z'
+
+// Command to set limits and steps of an axis (X, Y, Z, ZOOM, or ROT):
+// C axis min max [small] [medium] [large]
+// or save them to flash with: C SAVE
+#define CMD_CONFIG 'C'
+
+// Command to recall, save, delete, or list bookmarks:
+// B number|name, B SAVE number [name], B DEL number, or B LIST
+#define CMD_BOOKMARK 'B'
+
+// Command to add time-lapse positions, or run a time-lapse:
+// T ADD [x y z [zoom] [rotate]], T CLEAR, or T RUN period dwell [cycles]
+#define CMD_TIMELAPSE 'T'
+
+// Command to add, clear, or list keep-out zones:
+// K ADD xMin yMin xMax yMax zMin zMax, K CLEAR, or K LIST
+#define CMD_KEEPOUT 'K'
+
+// Command to record, stop, dump, or replay a trace of keystrokes:
+// R REC, R STOP, R DUMP, or R PLAY
+#define CMD_TRACE 'R'
+
+// Maximum number of keystrokes in a trace.
+#define TRACE_LENGTH 256
+
+// States of keystroke trace
+#define TRACE_OFF       0
+#define TRACE_RECORD    1
+#define TRACE_REPLAY    2
+
+// Struct for a keystroke in a trace.
+typedef struct {
+    TickType_t tick; // Time since recording started (ms)
+    char key;
+} TraceEntry;
+
+// Command to select, load, or show the keymap of input keys:
+// L QWERTY, L AZERTY, L SET keys, or L
+#define CMD_KEYMAP 'L'
+
+// Position of keymap report on the VT100 display.
+#define KEYMAP_REPORT_X 110
+#define KEYMAP_REPORT_Y 74
+
+// Command to pause or resume a scan.
+#define CMD_PAUSE 'P'
+
+// Command to abort a scan.
+#define CMD_ABORT 'A'
 
 #endif
 
@@ -47,10 +215,32 @@ extern EventGroupHandle_t s4743527GroupEventConsoleInput;
 // Converts an ASCII hexadecimal value to binary hexadecimal value.
 extern int s4743527_lib_console_ascii2hex(char value);
 
+// Converts hexadecimal text to bytes, finding the first invalid character.
+extern int s4743527_lib_console_hex2bytes(const char* hex, int length, uint8_t* bytes,
+        int* offset);
+
+// Converts bytes to hexadecimal text.
+extern int s4743527_lib_console_bytes2hex(const uint8_t* bytes, int length, char* hex);
+
 // Converts a digit to its ASCII equivalent character.
 extern char s4743527_lib_console_dec2ascii(int value);
 
+// Finds the next token in a line without copying it.
+extern const char* s4743527_lib_console_next_token(const char** line, int* length);
+
+// Converts a decimal token to an integer.
+extern int s4743527_lib_console_token2int(const char* token, int length, int* value);
+
 #ifdef FreeRTOS
+// Parses a byte of a terminal escape sequence.
+extern int s4743527_lib_console_escape(EscapeParser* parser, char recv, TickType_t tick);
+
+// Registers a command of the shell.
+extern int s4743527_lib_console_shell_register(const ShellCommand* command);
+
+// Compiles a keymap into the key action table and switches to it.
+extern int s4743527_lib_console_keymap_load(const char* keys);
+
 // Intialises the RCM console task and event group bits.
 extern void s4743527_tsk_console_init(void);
 #endif
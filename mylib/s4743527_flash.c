@@ -0,0 +1,218 @@
+/** 
+ **************************************************************
+ * @file mylib/s4743527_flash.c
+ * @author agent
+ * @date 18102026
+ * @brief Flash Register Driver for saving data in bank 2 sectors.
+ * REFERENCE: RM0090 Reference Manual, 3.6 Flash program/erase operations
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4743527_lib_flash_save() - Saves data to a flash sector.
+ * s4743527_lib_flash_load() - Loads data from a flash sector.
+ *************************************************************** 
+ */
+
+#include "s4743527_flash.h"
+#include <stdint.h>
+
+#ifdef FLASH_SIM
+// Simulated flash sectors for running without the board.
+static uint32_t simulatedFlash[FLASH_CONFIG_SECTOR - FLASH_KEEPOUT_SECTOR + 1][(sizeof(FlashHeader) + FLASH_MAX_DATA_SIZE) / 4];
+#define FLASH_SECTOR_POINTER(sector) \
+        ((uint8_t*) simulatedFlash[(sector) - FLASH_KEEPOUT_SECTOR])
+#else
+#include "processor_hal.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#define FLASH_SECTOR_POINTER(sector) ((uint8_t*) FLASH_SECTOR_ADDRESS(sector))
+#endif
+
+/**
+ * Calculates the Fletcher-16 checksum of data.
+ * 
+ * data: the data.
+ * size: the number of bytes of data.
+ * 
+ * Returns: the checksum of the data.
+ */
+uint16_t flash_checksum(const uint8_t* data, int size) {
+
+    uint16_t sum1 = 0;
+    uint16_t sum2 = 0;
+
+    for (int i = 0; i < size; i++) {
+        sum1 = (sum1 + data[i]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+
+    return (sum2 << 8) | sum1;
+}
+
+#ifndef FLASH_SIM
+
+/**
+ * Waits for a flash operation to finish, then checks and clears its error
+ * flags.
+ * 
+ * yield: 1 to let other tasks run while waiting, 0 to busy wait.
+ * 
+ * Returns: 0 if the operation succeeded, -1 otherwise.
+ */
+int flash_wait(int yield) {
+
+    while (FLASH->SR & FLASH_SR_BSY) {
+
+        // Bank 2 is busy but code runs from bank 1, so other tasks can run.
+        if (yield && xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+            vTaskDelay(1);
+        }
+    }
+
+    // Error flags are cleared by writing 1 to them.
+    if (FLASH->SR & FLASH_SR_ERRORS) {
+        FLASH->SR = FLASH_SR_ERRORS;
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Erases a flash sector, setting all bytes to 0xFF.
+ * 
+ * sector: the sector to erase.
+ * 
+ * Returns: 0 if the sector was erased, -1 otherwise.
+ */
+int flash_erase(int sector) {
+
+    // Clear errors left by an earlier operation, since they block erasing.
+    flash_wait(0);
+    FLASH->SR = FLASH_SR_ERRORS;
+
+    // Select sector with 32 bit parallelism, then start erase.
+    FLASH->CR &= ~(FLASH_CR_PSIZE | FLASH_CR_SNB);
+    FLASH->CR |= FLASH_CR_PSIZE_1 | FLASH_CR_SER |
+            ((FLASH_SNB_BANK2 | (sector - 12)) << FLASH_SNB_SHIFT);
+    FLASH->CR |= FLASH_CR_STRT;
+
+    // Erasing a 128 KB sector takes 1 to 2 seconds, so yield while waiting.
+    int result = flash_wait(1);
+    FLASH->CR &= ~FLASH_CR_SER;
+
+    return result;
+}
+
+/**
+ * Programs 32 bit words into erased flash.
+ * 
+ * address: the address to program from.
+ * data: the words to program.
+ * words: the number of words to program.
+ * 
+ * Returns: 0 if all words were programmed, -1 otherwise.
+ */
+int flash_program(uint32_t address, const uint32_t* data, int words) {
+
+    int result = flash_wait(0);
+
+    FLASH->CR &= ~FLASH_CR_PSIZE;
+    FLASH->CR |= FLASH_CR_PSIZE_1 | FLASH_CR_PG;
+
+    // Each word only takes microseconds, so busy wait.
+    for (int i = 0; i < words && result == 0; i++) {
+        *(volatile uint32_t*) (address + (i * 4)) = data[i];
+        result = flash_wait(0);
+    }
+
+    FLASH->CR &= ~FLASH_CR_PG;
+
+    return result;
+}
+
+#endif
+
+/**
+ * Erases a flash sector and saves data to it, after a header with the size
+ * and checksum of the data.
+ * 
+ * sector: the sector to save to (FLASH_KEEPOUT_SECTOR, FLASH_BOOKMARK_SECTOR, or
+ *         FLASH_CONFIG_SECTOR).
+ * data: the data to save.
+ * size: the number of bytes to save (up to FLASH_MAX_DATA_SIZE).
+ * 
+ * Returns: 0 if the data was saved, -1 otherwise.
+ */
+extern int s4743527_lib_flash_save(int sector, const void* data, int size) {
+
+    // Buffer for header and data as whole words.
+    static uint32_t buffer[(sizeof(FlashHeader) + FLASH_MAX_DATA_SIZE) / 4];
+    FlashHeader* header = (FlashHeader*) buffer;
+    uint8_t* bytes = (uint8_t*) buffer;
+
+    if (size > FLASH_MAX_DATA_SIZE) {
+        return -1;
+    }
+
+    header->magic = FLASH_MAGIC;
+    header->size = size;
+    header->checksum = flash_checksum(data, size);
+
+    for (int i = 0; i < size; i++) {
+        bytes[sizeof(FlashHeader) + i] = ((const uint8_t*) data)[i];
+    }
+
+    int words = (sizeof(FlashHeader) + size + 3) / 4;
+
+#ifdef FLASH_SIM
+    for (int i = 0; i < words * 4; i++) {
+        FLASH_SECTOR_POINTER(sector)[i] = bytes[i];
+    }
+#else
+    // Unlock flash control register.
+    FLASH->KEYR = FLASH_KEY1;
+    FLASH->KEYR = FLASH_KEY2;
+
+    int result = flash_erase(sector);
+    if (result == 0) {
+        result = flash_program(FLASH_SECTOR_ADDRESS(sector), buffer, words);
+    }
+
+    // Lock flash control register.
+    FLASH->CR |= FLASH_CR_LOCK;
+
+    if (result != 0) {
+        return -1;
+    }
+#endif
+
+    return 0;
+}
+
+/**
+ * Loads data saved in a flash sector, checking its size and checksum.
+ * 
+ * sector: the sector to load from (FLASH_KEEPOUT_SECTOR, FLASH_BOOKMARK_SECTOR, or
+ *         FLASH_CONFIG_SECTOR).
+ * data: set to the data loaded.
+ * size: the number of bytes expected.
+ * 
+ * Returns: 0 if valid data was loaded, -1 otherwise.
+ */
+extern int s4743527_lib_flash_load(int sector, void* data, int size) {
+
+    const FlashHeader* header = (const FlashHeader*) FLASH_SECTOR_POINTER(sector);
+    const uint8_t* saved = FLASH_SECTOR_POINTER(sector) + sizeof(FlashHeader);
+
+    if (header->magic != FLASH_MAGIC || header->size != size ||
+            header->checksum != flash_checksum(saved, size)) {
+        return -1;
+    }
+
+    for (int i = 0; i < size; i++) {
+        ((uint8_t*) data)[i] = saved[i];
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+/** 
+ **************************************************************
+ * @file mylib/s4743527_flash.h
+ * @author agent
+ * @date 18102026
+ * @brief Flash Register Driver for saving data in bank 2 sectors.
+ * REFERENCE: RM0090 Reference Manual, 3.6 Flash program/erase operations
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4743527_lib_flash_save() - Saves data to a flash sector.
+ * s4743527_lib_flash_load() - Loads data from a flash sector.
+ *************************************************************** 
+ */
+
+#ifndef S4743527_FLASH_H
+#define S4743527_FLASH_H
+
+#include <stdint.h>
+
+// Sectors used for saving data (128 KB sectors in bank 2).
+#define FLASH_KEEPOUT_SECTOR    21
+#define FLASH_BOOKMARK_SECTOR   22
+#define FLASH_CONFIG_SECTOR     23
+
+// Address of a 128 KB sector in bank 2 (sectors 17 to 23).
+#define FLASH_SECTOR_ADDRESS(sector) (0x08120000 + (((sector) - 17) * 0x20000))
+
+// Keys to unlock flash control register.
+#define FLASH_KEY1  0x45670123
+#define FLASH_KEY2  0xCDEF89AB
+
+// Shift of sector number in flash control register. Sectors in bank 2
+// are numbered from 0x10.
+#define FLASH_SNB_SHIFT 3
+#define FLASH_SNB_BANK2 0x10
+
+// Flash status register error flags for program and erase operations.
+#define FLASH_SR_ERRORS (FLASH_SR_PGSERR | FLASH_SR_PGPERR | FLASH_SR_PGAERR | \
+        FLASH_SR_WRPERR)
+
+// Value marking a sector with saved data.
+#define FLASH_MAGIC     0x52434D53
+
+// Maximum size of data that can be saved.
+#define FLASH_MAX_DATA_SIZE 1024
+
+// Struct for the header written before saved data.
+typedef struct {
+    uint32_t magic;
+    uint16_t size;
+    uint16_t checksum;
+} FlashHeader;
+
+// Function prototypes
+
+// Erases a flash sector and saves data to it.
+extern int s4743527_lib_flash_save(int sector, const void* data, int size);
+
+// Loads data saved in a flash sector.
+extern int s4743527_lib_flash_load(int sector, void* data, int size);
+
+#endif
\ No newline at end of file
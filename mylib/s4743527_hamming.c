@@ -117,7 +117,7 @@ extern unsigned char s4743527_lib_hamming_byte_decode(unsigned char value) {
             errorBit = 5; // Error in d1
         } else if (s0 && s1 && !(s2)) {
             errorBit = 6; // Error in d2
-        } else if (s0 && s1 && s2) {
+        } else {
             errorBit = 7; // Error in d3
         }
 
@@ -0,0 +1,451 @@
+/** 
+ **************************************************************
+ * @file mylib/s4743527_hostproto.c
+ * @author agent
+ * @date 18102026
+ * @brief Framed binary protocol for a host program on the debug UART.
+ * REFERENCE: RFC 1055 (SLIP)
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4743527_lib_hostproto_crc16() - Calculates CRC-16 of bytes.
+ * s4743527_lib_hostproto_decoder_init() - Initialises a frame decoder.
+ * s4743527_lib_hostproto_decode() - Decodes a byte of a frame.
+ * s4743527_lib_hostproto_encode() - Encodes a frame.
+ * s4743527_lib_hostproto_receive() - Receives a byte from the host.
+ *************************************************************** 
+ */
+
+#include "s4743527_hostproto.h"
+
+#ifdef FreeRTOS
+#include "s4743527_uartrx.h"
+#include "s4743527_rcmcont.h"
+#include "s4743527_rcmscan.h"
+#include "s4743527_rcmscript.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "s4743527_uarttx.h"
+
+// Global variable
+// Counts of frames received.
+HostStats s4743527HostStats;
+
+// Last reply sent, and the type and sequence number of its request. A
+// request sent again because its reply was lost gets the same reply
+// without being run twice.
+static uint8_t hostFrame[HOST_ENCODED_MAX];
+static int hostLastType = -1;
+static int hostLastSequence = -1;
+#endif
+
+// CRC-16/CCITT (polynomial 0x1021) of each byte value, so the CRC is
+// updated with one lookup per byte.
+static const uint16_t crcTable[256] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+        0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+        0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+        0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+        0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+        0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+        0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+        0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+        0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+        0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+        0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+        0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+        0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+        0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+        0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+        0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+        0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+        0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+        0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+        0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+        0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+        0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+        0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+        0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+        0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+        0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+        0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+        0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+        0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+        0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+        0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+/**
+ * Calculates the CRC-16/CCITT of bytes, starting from 0xFFFF.
+ * 
+ * data: the bytes.
+ * length: the number of bytes.
+ * 
+ * Returns: the CRC.
+ */
+extern uint16_t s4743527_lib_hostproto_crc16(const uint8_t* data, int length) {
+
+    uint16_t crc = 0xFFFF;
+
+    for (int i = 0; i < length; i++) {
+        crc = (crc << 8) ^ crcTable[(crc >> 8) ^ data[i]];
+    }
+
+    return crc;
+}
+
+/**
+ * Initialises a frame decoder, outside of a frame.
+ * 
+ * decoder: the frame decoder.
+ * 
+ * Returns: None
+ */
+extern void s4743527_lib_hostproto_decoder_init(HostDecoder* decoder) {
+
+    decoder->state = HOST_IDLE;
+    decoder->length = 0;
+}
+
+/**
+ * Decodes the next byte received. Outside of a frame every byte but
+ * HOST_END is left for the console. The rest of a frame that is too long
+ * or badly escaped is dropped up to the next HOST_END, so none of it is
+ * taken as keys.
+ * 
+ * decoder: the frame decoder.
+ * value: the byte received.
+ * 
+ * Returns: the payload length of a good frame, which is in the decoder
+ * payload, HOST_MORE if the frame is not complete, HOST_BAD if the frame is
+ * dropped, or HOST_PLAIN if the byte is not part of a frame.
+ */
+extern int s4743527_lib_hostproto_decode(HostDecoder* decoder, uint8_t value) {
+
+    int length;
+
+    switch (decoder->state) {
+
+        case HOST_IDLE:
+
+            if (value != HOST_END) {
+                return HOST_PLAIN;
+            }
+            decoder->state = HOST_FRAME;
+            decoder->length = 0;
+            return HOST_MORE;
+
+        case HOST_FRAME:
+
+            if (value == HOST_ESC) {
+                decoder->state = HOST_ESCAPED;
+                return HOST_MORE;
+
+            } else if (value == HOST_END) {
+
+                length = decoder->length - 2;
+
+                // An empty frame is taken as the start of the next frame, so
+                // frames can be sent back to back with one HOST_END between.
+                if (decoder->length == 0) {
+                    return HOST_MORE;
+                }
+
+                decoder->state = HOST_IDLE;
+
+                if (length < 2 || s4743527_lib_hostproto_crc16(decoder->payload, 
+                        length) != ((decoder->payload[length] << 8) | 
+                        decoder->payload[length + 1])) {
+                    return HOST_BAD;
+                }
+                return length;
+            }
+            break;
+
+        case HOST_ESCAPED:
+
+            decoder->state = HOST_FRAME;
+
+            if (value == HOST_ESC_END) {
+                value = HOST_END;
+            } else if (value == HOST_ESC_ESC) {
+                value = HOST_ESC;
+            } else if (value >= HOST_ESC_CTRL && value < HOST_ESC_CTRL + ' ') {
+                value -= HOST_ESC_CTRL;
+            } else {
+                decoder->state = HOST_DISCARD;
+                return HOST_BAD;
+            }
+            break;
+
+        case HOST_DISCARD:
+
+            // The HOST_END may start the next frame rather than end this
+            // one, so it is taken as the start of a frame.
+            if (value == HOST_END) {
+                decoder->state = HOST_FRAME;
+                decoder->length = 0;
+            }
+            return HOST_MORE;
+    }
+
+    if (decoder->length == sizeof(decoder->payload)) {
+        decoder->state = HOST_DISCARD;
+        return HOST_BAD;
+    }
+
+    decoder->payload[decoder->length++] = value;
+
+    return HOST_MORE;
+}
+
+/**
+ * Escapes a byte of a frame.
+ * 
+ * value: the byte.
+ * frame: where the escaped byte is written.
+ * 
+ * Returns: the number of bytes written.
+ */
+int hostproto_escape(uint8_t value, uint8_t* frame) {
+
+    if (value == HOST_END || value == HOST_ESC || value < ' ') {
+        frame[0] = HOST_ESC;
+        frame[1] = (value == HOST_END) ? HOST_ESC_END : 
+                (value == HOST_ESC) ? HOST_ESC_ESC : value + HOST_ESC_CTRL;
+        return 2;
+    }
+
+    frame[0] = value;
+
+    return 1;
+}
+
+/**
+ * Encodes a payload into a frame, with its CRC and a terminating NUL so it
+ * can be written as a string.
+ * 
+ * payload: the payload.
+ * length: the length of the payload, up to HOST_PAYLOAD_MAX.
+ * frame: where the frame is written, with room for HOST_ENCODED_MAX bytes.
+ * 
+ * Returns: the length of the frame, without the terminating NUL.
+ */
+extern int s4743527_lib_hostproto_encode(const uint8_t* payload, int length,
+        uint8_t* frame) {
+
+    uint16_t crc = s4743527_lib_hostproto_crc16(payload, length);
+    int count = 0;
+
+    frame[count++] = HOST_END;
+
+    for (int i = 0; i < length; i++) {
+        count += hostproto_escape(payload[i], &frame[count]);
+    }
+
+    count += hostproto_escape(crc >> 8, &frame[count]);
+    count += hostproto_escape(crc & 0xFF, &frame[count]);
+
+    frame[count++] = HOST_END;
+    frame[count] = 0;
+
+    return count;
+}
+
+#ifdef FreeRTOS
+/**
+ * Reads a little endian 16 bit value.
+ * 
+ * data: the first byte of the value.
+ * 
+ * Returns: the value.
+ */
+int hostproto_get16(const uint8_t* data) {
+    return (int16_t) (data[0] | (data[1] << 8));
+}
+
+/**
+ * Writes a little endian value.
+ * 
+ * data: where the value is written.
+ * value: the value.
+ * bytes: the number of bytes to write.
+ * 
+ * Returns: the number of bytes written.
+ */
+int hostproto_put(uint8_t* data, uint32_t value, int bytes) {
+
+    for (int i = 0; i < bytes; i++) {
+        data[i] = (value >> (8 * i)) & 0xFF;
+    }
+
+    return bytes;
+}
+
+/**
+ * Reads a position and the axes to move to it.
+ * 
+ * data: the first byte of the position.
+ * rcm: the position read.
+ * 
+ * Returns: the bits of the axes to move, which match the axis bits of RCM
+ * control.
+ */
+int hostproto_get_position(const uint8_t* data, RCMData* rcm) {
+
+    rcm->xPos = hostproto_get16(&data[1]);
+    rcm->yPos = hostproto_get16(&data[3]);
+    rcm->zPos = hostproto_get16(&data[5]);
+    rcm->zoom = hostproto_get16(&data[7]);
+    rcm->rotate = hostproto_get16(&data[9]);
+
+    return data[0] & RCM_AXES_ALL;
+}
+
+/**
+ * Writes the body of a stats reply.
+ * 
+ * data: where the body is written.
+ * 
+ * Returns: the number of bytes written.
+ */
+int hostproto_put_stats(uint8_t* data) {
+
+    int count = 0;
+
+    count += hostproto_put(&data[count], s4743527RcmState.xPos, 2);
+    count += hostproto_put(&data[count], s4743527RcmState.yPos, 2);
+    count += hostproto_put(&data[count], s4743527RcmState.zPos, 2);
+    count += hostproto_put(&data[count], s4743527RcmState.zoom, 2);
+    count += hostproto_put(&data[count], s4743527RcmState.rotate, 2);
+    count += hostproto_put(&data[count], s4743527UartRxStats.received, 4);
+    count += hostproto_put(&data[count], s4743527UartRxStats.ringOverruns, 4);
+    count += hostproto_put(&data[count], s4743527UartRxStats.uartOverruns, 4);
+    count += hostproto_put(&data[count], s4743527HostStats.frames, 4);
+    count += hostproto_put(&data[count], s4743527HostStats.errors, 4);
+    count += hostproto_put(&data[count], s4743527ScanStats.state, 1);
+    count += hostproto_put(&data[count], 
+            uxQueueSpacesAvailable(s4743527QueueScript), 1);
+
+    return count;
+}
+
+/**
+ * Runs a request from the host and sends the reply. Moves are not waited
+ * for: a goto is sent to RCM control, and a move list is queued on the
+ * script lookahead buffer as far as it fits, with the number queued in the
+ * reply so the host can send the rest later. Queued moves are never
+ * dropped, so each one replied to as queued is reached. A repeat of the
+ * last request is only replied to.
+ * 
+ * payload: the payload of the request.
+ * length: the length of the payload.
+ * 
+ * Returns: None
+ */
+void hostproto_handle(const uint8_t* payload, int length) {
+
+    uint8_t reply[3 + HOST_STATS_LENGTH];
+    int count = 3;
+    int moves;
+    RCMCommand command;
+    ScriptCommand script;
+
+    if (payload[0] == hostLastType && payload[1] == hostLastSequence) {
+        s4743527_lib_uarttx_printf("%s", hostFrame);
+        return;
+    }
+
+    hostLastType = payload[0];
+    hostLastSequence = payload[1];
+
+    reply[0] = payload[0] | HOST_REPLY;
+    reply[1] = payload[1];
+    reply[2] = HOST_OK;
+
+    switch (payload[0]) {
+
+        case HOST_GOTO:
+
+            if (length != 2 + HOST_POSITION_LENGTH) {
+                reply[2] = HOST_BAD_LENGTH;
+                break;
+            }
+
+            command.type = RCM_CMD_GOTO;
+            command.axes = hostproto_get_position(&payload[2], &command.target);
+            if (xQueueSend(s4743527QueueRcmCommand, (void*) &command, 0) != pdTRUE) {
+                reply[2] = HOST_FULL;
+            }
+            break;
+
+        case HOST_MOVES:
+
+            if (length < 3 || payload[2] > HOST_MAX_MOVES || 
+                    length != 3 + payload[2] * HOST_POSITION_LENGTH) {
+                reply[2] = HOST_BAD_LENGTH;
+                break;
+            }
+
+            script.type = SCRIPT_MOVE;
+            for (moves = 0; moves < payload[2]; moves++) {
+                script.axes = hostproto_get_position(
+                        &payload[3 + moves * HOST_POSITION_LENGTH], &script.target);
+                if (xQueueSend(s4743527QueueScript, (void*) &script, 0) != pdTRUE) {
+                    reply[2] = HOST_FULL;
+                    break;
+                }
+            }
+            count += hostproto_put(&reply[count], moves, 1);
+            break;
+
+        case HOST_STATS:
+
+            if (length != 2) {
+                reply[2] = HOST_BAD_LENGTH;
+                break;
+            }
+
+            count += hostproto_put_stats(&reply[count]);
+            break;
+
+        default:
+            reply[2] = HOST_UNKNOWN;
+            break;
+    }
+
+    // The frame has no NUL, so it is written in one call.
+    s4743527_lib_hostproto_encode(reply, count, hostFrame);
+    s4743527_lib_uarttx_printf("%s", hostFrame);
+}
+
+/**
+ * Receives a byte, running each request from the host when its frame ends.
+ * Frames that are dropped are counted as errors and get no reply, so the
+ * host sends them again.
+ * 
+ * decoder: the frame decoder.
+ * value: the byte received.
+ * 
+ * Returns: 1 if the byte is part of a frame, or 0 if it is for the console.
+ */
+extern int s4743527_lib_hostproto_receive(HostDecoder* decoder, uint8_t value) {
+
+    int length = s4743527_lib_hostproto_decode(decoder, value);
+
+    if (length == HOST_PLAIN) {
+        return 0;
+
+    } else if (length == HOST_BAD) {
+        s4743527HostStats.errors++;
+
+    } else if (length >= 0) {
+        s4743527HostStats.frames++;
+        hostproto_handle(decoder->payload, length);
+    }
+
+    return 1;
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,124 @@
+/** 
+ **************************************************************
+ * @file mylib/s4743527_hostproto.h
+ * @author agent
+ * @date 18102026
+ * @brief Framed binary protocol for a host program on the debug UART.
+ * REFERENCE: RFC 1055 (SLIP)
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4743527_lib_hostproto_crc16() - Calculates CRC-16 of bytes.
+ * s4743527_lib_hostproto_decoder_init() - Initialises a frame decoder.
+ * s4743527_lib_hostproto_decode() - Decodes a byte of a frame.
+ * s4743527_lib_hostproto_encode() - Encodes a frame.
+ * s4743527_lib_hostproto_receive() - Receives a byte from the host.
+ *************************************************************** 
+ */
+
+#ifndef S4743527_HOSTPROTO_H
+#define S4743527_HOSTPROTO_H
+
+#include <stdint.h>
+
+// SLIP bytes. Each frame starts and ends with HOST_END.
+#define HOST_END        0xC0
+#define HOST_ESC        0xDB
+#define HOST_ESC_END    0xDC
+#define HOST_ESC_ESC    0xDD
+
+// Control bytes are also escaped, as HOST_ESC then the byte plus
+// HOST_ESC_CTRL. Frames then have no NUL, which the console reads as no
+// input, and no XON/XOFF or newline for a terminal driver to act on.
+#define HOST_ESC_CTRL   0x40
+
+// Longest payload of a frame, without its CRC.
+#define HOST_PAYLOAD_MAX 180
+
+// Longest encoded frame, with CRC, escapes, both HOST_END bytes and a
+// terminating NUL.
+#define HOST_ENCODED_MAX ((HOST_PAYLOAD_MAX + 2) * 2 + 3)
+
+// Results of frame decoder, besides the payload length of a good frame.
+#define HOST_PLAIN      -1 // Byte is not part of a frame
+#define HOST_MORE       -2 // Frame is not complete
+#define HOST_BAD        -3 // Frame is too long, badly escaped, or fails CRC
+
+// Types of requests. Replies have the same type with HOST_REPLY set.
+// Each payload is type, sequence number, then the body. Values are
+// little endian.
+#define HOST_GOTO       0x01 // axes (uint8), then x y z zoom rotate (int16)
+#define HOST_MOVES      0x02 // count (uint8), then count positions as GOTO
+#define HOST_STATS      0x03 // No body
+#define HOST_REPLY      0x80
+
+// Status of replies, which follows the sequence number. Moves replied to
+// with HOST_OK are queued, and each is reached in order: keys pressed
+// meanwhile wait until they are done.
+#define HOST_OK         0
+#define HOST_BAD_LENGTH 1
+#define HOST_UNKNOWN    2
+#define HOST_FULL       3 // Not all moves could be queued
+
+// Bit set in the axes of a position for each axis moved, in the order
+// x, y, z, zoom, rotate. Axes not set keep their value.
+#define HOST_AXIS_X         0x01
+#define HOST_AXIS_Y         0x02
+#define HOST_AXIS_Z         0x04
+#define HOST_AXIS_ZOOM      0x08
+#define HOST_AXIS_ROTATE    0x10
+#define HOST_AXES_ALL       0x1F
+
+// Lengths of a position, and of the body of a stats reply: position,
+// UART received, ring and UART overruns, frames and frame errors (uint32),
+// scan state and free script lookahead (uint8).
+#define HOST_POSITION_LENGTH 11
+#define HOST_STATS_LENGTH 32
+
+// Most positions in a HOST_MOVES request.
+#define HOST_MAX_MOVES  16
+
+// States of frame decoder
+#define HOST_IDLE       0
+#define HOST_FRAME      1
+#define HOST_ESCAPED    2
+#define HOST_DISCARD    3 // Dropping the rest of a bad frame
+
+// Struct for a frame decoder that takes one byte at a time.
+typedef struct {
+    int state;
+    int length;
+    uint8_t payload[HOST_PAYLOAD_MAX + 2]; // Payload then CRC
+} HostDecoder;
+
+// Struct for counts of frames received.
+typedef struct {
+    uint32_t frames;
+    uint32_t errors;
+} HostStats;
+
+// Function prototypes
+
+// Calculates the CRC-16/CCITT of bytes.
+extern uint16_t s4743527_lib_hostproto_crc16(const uint8_t* data, int length);
+
+// Initialises a frame decoder.
+extern void s4743527_lib_hostproto_decoder_init(HostDecoder* decoder);
+
+// Decodes the next byte received.
+extern int s4743527_lib_hostproto_decode(HostDecoder* decoder, uint8_t value);
+
+// Encodes a payload into a frame.
+extern int s4743527_lib_hostproto_encode(const uint8_t* payload, int length,
+        uint8_t* frame);
+
+#ifdef FreeRTOS
+// Global variable
+// Counts of frames received.
+extern HostStats s4743527HostStats;
+
+// Receives a byte, running each request from the host when its frame ends.
+extern int s4743527_lib_hostproto_receive(HostDecoder* decoder, uint8_t value);
+#endif
+
+#endif
\ No newline at end of file
@@ -27,7 +27,7 @@
 #include "board.h"
 #include "debug_log.h"
 
-// Handle for RCM positions for SSD
+// Handle for newest RCM position for SSD, of length 1
 QueueHandle_t s4743527QueueSSD;
 #endif
 
@@ -132,9 +132,6 @@ extern void s4743527_reg_mfs_ssd_clear(void) {
 */
 void mfs_ssd_task(void) {
 
-    // Initialise queue
-    s4743527QueueSSD = xQueueCreate(10, sizeof(SSDData));
-
     // Struct for holding RCM position data.
     SSDData position;
 
@@ -148,9 +145,6 @@ void mfs_ssd_task(void) {
     // Variable that controls which data to display. 
     int changed = INITIAL;
 
-    // Index of digit to display on SSD.
-    int currentPosition = 0;
-
     for (;;) {
 
         // Receive position data from RCM Control task.
@@ -224,6 +218,10 @@ void mfs_ssd_task(void) {
  */
 extern void s4743527_tsk_mfs_ssd_init(void) {
 
+    // Initialise queue before task so it can be used straight away. It
+    // holds only the newest position, which the sender overwrites.
+    s4743527QueueSSD = xQueueCreate(1, sizeof(SSDData));
+
     // Create task for MFS SSD
     xTaskCreate((void*) &mfs_ssd_task, (const signed char *) "MFS SSD",
             TASK_MFS_SSD_STACK_SIZE, NULL, TASK_MFS_SSD_PRIORITY, NULL);
@@ -25,6 +25,9 @@
 // Handle for radio packet queue
 QueueHandle_t s4743527QueueRadioPacket;
 
+// Counts of radio packets
+RadioStats s4743527RadioStats;
+
 /**
  * Task for RCM radio which sends hamming encoded packets.
  * 
@@ -65,6 +68,8 @@ void radio_fsm_task(void) {
                 taskENTER_CRITICAL();
                 nrf24l01plus_send(encodedPacket);
                 taskEXIT_CRITICAL();
+
+                s4743527RadioStats.sent++;
                 
                 S4743527_REG_MFS_LED_D1_TOGGLE();
                 
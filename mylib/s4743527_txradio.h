@@ -16,6 +16,7 @@
 #ifndef S4743527_TXRADIO_H
 #define S4743527_TXRADIO_H
 
+#include <stdint.h>
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
@@ -30,9 +31,17 @@
 #define STANDBY     0
 #define TRANSMIT    1
 
+// Struct for counts of radio packets.
+typedef struct {
+    uint32_t sent;
+} RadioStats;
+
 // Handle for radio packet queue
 extern QueueHandle_t s4743527QueueRadioPacket;
 
+// Counts of radio packets
+extern RadioStats s4743527RadioStats;
+
 // Function prototypes
 
 // Initialises the radio register pins.
@@ -0,0 +1,180 @@
+/** 
+ **************************************************************
+ * @file mylib/s4743527_uartrx.c
+ * @author agent
+ * @date 18102026
+ * @brief Interrupt driven receive for the debug UART.
+ * REFERENCE: RM0090 (STM32F429 reference manual), USART section.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4743527_lib_uartrx_ring_put() - Adds a byte to a ring buffer.
+ * s4743527_lib_uartrx_ring_get() - Removes a byte from a ring buffer.
+ * s4743527_reg_uartrx_init() - Enables the debug UART receive interrupt.
+ * s4743527_lib_uartrx_getc() - Receives a byte without waiting.
+ *************************************************************** 
+ */
+
+#include "s4743527_uartrx.h"
+
+#ifdef FreeRTOS
+#include "FreeRTOS.h"
+#include "task.h"
+#include "processor_hal.h"
+
+// Global variables
+// Counts of received and lost bytes.
+UartRxStats s4743527UartRxStats;
+
+// Bytes received by the interrupt and not yet read.
+static UartRxRing uartRxRing;
+
+// Task notified when bytes are received.
+static TaskHandle_t uartRxTask = NULL;
+#endif
+
+/**
+ * Adds a byte to a ring buffer. The byte is stored before head is
+ * published, so the consumer never reads a slot before it is written.
+ * 
+ * ring: the ring buffer, written only by this producer.
+ * value: the byte to add.
+ * tick: the time the byte arrived.
+ * 
+ * Returns: 0 if added, -1 if the ring buffer is full.
+ */
+extern int s4743527_lib_uartrx_ring_put(UartRxRing* ring, uint8_t value, uint32_t tick) {
+
+    uint16_t head = ring->head;
+    uint16_t next = (head + 1) & UARTRX_RING_MASK;
+
+    if (next == __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE)) {
+        return -1;
+    }
+
+    ring->data[head] = value;
+    ring->ticks[head] = tick;
+    __atomic_store_n(&ring->head, next, __ATOMIC_RELEASE);
+
+    return 0;
+}
+
+/**
+ * Removes a byte from a ring buffer. The byte is read before tail is
+ * published, so the producer never overwrites a slot before it is read.
+ * 
+ * ring: the ring buffer, read only by this consumer.
+ * value: set to the byte removed.
+ * tick: set to the time the byte arrived.
+ * 
+ * Returns: 0 if removed, -1 if the ring buffer is empty.
+ */
+extern int s4743527_lib_uartrx_ring_get(UartRxRing* ring, uint8_t* value, uint32_t* tick) {
+
+    uint16_t tail = ring->tail;
+
+    if (tail == __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) {
+        return -1;
+    }
+
+    *value = ring->data[tail];
+    *tick = ring->ticks[tail];
+    __atomic_store_n(&ring->tail, (tail + 1) & UARTRX_RING_MASK, __ATOMIC_RELEASE);
+
+    return 0;
+}
+
+#ifdef FreeRTOS
+/**
+ * Adds a received byte to the ring buffer with the time it arrived,
+ * counting it as lost if the buffer is full.
+ * 
+ * value: the byte received.
+ * 
+ * Returns: None
+ */
+void uartrx_receive(uint8_t value) {
+
+    s4743527UartRxStats.received++;
+
+    if (s4743527_lib_uartrx_ring_put(&uartRxRing, value, xTaskGetTickCountFromISR()) != 0) {
+        s4743527UartRxStats.ringOverruns++;
+    }
+}
+
+/**
+ * Enables the debug UART receive interrupt. BRD_debuguart_init() must have
+ * set up the UART first.
+ * 
+ * task: the task to notify when bytes are received.
+ * 
+ * Returns: None
+ */
+extern void s4743527_reg_uartrx_init(TaskHandle_t task) {
+
+    uartRxTask = task;
+
+    // Interrupt on each received byte, and on overrun which shares RXNEIE.
+    USART3->CR1 |= USART_CR1_RXNEIE;
+
+    // Set priority to 10 and enable interrupt callback.
+    HAL_NVIC_SetPriority(USART3_IRQn, UARTRX_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(USART3_IRQn);
+}
+
+/**
+ * Receives a byte from the ring buffer without waiting. The time it
+ * arrived is kept, as the byte may be read long after, e.g. while the
+ * reader was busy.
+ * 
+ * tick: set to the time the byte arrived.
+ * 
+ * Returns: the byte received, or 0 if there is none.
+ */
+extern char s4743527_lib_uartrx_getc(TickType_t* tick) {
+
+    uint8_t value;
+    uint32_t arrival;
+
+    if (s4743527_lib_uartrx_ring_get(&uartRxRing, &value, &arrival) != 0) {
+        return 0;
+    }
+
+    *tick = arrival;
+
+    return value;
+}
+
+/**
+ * Interrupt service routine for the debug UART. Reading SR then DR clears
+ * both the received and overrun flags. The board support polls USART3 and
+ * defines no handler, so this replaces the weak default of the startup
+ * file. A second strong definition would fail to link rather than
+ * silently take its place.
+ * 
+ * Returns: None
+ */
+void USART3_IRQHandler(void) {
+
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    uint32_t status = USART3->SR;
+
+    if (status & (USART_SR_RXNE | USART_SR_ORE)) {
+
+        // A byte arrived before the last one was read.
+        if (status & USART_SR_ORE) {
+            s4743527UartRxStats.uartOverruns++;
+        }
+
+        uartrx_receive(USART3->DR);
+
+        // Wake the task reading the bytes.
+        if (uartRxTask != NULL) {
+            vTaskNotifyGiveFromISR(uartRxTask, &xHigherPriorityTaskWoken);
+        }
+    }
+
+    // Perform context switching, if required.
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,71 @@
+/** 
+ **************************************************************
+ * @file mylib/s4743527_uartrx.h
+ * @author agent
+ * @date 18102026
+ * @brief Interrupt driven receive for the debug UART.
+ * REFERENCE: RM0090 (STM32F429 reference manual), USART section.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4743527_lib_uartrx_ring_put() - Adds a byte to a ring buffer.
+ * s4743527_lib_uartrx_ring_get() - Removes a byte from a ring buffer.
+ * s4743527_reg_uartrx_init() - Enables the debug UART receive interrupt.
+ * s4743527_lib_uartrx_getc() - Receives a byte without waiting.
+ *************************************************************** 
+ */
+
+#ifndef S4743527_UARTRX_H
+#define S4743527_UARTRX_H
+
+#include <stdint.h>
+
+// Number of bytes in the receive ring buffer, which must be a power of 2.
+// One slot is kept empty to tell a full buffer from an empty one.
+#define UARTRX_RING_SIZE    256
+#define UARTRX_RING_MASK    (UARTRX_RING_SIZE - 1)
+
+// Priority of the receive interrupt, below the FreeRTOS syscall limit.
+#define UARTRX_IRQ_PRIORITY 10
+
+// Struct for a single producer, single consumer ring buffer. Only the
+// producer writes head and only the consumer writes tail, so no lock is
+// needed.
+typedef struct {
+    volatile uint16_t head; // Next slot to write
+    volatile uint16_t tail; // Next slot to read
+    uint8_t data[UARTRX_RING_SIZE];
+    uint32_t ticks[UARTRX_RING_SIZE]; // Time each byte arrived
+} UartRxRing;
+
+// Struct for counts of received and lost bytes.
+typedef struct {
+    uint32_t received;
+    uint32_t ringOverruns; // Bytes lost because the ring buffer was full
+    uint32_t uartOverruns; // Bytes lost before the interrupt read them
+} UartRxStats;
+
+// Function prototypes
+
+// Adds a byte to a ring buffer, from the producer only.
+extern int s4743527_lib_uartrx_ring_put(UartRxRing* ring, uint8_t value, uint32_t tick);
+
+// Removes a byte from a ring buffer, from the consumer only.
+extern int s4743527_lib_uartrx_ring_get(UartRxRing* ring, uint8_t* value, uint32_t* tick);
+
+#ifdef FreeRTOS
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Global variable
+// Counts of received and lost bytes.
+extern UartRxStats s4743527UartRxStats;
+
+// Enables the receive interrupt, which notifies a task of new bytes.
+extern void s4743527_reg_uartrx_init(TaskHandle_t task);
+
+// Receives a byte without waiting, with the time it arrived.
+extern char s4743527_lib_uartrx_getc(TickType_t* tick);
+#endif
+
+#endif
\ No newline at end of file
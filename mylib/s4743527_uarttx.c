@@ -0,0 +1,324 @@
+/** 
+ **************************************************************
+ * @file mylib/s4743527_uarttx.c
+ * @author agent
+ * @date 18102026
+ * @brief DMA driven, double buffered transmit for the debug UART.
+ * REFERENCE: RM0090 (STM32F429 reference manual), DMA and USART sections.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4743527_reg_uarttx_init() - Enables DMA transmit on the debug UART.
+ * s4743527_lib_uarttx_write() - Queues bytes to send without waiting.
+ * s4743527_lib_uarttx_write_wait() - Queues bytes, waiting for room.
+ * s4743527_lib_uarttx_printf() - Queues formatted text without waiting.
+ * s4743527_lib_uarttx_free() - Gets the room left to queue bytes.
+ * s4743527_lib_uarttx_flush() - Waits until all bytes queued are sent.
+ *************************************************************** 
+ */
+
+#include "s4743527_uarttx.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "board.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#ifdef UARTTX_SIM
+#include "debug_log.h"
+#else
+#include "processor_hal.h"
+#endif
+
+// Global variables
+// Counts of sent and dropped bytes.
+UartTxStats s4743527UartTxStats;
+
+// Buffers, one being filled by tasks while DMA sends the other.
+static char uartTxBuffers[2][UARTTX_BUFFER_SIZE];
+static volatile int uartTxLengths[2];
+static volatile int uartTxFill = 0; // Buffer being filled
+static volatile int uartTxBusy = 0; // DMA is sending the other buffer
+
+// Given when every byte queued has been sent.
+static SemaphoreHandle_t uartTxDone = NULL;
+
+// Text of printf, formatted before it is queued.
+static char uartTxFormat[UARTTX_FORMAT_SIZE];
+static SemaphoreHandle_t uartTxFormatMutex = NULL;
+
+/**
+ * Starts sending the buffer being filled, if DMA is idle and it has bytes,
+ * and swaps to filling the other buffer. Called with interrupts masked.
+ * The simulation sends the buffer at the line rate in place of DMA.
+ * 
+ * Returns: None
+ */
+void uarttx_start(void) {
+
+    int send = uartTxFill;
+    int length = uartTxLengths[send];
+
+    if (uartTxBusy || length == 0) {
+        return;
+    }
+
+    uartTxBusy = 1;
+    uartTxFill = !send;
+    s4743527UartTxStats.sent += length;
+    s4743527UartTxStats.transfers++;
+
+#ifdef UARTTX_SIM
+    sim_uart_send(uartTxBuffers[send], length);
+#else
+    // Clear flags of the last transfer, then send the buffer to DR.
+    DMA1->LIFCR = DMA_LIFCR_CTCIF3 | DMA_LIFCR_CHTIF3 | DMA_LIFCR_CTEIF3 | 
+            DMA_LIFCR_CDMEIF3 | DMA_LIFCR_CFEIF3;
+    DMA1_Stream3->M0AR = (uint32_t) uartTxBuffers[send];
+    DMA1_Stream3->NDTR = length;
+    DMA1_Stream3->CR |= DMA_SxCR_EN;
+#endif
+}
+
+/**
+ * Enables DMA transmit on the debug UART, with DMA1 stream 3 channel 4
+ * moving bytes to USART3. BRD_debuguart_init() must have set up the UART
+ * first.
+ * 
+ * Returns: None
+ */
+extern void s4743527_reg_uarttx_init(void) {
+
+    uartTxDone = xSemaphoreCreateBinary();
+    uartTxFormatMutex = xSemaphoreCreateMutex();
+
+#ifndef UARTTX_SIM
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    // Stream must be disabled before it is set up.
+    DMA1_Stream3->CR = 0;
+    while (DMA1_Stream3->CR & DMA_SxCR_EN);
+
+    // Memory to peripheral, byte at a time, interrupt when done or failed.
+    DMA1_Stream3->PAR = (uint32_t) &USART3->DR;
+    DMA1_Stream3->CR = DMA_SxCR_CHSEL_2 | DMA_SxCR_MINC | DMA_SxCR_DIR_0 | 
+            DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+
+    // UART requests a byte from DMA each time DR is empty.
+    USART3->CR3 |= USART_CR3_DMAT;
+
+    // Set priority to 10 and enable interrupt callback.
+    HAL_NVIC_SetPriority(DMA1_Stream3_IRQn, UARTTX_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Stream3_IRQn);
+#endif
+}
+
+/**
+ * Copies bytes into the buffer being filled if they all fit, and starts
+ * sending it. Called with interrupts masked.
+ * 
+ * data: the bytes to send.
+ * length: the number of bytes.
+ * 
+ * Returns: 0 if queued, or -1 if there is no room.
+ */
+int uarttx_queue(const char* data, int length) {
+
+    int fill = uartTxFill;
+
+    if (uartTxLengths[fill] + length > UARTTX_BUFFER_SIZE) {
+        return -1;
+    }
+
+    memcpy(&uartTxBuffers[fill][uartTxLengths[fill]], data, length);
+    uartTxLengths[fill] += length;
+    uarttx_start();
+
+    return 0;
+}
+
+/**
+ * Queues bytes to send without waiting. Bytes are only dropped as a whole
+ * write, so escape sequences are never cut.
+ * 
+ * data: the bytes to send.
+ * length: the number of bytes.
+ * 
+ * Returns: 0 if queued, or -1 if dropped.
+ */
+extern int s4743527_lib_uarttx_write(const char* data, int length) {
+
+    int result;
+
+    if (length <= 0) {
+        return 0;
+    }
+
+    taskENTER_CRITICAL();
+
+    result = uarttx_queue(data, length);
+    if (result != 0) {
+        s4743527UartTxStats.dropped += length;
+        s4743527UartTxStats.dropWrites++;
+    }
+
+    taskEXIT_CRITICAL();
+
+    return result;
+}
+
+/**
+ * Queues bytes to send, waiting for the buffers to be sent until there is
+ * room rather than dropping them. Used for bytes the other end must get,
+ * such as flow control.
+ * 
+ * data: the bytes to send.
+ * length: the number of bytes (up to UARTTX_BUFFER_SIZE).
+ * 
+ * Returns: 0 if queued, or -1 if the bytes can never fit.
+ */
+extern int s4743527_lib_uarttx_write_wait(const char* data, int length) {
+
+    int result;
+
+    if (length > UARTTX_BUFFER_SIZE) {
+        return -1;
+    }
+
+    for (;;) {
+
+        taskENTER_CRITICAL();
+        result = (length <= 0) ? 0 : uarttx_queue(data, length);
+        taskEXIT_CRITICAL();
+
+        if (result == 0) {
+            return 0;
+        }
+
+        s4743527_lib_uarttx_flush(portMAX_DELAY);
+    }
+}
+
+/**
+ * Queues formatted text to send without waiting. Text longer than
+ * UARTTX_FORMAT_SIZE is cut.
+ * 
+ * format: the printf format.
+ * 
+ * Returns: 0 if queued, or -1 if dropped.
+ */
+extern int s4743527_lib_uarttx_printf(const char* format, ...) {
+
+    va_list args;
+    int length;
+    int result;
+
+    xSemaphoreTake(uartTxFormatMutex, portMAX_DELAY);
+
+    va_start(args, format);
+    length = vsnprintf(uartTxFormat, UARTTX_FORMAT_SIZE, format, args);
+    va_end(args);
+
+    if (length >= UARTTX_FORMAT_SIZE) {
+        length = UARTTX_FORMAT_SIZE - 1;
+    }
+
+    result = s4743527_lib_uarttx_write(uartTxFormat, length);
+
+    xSemaphoreGive(uartTxFormatMutex);
+
+    return result;
+}
+
+/**
+ * Gets the number of bytes that can be queued without dropping them.
+ * 
+ * Returns: the number of bytes.
+ */
+extern int s4743527_lib_uarttx_free(void) {
+
+    return UARTTX_BUFFER_SIZE - uartTxLengths[uartTxFill];
+}
+
+/**
+ * Waits until every byte queued has been sent. Each task that wakes gives
+ * the semaphore back, so every task waiting wakes.
+ * 
+ * wait: the most ticks to wait each time DMA finishes.
+ * 
+ * Returns: 0 if all bytes were sent, or -1 if the wait timed out.
+ */
+extern int s4743527_lib_uarttx_flush(TickType_t wait) {
+
+    int idle;
+
+    for (;;) {
+
+        taskENTER_CRITICAL();
+        idle = !uartTxBusy && uartTxLengths[uartTxFill] == 0;
+        taskEXIT_CRITICAL();
+
+        if (idle) {
+            xSemaphoreGive(uartTxDone);
+            return 0;
+        }
+
+        if (xSemaphoreTake(uartTxDone, wait) != pdTRUE) {
+            return -1;
+        }
+    }
+}
+
+/**
+ * Empties the buffer DMA has sent, and sends the other if it has bytes.
+ * Called from the DMA interrupt.
+ * 
+ * xHigherPriorityTaskWoken: set if a task waiting for all bytes to be
+ *     sent was woken.
+ * 
+ * Returns: None
+ */
+void uarttx_done(BaseType_t* xHigherPriorityTaskWoken) {
+
+    UBaseType_t status = taskENTER_CRITICAL_FROM_ISR();
+
+    uartTxLengths[!uartTxFill] = 0;
+    uartTxBusy = 0;
+    uarttx_start();
+
+    // Wake tasks waiting for all bytes to be sent.
+    if (!uartTxBusy) {
+        xSemaphoreGiveFromISR(uartTxDone, xHigherPriorityTaskWoken);
+    }
+
+    taskEXIT_CRITICAL_FROM_ISR(status);
+}
+
+/**
+ * Interrupt service routine for the end of a DMA transfer. The simulation
+ * only raises it once a transfer has been sent.
+ * 
+ * Returns: None
+ */
+void DMA1_Stream3_IRQHandler(void) {
+
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+#ifdef UARTTX_SIM
+    uarttx_done(&xHigherPriorityTaskWoken);
+#else
+    if (DMA1->LISR & (DMA_LISR_TCIF3 | DMA_LISR_TEIF3)) {
+
+        // Bytes not sent by a failed transfer count as dropped.
+        s4743527UartTxStats.dropped += DMA1_Stream3->NDTR;
+        DMA1->LIFCR = DMA_LIFCR_CTCIF3 | DMA_LIFCR_CTEIF3;
+
+        uarttx_done(&xHigherPriorityTaskWoken);
+    }
+#endif
+
+    // Perform context switching, if required.
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
\ No newline at end of file
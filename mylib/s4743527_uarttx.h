@@ -0,0 +1,72 @@
+/** 
+ **************************************************************
+ * @file mylib/s4743527_uarttx.h
+ * @author agent
+ * @date 18102026
+ * @brief DMA driven, double buffered transmit for the debug UART.
+ * REFERENCE: RM0090 (STM32F429 reference manual), DMA and USART sections.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4743527_reg_uarttx_init() - Enables DMA transmit on the debug UART.
+ * s4743527_lib_uarttx_write() - Queues bytes to send without waiting.
+ * s4743527_lib_uarttx_write_wait() - Queues bytes, waiting for room.
+ * s4743527_lib_uarttx_printf() - Queues formatted text without waiting.
+ * s4743527_lib_uarttx_free() - Gets the room left to queue bytes.
+ * s4743527_lib_uarttx_flush() - Waits until all bytes queued are sent.
+ *************************************************************** 
+ */
+
+#ifndef S4743527_UARTTX_H
+#define S4743527_UARTTX_H
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Number of bytes in each of the two transmit buffers. One is filled
+// while DMA sends the other.
+#define UARTTX_BUFFER_SIZE  1024
+
+// Longest text written by one printf.
+#define UARTTX_FORMAT_SIZE  384
+
+// Room a line of a long listing waits for, rather than be dropped.
+#define UARTTX_LINE_SIZE    80
+
+// Priority of the DMA interrupt, below the FreeRTOS syscall limit.
+#define UARTTX_IRQ_PRIORITY 10
+
+// Struct for counts of sent and dropped bytes.
+typedef struct {
+    uint32_t sent;
+    uint32_t transfers;
+    uint32_t dropped;     // Bytes dropped because both buffers were full
+    uint32_t dropWrites;  // Writes those bytes were in
+} UartTxStats;
+
+// Function prototypes
+
+// Global variable
+// Counts of sent and dropped bytes.
+extern UartTxStats s4743527UartTxStats;
+
+// Enables DMA transmit. BRD_debuguart_init() must be called first.
+extern void s4743527_reg_uarttx_init(void);
+
+// Queues bytes to send, dropping them all if there is no room.
+extern int s4743527_lib_uarttx_write(const char* data, int length);
+
+// Queues bytes to send, waiting for room rather than dropping them.
+extern int s4743527_lib_uarttx_write_wait(const char* data, int length);
+
+// Queues formatted text to send, dropping it if there is no room.
+extern int s4743527_lib_uarttx_printf(const char* format, ...);
+
+// Gets the number of bytes that can be queued without dropping.
+extern int s4743527_lib_uarttx_free(void);
+
+// Waits until every byte queued has been sent.
+extern int s4743527_lib_uarttx_flush(TickType_t wait);
+
+#endif
\ No newline at end of file
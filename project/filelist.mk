@@ -14,4 +14,9 @@ LIBSRCS += $(MYLIB_PATH)/s4743527_lta1000g.c $(MYLIB_PATH)/s4743527_console.c \
 		$(MYLIB_PATH)/s4743527_rgb.c s4743527_rcmcont.c \
 		$(MYLIB_PATH)/s4743527_txradio.c $(MYLIB_PATH)/s4743527_board_pb.c \
 		s4743527_rcmdisplay.c $(MYLIB_PATH)/s4743527_mfs_ssd.c \
+		s4743527_rcmscan.c s4743527_rcmtraj.c s4743527_rcmbookmark.c s4743527_rcmkeepout.c \
+		s4743527_rcmscript.c \
+		$(MYLIB_PATH)/s4743527_bkpsram.c $(MYLIB_PATH)/s4743527_flash.c \
+		$(MYLIB_PATH)/s4743527_uartrx.c $(MYLIB_PATH)/s4743527_hostproto.c \
+		$(MYLIB_PATH)/s4743527_uarttx.c \
 		$(FREERTOS_PATH)/portable/MemMang/heap_2.c
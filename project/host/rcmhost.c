@@ -0,0 +1,282 @@
+/** 
+ **************************************************************
+ * @file project/host/rcmhost.c
+ * @author agent
+ * @date 18102026
+ * @brief Host client library for the framed binary protocol of the RCM
+ * controller.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * rcmhost_open() - Opens the debug UART of the board.
+ * rcmhost_close() - Closes the debug UART.
+ * rcmhost_goto() - Moves the RCM to a position.
+ * rcmhost_moves() - Queues a list of moves.
+ * rcmhost_stats() - Reads the position and counters of the board.
+ *************************************************************** 
+ */
+
+#include "rcmhost.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * Opens the debug UART of the board. A serial port is set to 115200 baud;
+ * both a serial port and a pty are set to pass bytes through unchanged.
+ * 
+ * host: the connection.
+ * path: the serial port or pty.
+ * 
+ * Returns: 0 if opened, or -1 otherwise.
+ */
+extern int rcmhost_open(RcmHost* host, const char* path) {
+
+    struct termios terminal;
+
+    if ((host->fd = open(path, O_RDWR | O_NOCTTY)) < 0) {
+        return -1;
+    }
+
+    if (tcgetattr(host->fd, &terminal) == 0) {
+        cfmakeraw(&terminal);
+        cfsetispeed(&terminal, B115200);
+        cfsetospeed(&terminal, B115200);
+        tcsetattr(host->fd, TCSANOW, &terminal);
+    }
+
+    // The board replies to a repeat of its last request without running
+    // it, so a new connection starts from a different sequence number.
+    host->sequence = getpid() + time(NULL);
+    s4743527_lib_hostproto_decoder_init(&host->decoder);
+
+    return 0;
+}
+
+/**
+ * Closes the debug UART.
+ * 
+ * host: the connection.
+ * 
+ * Returns: None
+ */
+extern void rcmhost_close(RcmHost* host) {
+
+    close(host->fd);
+    host->fd = -1;
+}
+
+/**
+ * Writes a little endian 16 bit value.
+ * 
+ * data: where the value is written.
+ * value: the value.
+ * 
+ * Returns: the number of bytes written.
+ */
+int rcmhost_put16(uint8_t* data, int value) {
+
+    data[0] = value & 0xFF;
+    data[1] = (value >> 8) & 0xFF;
+
+    return 2;
+}
+
+/**
+ * Reads a little endian value.
+ * 
+ * data: the first byte of the value.
+ * bytes: the number of bytes to read.
+ * 
+ * Returns: the value.
+ */
+uint32_t rcmhost_get(const uint8_t* data, int bytes) {
+
+    uint32_t value = 0;
+
+    for (int i = bytes - 1; i >= 0; i--) {
+        value = (value << 8) | data[i];
+    }
+
+    return value;
+}
+
+/**
+ * Writes a position as in a HOST_GOTO request.
+ * 
+ * data: where the position is written.
+ * position: the position.
+ * 
+ * Returns: the number of bytes written.
+ */
+int rcmhost_put_position(uint8_t* data, const RcmHostPosition* position) {
+
+    int count = 0;
+
+    data[count++] = position->axes;
+    count += rcmhost_put16(&data[count], position->xPos);
+    count += rcmhost_put16(&data[count], position->yPos);
+    count += rcmhost_put16(&data[count], position->zPos);
+    count += rcmhost_put16(&data[count], position->zoom);
+    count += rcmhost_put16(&data[count], position->rotate);
+
+    return count;
+}
+
+/**
+ * Waits for the reply to a request. Bytes outside of frames, such as the
+ * VT100 display of the board, and replies to earlier requests are skipped.
+ * 
+ * host: the connection.
+ * type: the type of the request.
+ * sequence: the sequence number of the request.
+ * 
+ * Returns: the length of the reply, which is in the decoder payload, or -1
+ * if there is no reply in time.
+ */
+int rcmhost_wait_reply(RcmHost* host, uint8_t type, uint8_t sequence) {
+
+    struct pollfd poller = {host->fd, POLLIN, 0};
+    uint8_t value;
+    int length;
+
+    // Bytes are read one at a time, so bytes after the reply are left for
+    // the next request.
+    while (poll(&poller, 1, RCMHOST_TIMEOUT) > 0) {
+
+        if (read(host->fd, &value, 1) != 1) {
+            return -1;
+        }
+
+        length = s4743527_lib_hostproto_decode(&host->decoder, value);
+        if (length >= 3 && host->decoder.payload[0] == (type | HOST_REPLY) &&
+                host->decoder.payload[1] == sequence) {
+            return length;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Sends a request and waits for its reply.
+ * 
+ * host: the connection.
+ * request: the payload of the request, with its type and room for the
+ * sequence number.
+ * length: the length of the request.
+ * attempts: the number of times to send the request without a reply.
+ * 
+ * Returns: the length of the reply, which is in the decoder payload, or -1
+ * if there is no reply.
+ */
+int rcmhost_request(RcmHost* host, uint8_t* request, int length, int attempts) {
+
+    uint8_t frame[HOST_ENCODED_MAX];
+    int frameLength;
+    int replyLength = -1;
+
+    request[1] = host->sequence++;
+    frameLength = s4743527_lib_hostproto_encode(request, length, frame);
+
+    for (int i = 0; i < attempts && replyLength < 0; i++) {
+
+        if (write(host->fd, frame, frameLength) != frameLength) {
+            return -1;
+        }
+
+        replyLength = rcmhost_wait_reply(host, request[0], request[1]);
+    }
+
+    return replyLength;
+}
+
+/**
+ * Moves the RCM to a position. Axes not set in its axes are not moved.
+ * 
+ * host: the connection.
+ * position: the position.
+ * 
+ * Returns: the status of the reply, or -1 if there is no reply.
+ */
+extern int rcmhost_goto(RcmHost* host, const RcmHostPosition* position) {
+
+    uint8_t request[2 + HOST_POSITION_LENGTH] = {HOST_GOTO};
+
+    rcmhost_put_position(&request[2], position);
+
+    if (rcmhost_request(host, request, sizeof(request), RCMHOST_RETRIES) < 0) {
+        return -1;
+    }
+
+    return host->decoder.payload[2];
+}
+
+/**
+ * Queues a list of moves on the board, which runs them one after another.
+ * 
+ * host: the connection.
+ * positions: the positions to move to.
+ * count: the number of positions, up to HOST_MAX_MOVES.
+ * 
+ * Returns: the number of moves queued, which is less than count if the
+ * board is busy, or -1 if there is no reply.
+ */
+extern int rcmhost_moves(RcmHost* host, const RcmHostPosition* positions, int count) {
+
+    uint8_t request[3 + HOST_MAX_MOVES * HOST_POSITION_LENGTH] = {HOST_MOVES};
+    int length = 3;
+
+    if (count < 0 || count > HOST_MAX_MOVES) {
+        return -1;
+    }
+
+    request[2] = count;
+    for (int i = 0; i < count; i++) {
+        length += rcmhost_put_position(&request[length], &positions[i]);
+    }
+
+    if (rcmhost_request(host, request, length, RCMHOST_RETRIES) < 4 || 
+            host->decoder.payload[2] == HOST_BAD_LENGTH) {
+        return -1;
+    }
+
+    return host->decoder.payload[3];
+}
+
+/**
+ * Reads the position and counters of the board.
+ * 
+ * host: the connection.
+ * stats: the position and counters read.
+ * 
+ * Returns: 0 if read, or -1 if there is no reply.
+ */
+extern int rcmhost_stats(RcmHost* host, RcmHostStats* stats) {
+
+    uint8_t request[2] = {HOST_STATS};
+    const uint8_t* data = &host->decoder.payload[3];
+
+    if (rcmhost_request(host, request, sizeof(request), RCMHOST_RETRIES) != 
+            3 + HOST_STATS_LENGTH) {
+        return -1;
+    }
+
+    stats->position.axes = HOST_AXES_ALL;
+    stats->position.xPos = (int16_t) rcmhost_get(&data[0], 2);
+    stats->position.yPos = (int16_t) rcmhost_get(&data[2], 2);
+    stats->position.zPos = (int16_t) rcmhost_get(&data[4], 2);
+    stats->position.zoom = (int16_t) rcmhost_get(&data[6], 2);
+    stats->position.rotate = (int16_t) rcmhost_get(&data[8], 2);
+    stats->received = rcmhost_get(&data[10], 4);
+    stats->ringOverruns = rcmhost_get(&data[14], 4);
+    stats->uartOverruns = rcmhost_get(&data[18], 4);
+    stats->frames = rcmhost_get(&data[22], 4);
+    stats->errors = rcmhost_get(&data[26], 4);
+    stats->scanState = data[30];
+    stats->scriptSpace = data[31];
+
+    return 0;
+}
\ No newline at end of file
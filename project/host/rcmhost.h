@@ -0,0 +1,77 @@
+/** 
+ **************************************************************
+ * @file project/host/rcmhost.h
+ * @author agent
+ * @date 18102026
+ * @brief Host client library for the framed binary protocol of the RCM
+ * controller.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * rcmhost_open() - Opens the debug UART of the board.
+ * rcmhost_close() - Closes the debug UART.
+ * rcmhost_goto() - Moves the RCM to a position.
+ * rcmhost_moves() - Queues a list of moves.
+ * rcmhost_stats() - Reads the position and counters of the board.
+ *************************************************************** 
+ */
+
+#ifndef RCMHOST_H
+#define RCMHOST_H
+
+#include <stdint.h>
+#include "s4743527_hostproto.h"
+
+// Longest time to wait for a reply (ms).
+#define RCMHOST_TIMEOUT 200
+
+// Number of times a request is sent without a reply.
+#define RCMHOST_RETRIES 3
+
+// Struct for a connection to a board.
+typedef struct {
+    int fd;
+    uint8_t sequence;
+    HostDecoder decoder;
+} RcmHost;
+
+// Struct for a position of the RCM.
+typedef struct {
+    int axes; // HOST_AXIS_* bits of the axes to move, others are kept
+    int xPos;
+    int yPos;
+    int zPos;
+    int zoom;
+    int rotate;
+} RcmHostPosition;
+
+// Struct for the position and counters of the board.
+typedef struct {
+    RcmHostPosition position;
+    uint32_t received; // Bytes received by the debug UART
+    uint32_t ringOverruns;
+    uint32_t uartOverruns;
+    uint32_t frames; // Good frames received
+    uint32_t errors; // Frames dropped
+    int scanState;
+    int scriptSpace; // Moves that can be queued
+} RcmHostStats;
+
+// Function prototypes
+
+// Opens the debug UART of the board, which may be a serial port or a pty.
+extern int rcmhost_open(RcmHost* host, const char* path);
+
+// Closes the debug UART.
+extern void rcmhost_close(RcmHost* host);
+
+// Moves the RCM to a position.
+extern int rcmhost_goto(RcmHost* host, const RcmHostPosition* position);
+
+// Queues a list of moves, which run one after another.
+extern int rcmhost_moves(RcmHost* host, const RcmHostPosition* positions, int count);
+
+// Reads the position and counters of the board.
+extern int rcmhost_stats(RcmHost* host, RcmHostStats* stats);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,160 @@
+/** 
+ **************************************************************
+ * @file project/host/rcmhost_cli.c
+ * @author agent
+ * @date 18102026
+ * @brief Command line tool that drives the RCM controller with the host
+ * client library.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * main() - Runs a command given on the command line.
+ *************************************************************** 
+ */
+
+#include "rcmhost.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Time to wait for the board to run queued moves when it is busy (us).
+#define CLI_BUSY_WAIT 100000
+
+/**
+ * Reads a position from text, with zoom and rotate optional.
+ * 
+ * text: the text, as x y z [zoom] [rotate].
+ * position: the position read.
+ * 
+ * Returns: 0 if read, or -1 otherwise.
+ */
+int cli_position(const char* text, RcmHostPosition* position) {
+
+    int count;
+
+    position->zoom = 0;
+    position->rotate = 0;
+
+    count = sscanf(text, "%d %d %d %d %d", &position->xPos, &position->yPos,
+            &position->zPos, &position->zoom, &position->rotate);
+    if (count < 3) {
+        return -1;
+    }
+
+    // Axes are given in the same order as their bits.
+    position->axes = (0x01 << count) - 1;
+
+    return 0;
+}
+
+/**
+ * Queues every position read from stdin, one per line, in lists of up to
+ * HOST_MAX_MOVES. Moves the board has no room for are sent again later.
+ * 
+ * host: the connection.
+ * 
+ * Returns: 0 if all moves are queued, or 1 otherwise.
+ */
+int cli_moves(RcmHost* host) {
+
+    RcmHostPosition positions[HOST_MAX_MOVES];
+    char text[128];
+    int count = 0;
+    int queued;
+    int done = 0;
+
+    while (!done || count > 0) {
+
+        while (!done && count < HOST_MAX_MOVES) {
+            if (fgets(text, sizeof(text), stdin) == NULL) {
+                done = 1;
+            } else if (cli_position(text, &positions[count]) == 0) {
+                count++;
+            }
+        }
+
+        if ((queued = rcmhost_moves(host, positions, count)) < 0) {
+            fprintf(stderr, "No reply from board\n");
+            return 1;
+        }
+
+        memmove(positions, &positions[queued], (count - queued) * sizeof(positions[0]));
+        count -= queued;
+
+        if (count > 0) {
+            usleep(CLI_BUSY_WAIT);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Runs a command given on the command line:
+ * 
+ *   rcmhost port goto x y z [zoom] [rotate]
+ *   rcmhost port moves < positions.txt
+ *   rcmhost port stats
+ * 
+ * Returns: 0 if the command succeeds, or 1 otherwise.
+ */
+int main(int argc, char** argv) {
+
+    RcmHost host;
+    RcmHostPosition position;
+    RcmHostStats stats;
+    char text[128] = "";
+    int result = 1;
+
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s port goto x y z [zoom] [rotate] | moves | stats\n",
+                argv[0]);
+        return 1;
+    }
+
+    if (rcmhost_open(&host, argv[1]) != 0) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    if (strcmp(argv[2], "goto") == 0) {
+
+        for (int i = 3; i < argc; i++) {
+            strncat(text, argv[i], sizeof(text) - strlen(text) - 2);
+            strcat(text, " ");
+        }
+
+        if (cli_position(text, &position) != 0) {
+            fprintf(stderr, "Usage: %s port goto x y z [zoom] [rotate]\n", argv[0]);
+        } else if ((result = rcmhost_goto(&host, &position)) < 0) {
+            fprintf(stderr, "No reply from board\n");
+        } else if (result != HOST_OK) {
+            fprintf(stderr, "Board is busy\n");
+        }
+        result = (result != HOST_OK);
+
+    } else if (strcmp(argv[2], "moves") == 0) {
+        result = cli_moves(&host);
+
+    } else if (strcmp(argv[2], "stats") == 0) {
+
+        if (rcmhost_stats(&host, &stats) != 0) {
+            fprintf(stderr, "No reply from board\n");
+        } else {
+            printf("Position: x %d y %d z %d zoom %d rotate %d\n", stats.position.xPos,
+                    stats.position.yPos, stats.position.zPos, stats.position.zoom,
+                    stats.position.rotate);
+            printf("UART: %u received, %u ring overruns, %u UART overruns\n",
+                    stats.received, stats.ringOverruns, stats.uartOverruns);
+            printf("Frames: %u received, %u dropped\n", stats.frames, stats.errors);
+            printf("Scan state: %d, script space: %d\n", stats.scanState, 
+                    stats.scriptSpace);
+            result = 0;
+        }
+    }
+
+    rcmhost_close(&host);
+
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,384 @@
+/**
+ **************************************************************
+ * @file project/host/test/test_loopback.c
+ * @author agent
+ * @date 18102026
+ * @brief Runs the host client library against a board stand-in over a
+ * pty. The stand-in decodes requests with the board's frame decoder,
+ * writes display output between replies, and loses one request and
+ * corrupts one reply, so escaping, retries and repeated requests are all
+ * checked. The decoder's speed is measured against the UART rate.
+ ***************************************************************
+ */
+
+#define _XOPEN_SOURCE 600
+#include "rcmhost.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Bytes per second of the debug UART, at 115200 baud and 10 bits a byte.
+#define LOOPBACK_UART_RATE  11520
+
+// Number of gotos sent back to back.
+#define LOOPBACK_GOTOS      500
+
+// Number of frames decoded to measure the decoder.
+#define LOOPBACK_FRAMES     20000
+
+// Display output the board writes between replies, with bytes the
+// decoder must pass over.
+#define LOOPBACK_DISPLAY    "\x1B[2J\x1B[1;1HX: 100 Y: 50\r\n\x11\x13"
+
+// Most moves the stand-in keeps.
+#define LOOPBACK_MOVES      1024
+
+#define LOOPBACK_CHECK(condition) \
+        loopback_check((condition), #condition, __LINE__)
+
+// Global variables
+// Number of checks run and failed.
+static int checks = 0;
+static int failures = 0;
+
+// Board end of the pty.
+static int boardFd = -1;
+
+// Positions moved to by the stand-in, in order.
+static RcmHostPosition moves[LOOPBACK_MOVES];
+static int moveCount = 0;
+
+// Counts of frames received by the stand-in.
+static HostStats boardStats = {0, 0};
+
+// Number of the request the stand-in loses, and the request whose reply
+// it corrupts, counted from 1. 0 for none.
+static int loseRequest = 0;
+static int corruptReply = 0;
+
+/**
+ * Records the result of a check, printing where it failed.
+ * 
+ * passed: non-zero if the check passed.
+ * text: the condition checked.
+ * line: the line of the check.
+ * 
+ * Returns: None
+ */
+void loopback_check(int passed, const char* text, int line) {
+
+    checks++;
+
+    if (!passed) {
+        failures++;
+        fprintf(stderr, "CHECK FAILED test/test_loopback.c:%d: %s\n", line, text);
+    }
+}
+
+/**
+ * Gets the time in microseconds.
+ * 
+ * Returns: the time.
+ */
+long loopback_time(void) {
+
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1000000L + now.tv_nsec / 1000;
+}
+
+/**
+ * Writes bytes from the board end of the pty.
+ * 
+ * data: the bytes.
+ * length: the number of bytes.
+ * 
+ * Returns: None
+ */
+void loopback_write(const void* data, int length) {
+
+    LOOPBACK_CHECK(write(boardFd, data, length) == length);
+}
+
+/**
+ * Reads a position from a request as the board does.
+ * 
+ * data: the first byte of the position.
+ * position: the position read.
+ * 
+ * Returns: None
+ */
+void loopback_get_position(const uint8_t* data, RcmHostPosition* position) {
+
+    position->axes = data[0];
+    position->xPos = (int16_t) (data[1] | (data[2] << 8));
+    position->yPos = (int16_t) (data[3] | (data[4] << 8));
+    position->zPos = (int16_t) (data[5] | (data[6] << 8));
+    position->zoom = (int16_t) (data[7] | (data[8] << 8));
+    position->rotate = (int16_t) (data[9] | (data[10] << 8));
+}
+
+/**
+ * Writes a little endian value into a reply.
+ * 
+ * data: where the value is written.
+ * value: the value.
+ * bytes: the number of bytes to write.
+ * 
+ * Returns: the number of bytes written.
+ */
+int loopback_put(uint8_t* data, uint32_t value, int bytes) {
+
+    for (int i = 0; i < bytes; i++) {
+        data[i] = (value >> (8 * i)) & 0xFF;
+    }
+
+    return bytes;
+}
+
+/**
+ * Runs a request as the board does and writes the reply. A repeat of the
+ * last request is only replied to.
+ * 
+ * payload: the payload of the request.
+ * length: the length of the payload.
+ * 
+ * Returns: None
+ */
+void loopback_handle(const uint8_t* payload, int length) {
+
+    static uint8_t frame[HOST_ENCODED_MAX];
+    static int frameLength = 0;
+    static int lastType = -1;
+    static int lastSequence = -1;
+    static int requests = 0;
+    uint8_t reply[3 + HOST_STATS_LENGTH];
+    int count = 3;
+    RcmHostPosition last = {0};
+
+    if (payload[0] == lastType && payload[1] == lastSequence) {
+        loopback_write(frame, frameLength);
+        return;
+    }
+
+    if (++requests == loseRequest) {
+        return;
+    }
+
+    lastType = payload[0];
+    lastSequence = payload[1];
+
+    reply[0] = payload[0] | HOST_REPLY;
+    reply[1] = payload[1];
+    reply[2] = HOST_OK;
+
+    if (payload[0] == HOST_GOTO && length == 2 + HOST_POSITION_LENGTH) {
+        loopback_get_position(&payload[2], &moves[moveCount++]);
+
+    } else if (payload[0] == HOST_MOVES && length == 3 + payload[2] * HOST_POSITION_LENGTH) {
+        for (int i = 0; i < payload[2]; i++) {
+            loopback_get_position(&payload[3 + i * HOST_POSITION_LENGTH], 
+                    &moves[moveCount++]);
+        }
+        count += loopback_put(&reply[count], payload[2], 1);
+
+    } else if (payload[0] == HOST_STATS && length == 2) {
+        if (moveCount > 0) {
+            last = moves[moveCount - 1];
+        }
+        count += loopback_put(&reply[count], last.xPos, 2);
+        count += loopback_put(&reply[count], last.yPos, 2);
+        count += loopback_put(&reply[count], last.zPos, 2);
+        count += loopback_put(&reply[count], last.zoom, 2);
+        count += loopback_put(&reply[count], last.rotate, 2);
+        count += loopback_put(&reply[count], 0, 4);
+        count += loopback_put(&reply[count], 0, 4);
+        count += loopback_put(&reply[count], 0, 4);
+        count += loopback_put(&reply[count], boardStats.frames, 4);
+        count += loopback_put(&reply[count], boardStats.errors, 4);
+        count += loopback_put(&reply[count], 0, 1);
+        count += loopback_put(&reply[count], HOST_MAX_MOVES, 1);
+
+    } else {
+        reply[2] = HOST_BAD_LENGTH;
+    }
+
+    frameLength = s4743527_lib_hostproto_encode(reply, count, frame);
+    loopback_write(LOOPBACK_DISPLAY, strlen(LOOPBACK_DISPLAY));
+
+    // A corrupted reply fails its CRC, so the host sends the request again
+    // and gets the reply kept for it.
+    if (requests == corruptReply) {
+        frame[2] ^= 0x01;
+        loopback_write(frame, frameLength);
+        frame[2] ^= 0x01;
+    } else {
+        loopback_write(frame, frameLength);
+    }
+}
+
+/**
+ * Thread that stands in for the board, decoding each byte from the host.
+ * 
+ * arg: unused.
+ * 
+ * Returns: NULL
+ */
+void* loopback_board(void* arg) {
+
+    HostDecoder decoder;
+    uint8_t data[256];
+    int count;
+    int length;
+
+    s4743527_lib_hostproto_decoder_init(&decoder);
+
+    while ((count = read(boardFd, data, sizeof(data))) > 0) {
+        for (int i = 0; i < count; i++) {
+
+            length = s4743527_lib_hostproto_decode(&decoder, data[i]);
+
+            if (length == HOST_BAD) {
+                boardStats.errors++;
+            } else if (length >= 2) {
+                boardStats.frames++;
+                loopback_handle(decoder.payload, length);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Checks two positions are the same.
+ * 
+ * a: the first position.
+ * b: the second position.
+ * 
+ * Returns: 1 if they are the same, 0 otherwise.
+ */
+int loopback_same(const RcmHostPosition* a, const RcmHostPosition* b) {
+
+    return a->axes == b->axes && a->xPos == b->xPos && a->yPos == b->yPos &&
+            a->zPos == b->zPos && a->zoom == b->zoom && a->rotate == b->rotate;
+}
+
+/**
+ * Decodes many encoded frames in one stream, checking each one, and
+ * reports the decoder's rate as a multiple of the UART rate.
+ * 
+ * Returns: None
+ */
+void loopback_decode_rate(void) {
+
+    static uint8_t stream[LOOPBACK_FRAMES * 64];
+    uint8_t payload[HOST_PAYLOAD_MAX];
+    HostDecoder decoder;
+    int length = 0;
+    int good = 0;
+    long start;
+    long time;
+
+    // Payloads of every byte value, so a quarter of bytes are escaped.
+    for (int i = 0; i < LOOPBACK_FRAMES; i++) {
+        for (int j = 0; j < 24; j++) {
+            payload[j] = (i * 31 + j * 7) & 0xFF;
+        }
+        length += s4743527_lib_hostproto_encode(payload, 24, &stream[length]);
+    }
+
+    s4743527_lib_hostproto_decoder_init(&decoder);
+    start = loopback_time();
+    for (int i = 0; i < length; i++) {
+        if (s4743527_lib_hostproto_decode(&decoder, stream[i]) == 24) {
+            good++;
+        }
+    }
+    time = loopback_time() - start;
+
+    LOOPBACK_CHECK(good == LOOPBACK_FRAMES);
+    fprintf(stderr, "REPORT loopback: decoded %d bytes in %ld us, %ld times the UART rate\n",
+            length, time, (time > 0) ? (length * 1000000L / time) / LOOPBACK_UART_RATE : 0);
+}
+
+int main(void) {
+
+    pthread_t board;
+    RcmHost host;
+    RcmHostStats stats;
+    RcmHostPosition sent[HOST_MAX_MOVES];
+    RcmHostPosition edge = {HOST_AXES_ALL, HOST_END, HOST_ESC, -1, 0x11, 0x13};
+    long start;
+    long time;
+
+    if ((boardFd = posix_openpt(O_RDWR | O_NOCTTY)) < 0 || grantpt(boardFd) != 0 ||
+            unlockpt(boardFd) != 0 || rcmhost_open(&host, ptsname(boardFd)) != 0) {
+        fprintf(stderr, "CHECK FAILED no pty\n");
+        return 1;
+    }
+
+    pthread_create(&board, NULL, loopback_board, NULL);
+
+    // Values that are frame bytes or terminal control bytes arrive intact.
+    LOOPBACK_CHECK(rcmhost_goto(&host, &edge) == HOST_OK);
+    LOOPBACK_CHECK(moveCount == 1 && loopback_same(&moves[0], &edge));
+
+    // A lost request is sent again and run once.
+    loseRequest = 2;
+    sent[0] = (RcmHostPosition) {HOST_AXIS_X, 10, 0, 0, 0, 0};
+    LOOPBACK_CHECK(rcmhost_goto(&host, &sent[0]) == HOST_OK);
+    LOOPBACK_CHECK(moveCount == 2 && loopback_same(&moves[1], &sent[0]));
+
+    // A corrupted reply is asked for again, and its request is still run
+    // once.
+    corruptReply = 4;
+    for (int i = 0; i < HOST_MAX_MOVES; i++) {
+        sent[i] = (RcmHostPosition) {HOST_AXES_ALL, i * 12, 200 - i * 12, i, 1, i * 20};
+    }
+    LOOPBACK_CHECK(rcmhost_moves(&host, sent, HOST_MAX_MOVES) == HOST_MAX_MOVES);
+    LOOPBACK_CHECK(moveCount == 2 + HOST_MAX_MOVES);
+    for (int i = 0; i < HOST_MAX_MOVES && i + 2 < moveCount; i++) {
+        LOOPBACK_CHECK(loopback_same(&moves[2 + i], &sent[i]));
+    }
+
+    LOOPBACK_CHECK(rcmhost_stats(&host, &stats) == 0);
+    LOOPBACK_CHECK(loopback_same(&stats.position, &sent[HOST_MAX_MOVES - 1]));
+    LOOPBACK_CHECK(stats.errors == 0 && stats.scriptSpace == HOST_MAX_MOVES);
+
+    // Each request was received once, and the lost and corrupted ones
+    // twice.
+    LOOPBACK_CHECK(stats.frames == 6);
+
+    // Gotos back to back, each waiting for its reply.
+    moveCount = 0;
+    start = loopback_time();
+    for (int i = 0; i < LOOPBACK_GOTOS; i++) {
+        sent[0] = (RcmHostPosition) {HOST_AXIS_X | HOST_AXIS_Y, i % 200, i % 150, 0, 0, 0};
+        if (rcmhost_goto(&host, &sent[0]) != HOST_OK || moveCount == 0 ||
+                !loopback_same(&moves[moveCount - 1], &sent[0])) {
+            break;
+        }
+    }
+    time = loopback_time() - start;
+    LOOPBACK_CHECK(moveCount == LOOPBACK_GOTOS);
+    LOOPBACK_CHECK(boardStats.errors == 0);
+
+    fprintf(stderr, "REPORT loopback: %d gotos in %ld ms over a pty\n", 
+            moveCount, time / 1000);
+
+    rcmhost_close(&host);
+
+    loopback_decode_rate();
+
+    fprintf(stderr, "TEST %d checks, %d failed\n", checks, failures);
+
+    return (failures == 0) ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+/** 
+ **************************************************************
+ * @file project/s4743527_rcmbookmark.c
+ * @author agent
+ * @date 18102026
+ * @brief Bookmarks of RCM positions saved in flash.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4743527_lib_rcmbookmark_load() - Loads bookmarks from flash.
+ * s4743527_lib_rcmbookmark_save() - Saves a bookmark.
+ * s4743527_lib_rcmbookmark_delete() - Deletes a bookmark.
+ * s4743527_lib_rcmbookmark_get() - Gets a bookmark by number.
+ * s4743527_lib_rcmbookmark_find() - Finds a bookmark by name.
+ *************************************************************** 
+ */
+
+#include "s4743527_rcmbookmark.h"
+#include "s4743527_flash.h"
+#include <stddef.h>
+
+// Global variable
+// All bookmarks, kept in RAM so recall does not read flash.
+static BookmarkTable bookmarkTable;
+
+/**
+ * Loads bookmarks saved in flash, or starts with no bookmarks if none are
+ * saved.
+ * 
+ * Returns: None
+ */
+extern void s4743527_lib_rcmbookmark_load(void) {
+
+    if (s4743527_lib_flash_load(FLASH_BOOKMARK_SECTOR, &bookmarkTable, 
+            sizeof(BookmarkTable)) != 0) {
+        bookmarkTable.used = 0;
+    }
+}
+
+/**
+ * Saves a position as a bookmark and writes all bookmarks to flash.
+ * 
+ * number: the bookmark number (0 to 9).
+ * name: the name of the bookmark, which is cut to fit.
+ * nameLength: the number of characters in the name.
+ * rcm: the RCM data to save.
+ * 
+ * Returns: 0 if saved, -1 otherwise.
+ */
+extern int s4743527_lib_rcmbookmark_save(int number, const char* name, int nameLength,
+        RCMData* rcm) {
+
+    if (number < 0 || number >= NUM_OF_BOOKMARKS) {
+        return -1;
+    }
+
+    if (nameLength > BOOKMARK_NAME_LENGTH - 1) {
+        nameLength = BOOKMARK_NAME_LENGTH - 1;
+    }
+
+    Bookmark* bookmark = &bookmarkTable.bookmarks[number];
+
+    for (int i = 0; i < nameLength; i++) {
+        bookmark->name[i] = name[i];
+    }
+    bookmark->name[nameLength] = '\0';
+    bookmark->rcm = *rcm;
+    bookmarkTable.used |= (1 << number);
+
+    return s4743527_lib_flash_save(FLASH_BOOKMARK_SECTOR, &bookmarkTable, 
+            sizeof(BookmarkTable));
+}
+
+/**
+ * Deletes a bookmark and writes all bookmarks to flash.
+ * 
+ * number: the bookmark number (0 to 9).
+ * 
+ * Returns: 0 if deleted, -1 otherwise.
+ */
+extern int s4743527_lib_rcmbookmark_delete(int number) {
+
+    if (s4743527_lib_rcmbookmark_get(number) == NULL) {
+        return -1;
+    }
+
+    bookmarkTable.used &= ~(1 << number);
+
+    return s4743527_lib_flash_save(FLASH_BOOKMARK_SECTOR, &bookmarkTable, 
+            sizeof(BookmarkTable));
+}
+
+/**
+ * Gets a bookmark by its number.
+ * 
+ * number: the bookmark number (0 to 9).
+ * 
+ * Returns: the bookmark, or NULL if it is not saved.
+ */
+extern const Bookmark* s4743527_lib_rcmbookmark_get(int number) {
+
+    if (number < 0 || number >= NUM_OF_BOOKMARKS || 
+            !(bookmarkTable.used & (1 << number))) {
+        return NULL;
+    }
+
+    return &bookmarkTable.bookmarks[number];
+}
+
+/**
+ * Finds the number of a bookmark by its name.
+ * 
+ * name: the name to find.
+ * nameLength: the number of characters in the name.
+ * 
+ * Returns: the bookmark number, or -1 if no bookmark has the name.
+ */
+extern int s4743527_lib_rcmbookmark_find(const char* name, int nameLength) {
+
+    for (int number = 0; number < NUM_OF_BOOKMARKS; number++) {
+
+        const Bookmark* bookmark = s4743527_lib_rcmbookmark_get(number);
+        if (bookmark == NULL) {
+            continue;
+        }
+
+        int i = 0;
+        while (i < nameLength && bookmark->name[i] == name[i]) {
+            i++;
+        }
+
+        if (i == nameLength && bookmark->name[i] == '\0') {
+            return number;
+        }
+    }
+
+    return -1;
+}
\ No newline at end of file
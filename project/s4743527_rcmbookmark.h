@@ -0,0 +1,70 @@
+/** 
+ **************************************************************
+ * @file project/s4743527_rcmbookmark.h
+ * @author agent
+ * @date 18102026
+ * @brief Bookmarks of RCM positions saved in flash.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4743527_lib_rcmbookmark_load() - Loads bookmarks from flash.
+ * s4743527_lib_rcmbookmark_save() - Saves a bookmark.
+ * s4743527_lib_rcmbookmark_delete() - Deletes a bookmark.
+ * s4743527_lib_rcmbookmark_get() - Gets a bookmark by number.
+ * s4743527_lib_rcmbookmark_find() - Finds a bookmark by name.
+ *************************************************************** 
+ */
+
+#ifndef S4743527_RCMBOOKMARK_H
+#define S4743527_RCMBOOKMARK_H
+
+#include <stdint.h>
+#include "s4743527_rcmdisplay.h"
+
+// Number of bookmarks, numbered from 0.
+#define NUM_OF_BOOKMARKS    10
+
+// Maximum length of a bookmark name, including null character.
+#define BOOKMARK_NAME_LENGTH    9
+
+// Keys that recall each bookmark, in order of bookmark number. These are
+// the digit keys with shift held.
+#define BOOKMARK_KEYMAP(KEY) \
+        KEY(')', 0) KEY('!', 1) KEY('@', 2) KEY('#', 3) KEY('$', 4) \
+        KEY('%', 5) KEY('^', 6) KEY('&', 7) KEY('*', 8) KEY('(', 9)
+
+// Position of bookmark list on display
+#define BOOKMARK_LIST_X 110
+#define BOOKMARK_LIST_Y 54
+
+// Struct for a bookmarked position.
+typedef struct {
+    char name[BOOKMARK_NAME_LENGTH];
+    RCMData rcm;
+} Bookmark;
+
+// Struct for all bookmarks, with a bit set in used for each saved bookmark.
+typedef struct {
+    uint16_t used;
+    Bookmark bookmarks[NUM_OF_BOOKMARKS];
+} BookmarkTable;
+
+// Function prototypes
+
+// Loads bookmarks saved in flash.
+extern void s4743527_lib_rcmbookmark_load(void);
+
+// Saves a bookmark and writes all bookmarks to flash.
+extern int s4743527_lib_rcmbookmark_save(int number, const char* name, int nameLength,
+        RCMData* rcm);
+
+// Deletes a bookmark and writes all bookmarks to flash.
+extern int s4743527_lib_rcmbookmark_delete(int number);
+
+// Gets a bookmark by its number.
+extern const Bookmark* s4743527_lib_rcmbookmark_get(int number);
+
+// Finds the number of a bookmark by its name.
+extern int s4743527_lib_rcmbookmark_find(const char* name, int nameLength);
+
+#endif
\ No newline at end of file
@@ -8,6 +8,20 @@
  ***************************************************************
  * EXTERNAL FUNCTIONS
  ***************************************************************
+ * s4743527_lib_rcmcont_clamp() - Limits a value to within a range.
+ * s4743527_lib_rcmcont_axis() - Gets the value of an axis.
+ * s4743527_lib_rcmcont_set_axis() - Sets an axis within its limits.
+ * s4743527_lib_rcmcont_config_set() - Sets limits and steps of an axis.
+ * s4743527_lib_rcmcont_config_load() - Loads axis config from flash.
+ * s4743527_lib_rcmcont_config_save() - Saves axis config to flash.
+ * s4743527_lib_rcmcont_history_init() - Initialises position history.
+ * s4743527_lib_rcmcont_history_push() - Adds a state to history.
+ * s4743527_lib_rcmcont_history_undo() - Gets the previous state.
+ * s4743527_lib_rcmcont_history_redo() - Gets the next undone state.
+ * s4743527_lib_rcmcont_jog_step() - Scales step of a repeated key.
+ * s4743527_lib_rcmcont_sin() - Gets the sine of an angle.
+ * s4743527_lib_rcmcont_cos() - Gets the cosine of an angle.
+ * s4743527_lib_rcmcont_frame_transform() - Rotates a move into the sample frame.
  * s4743527_tsk_rcmcont_init() - Initialises the RCM control task.
  *************************************************************** 
  */
@@ -15,6 +29,11 @@
 #include "s4743527_rcmcont.h"
 #include "s4743527_txradio.h"
 #include "s4743527_rcmdisplay.h"
+#include "s4743527_rcmscan.h"
+#include "s4743527_rcmtraj.h"
+#include "s4743527_rcmbookmark.h"
+#include "s4743527_rcmkeepout.h"
+#include "s4743527_rcmscript.h"
 #include "s4743527_mfs_led.h"
 #include "s4743527_board_pb.h"
 #include "s4743527_console.h"
@@ -23,6 +42,8 @@
 #include "s4743527_rgb.h"
 #include "s4743527_lta1000g.h"
 #include "s4743527_mfs_ssd.h"
+#include "s4743527_bkpsram.h"
+#include "s4743527_flash.h"
 
 #include "FreeRTOS.h"
 #include "task.h"
@@ -31,7 +52,495 @@
 #include "queue.h"
 
 #include "board.h"
-#include "debug_log.h"
+#include "s4743527_uarttx.h"
+
+// Global variables
+// Handle for queue of commands sent to RCM control.
+QueueHandle_t s4743527QueueRcmCommand;
+// Last RCM data sent to the display.
+RCMData s4743527RcmState = {0, 0, 0, 1, 0};
+// Limits and step sizes of each axis.
+RCMConfig s4743527RcmConfig = RCM_CONFIG_DEFAULT;
+
+/**
+ * Limits a value to within a range.
+ * 
+ * value: the value to limit.
+ * min: the minimum value allowed.
+ * max: the maximum value allowed.
+ * 
+ * Returns: the value limited to between min and max.
+ */
+extern int s4743527_lib_rcmcont_clamp(int value, int min, int max) {
+
+    if (value < min) {
+        return min;
+    } else if (value > max) {
+        return max;
+    }
+    return value;
+}
+
+/**
+ * Gets a pointer to the value of an axis in RCM data.
+ * 
+ * rcm: the RCM data.
+ * axis: the axis (AXIS_X, AXIS_Y, AXIS_Z, AXIS_ZOOM, or AXIS_ROTATE).
+ * 
+ * Returns: pointer to the value of the axis.
+ */
+extern int* s4743527_lib_rcmcont_axis(RCMData* rcm, int axis) {
+
+    switch (axis) {
+        case AXIS_X:
+            return &rcm->xPos;
+        case AXIS_Y:
+            return &rcm->yPos;
+        case AXIS_Z:
+            return &rcm->zPos;
+        case AXIS_ZOOM:
+            return &rcm->zoom;
+        default:
+            return &rcm->rotate;
+    }
+}
+
+/**
+ * Sets the value of an axis, limited to its range.
+ * 
+ * value: pointer to the value of the axis.
+ * target: the value to set.
+ * axis: the limits of the axis.
+ * 
+ * Returns: 1 if the value changed, 0 if it was already at the target or
+ *          pinned at a limit.
+ */
+extern int s4743527_lib_rcmcont_set_axis(int* value, int target, AxisConfig* axis) {
+
+    int old = *value;
+
+    *value = s4743527_lib_rcmcont_clamp(target, axis->min, axis->max);
+
+    return *value != old;
+}
+
+/**
+ * Sets the limits and step sizes of an axis.
+ * 
+ * axis: the axis to set.
+ * config: the limits and step sizes.
+ * 
+ * Returns: 0 if set, or -1 if the config does not fit the axis packet or
+ *          the keep-out grid.
+ */
+extern int s4743527_lib_rcmcont_config_set(int axis, AxisConfig* config) {
+
+    int packetMax[NUM_OF_AXES] = AXIS_PACKET_MAX;
+
+    if (axis < 0 || axis >= NUM_OF_AXES || config->min < 0 || 
+            config->min > config->max || config->max > packetMax[axis]) {
+        return -1;
+    }
+
+    // Keep-out zones only cover X and Y positions within their grid.
+    if ((axis == AXIS_X || axis == AXIS_Y) && config->max >= KEEPOUT_GRID_SIZE) {
+        return -1;
+    }
+
+    for (uint8_t i = 0; i < NUM_OF_STEPS; i++) {
+        if (config->step[i] < 1) {
+            return -1;
+        }
+    }
+
+    taskENTER_CRITICAL();
+    s4743527RcmConfig.axis[axis] = *config;
+    taskEXIT_CRITICAL();
+
+    return 0;
+}
+
+/**
+ * Loads the limits and step sizes of all axes from flash, keeping the
+ * defaults if none are saved or for any axis that is not valid.
+ * 
+ * Returns: None
+ */
+extern void s4743527_lib_rcmcont_config_load(void) {
+
+    RCMConfig config;
+
+    if (s4743527_lib_flash_load(FLASH_CONFIG_SECTOR, &config, sizeof(RCMConfig)) == 0) {
+        for (int axis = 0; axis < NUM_OF_AXES; axis++) {
+            s4743527_lib_rcmcont_config_set(axis, &config.axis[axis]);
+        }
+    }
+}
+
+/**
+ * Saves the limits and step sizes of all axes to flash.
+ * 
+ * Returns: 0 if saved, -1 otherwise.
+ */
+extern int s4743527_lib_rcmcont_config_save(void) {
+
+    RCMConfig config;
+
+    taskENTER_CRITICAL();
+    config = s4743527RcmConfig;
+    taskEXIT_CRITICAL();
+
+    return s4743527_lib_flash_save(FLASH_CONFIG_SECTOR, &config, sizeof(RCMConfig));
+}
+
+/**
+ * Initialises position history with the current state.
+ * 
+ * history: the position history.
+ * rcm: the current RCM data.
+ * 
+ * Returns: None
+ */
+extern void s4743527_lib_rcmcont_history_init(RCMHistory* history, RCMData* rcm) {
+
+    history->current = 0;
+    history->states[0] = *rcm;
+    history->undoCount = 0;
+    history->redoCount = 0;
+}
+
+/**
+ * Adds a new state to position history, overwriting the oldest state once
+ * full. Any undone states can no longer be redone.
+ * 
+ * history: the position history.
+ * rcm: the new RCM data.
+ * 
+ * Returns: None
+ */
+extern void s4743527_lib_rcmcont_history_push(RCMHistory* history, RCMData* rcm) {
+
+    history->current = (history->current + 1) % HISTORY_SIZE;
+    history->states[history->current] = *rcm;
+
+    if (history->undoCount < HISTORY_SIZE - 1) {
+        history->undoCount++;
+    }
+    history->redoCount = 0;
+}
+
+/**
+ * Gets the state before the current state in position history.
+ * 
+ * history: the position history.
+ * rcm: set to the previous RCM data.
+ * 
+ * Returns: 1 if there was a state to undo to, 0 otherwise.
+ */
+extern int s4743527_lib_rcmcont_history_undo(RCMHistory* history, RCMData* rcm) {
+
+    if (history->undoCount == 0) {
+        return 0;
+    }
+
+    history->current = (history->current + HISTORY_SIZE - 1) % HISTORY_SIZE;
+    history->undoCount--;
+    history->redoCount++;
+    *rcm = history->states[history->current];
+
+    return 1;
+}
+
+/**
+ * Gets the state after the current state in position history.
+ * 
+ * history: the position history.
+ * rcm: set to the next RCM data.
+ * 
+ * Returns: 1 if there was a state to redo, 0 otherwise.
+ */
+extern int s4743527_lib_rcmcont_history_redo(RCMHistory* history, RCMData* rcm) {
+
+    if (history->redoCount == 0) {
+        return 0;
+    }
+
+    history->current = (history->current + 1) % HISTORY_SIZE;
+    history->redoCount--;
+    history->undoCount++;
+    *rcm = history->states[history->current];
+
+    return 1;
+}
+
+/**
+ * Scales the step size of a key by how long it has been held. Each repeat
+ * of the same key within JOG_TIMEOUT moves further along JOG_CURVE, and
+ * any other key or a pause starts again from the first step size.
+ * 
+ * jog: the repeats of the last key.
+ * key: the key pressed.
+ * tick: the time the key was pressed (ms).
+ * step: the step size of the key.
+ * max: the largest scaled step size.
+ * 
+ * Returns: the scaled step size.
+ */
+extern int s4743527_lib_rcmcont_jog_step(JogState* jog, int key, TickType_t tick,
+        int step, int max) {
+
+    int curve[JOG_CURVE_LENGTH] = JOG_CURVE;
+
+    if (key == jog->key && (tick - jog->lastTick) <= JOG_TIMEOUT) {
+        if (jog->repeats < JOG_CURVE_LENGTH - 1) {
+            jog->repeats++;
+        }
+    } else {
+        jog->key = key;
+        jog->repeats = 0;
+    }
+
+    jog->lastTick = tick;
+
+    int scaled = step * curve[jog->repeats];
+
+    // The first step is never cut, even if it is larger than the cap.
+    if (scaled > max) {
+        scaled = (max > step) ? max : step;
+    }
+
+    return scaled;
+}
+
+// Sine of 0 to 90 degrees (Q14).
+static const int16_t sinTable[91] = {
+        0, 286, 572, 857, 1143, 1428, 1713, 1997, 2280, 2563,
+        2845, 3126, 3406, 3686, 3964, 4240, 4516, 4790, 5063, 5334,
+        5604, 5872, 6138, 6402, 6664, 6924, 7182, 7438, 7692, 7943,
+        8192, 8438, 8682, 8923, 9162, 9397, 9630, 9860, 10087, 10311,
+        10531, 10749, 10963, 11174, 11381, 11585, 11786, 11982, 12176, 12365,
+        12551, 12733, 12911, 13085, 13255, 13421, 13583, 13741, 13894, 14044,
+        14189, 14330, 14466, 14598, 14726, 14849, 14968, 15082, 15191, 15296,
+        15396, 15491, 15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083,
+        16135, 16182, 16225, 16262, 16294, 16322, 16344, 16362, 16374, 16382,
+        16384};
+
+/**
+ * Gets the sine of an angle from a quarter wave table.
+ * 
+ * degrees: the angle in degrees.
+ * 
+ * Returns: the sine of the angle (Q14).
+ */
+extern int s4743527_lib_rcmcont_sin(int degrees) {
+
+    degrees %= 360;
+    if (degrees < 0) {
+        degrees += 360;
+    }
+
+    if (degrees <= 90) {
+        return sinTable[degrees];
+    } else if (degrees <= 180) {
+        return sinTable[180 - degrees];
+    } else if (degrees <= 270) {
+        return -sinTable[degrees - 180];
+    } else {
+        return -sinTable[360 - degrees];
+    }
+}
+
+/**
+ * Gets the cosine of an angle from a quarter wave table.
+ * 
+ * degrees: the angle in degrees.
+ * 
+ * Returns: the cosine of the angle (Q14).
+ */
+extern int s4743527_lib_rcmcont_cos(int degrees) {
+
+    return s4743527_lib_rcmcont_sin(degrees + 90);
+}
+
+/**
+ * Rotates an X/Y move in the sample frame into the machine frame, rounding
+ * each component to the nearest step.
+ * 
+ * degrees: the rotation of the sample.
+ * x: the X distance, replaced by the machine X distance.
+ * y: the Y distance, replaced by the machine Y distance.
+ * 
+ * Returns: None
+ */
+extern void s4743527_lib_rcmcont_frame_transform(int degrees, int* x, int* y) {
+
+    int sine = s4743527_lib_rcmcont_sin(degrees);
+    int cosine = s4743527_lib_rcmcont_cos(degrees);
+    int half = 1 << (TRIG_SHIFT - 1);
+
+    int32_t machineX = (int32_t) *x * cosine - (int32_t) *y * sine;
+    int32_t machineY = (int32_t) *x * sine + (int32_t) *y * cosine;
+
+    // Round half away from zero so a move and its reverse cancel.
+    *x = (machineX >= 0) ? (machineX + half) >> TRIG_SHIFT :
+            -((-machineX + half) >> TRIG_SHIFT);
+    *y = (machineY >= 0) ? (machineY + half) >> TRIG_SHIFT :
+            -((-machineY + half) >> TRIG_SHIFT);
+}
+
+/**
+ * Sends the JOIN packet.
+ * 
+ * Returns: None
+ */
+void rcm_send_join_packet(void) {
+
+    uint8_t uncodedPacket[16] = {0x20, 0x47, 0x43, 0x52, 0x78, 'J', 'O', 'I', 'N',
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+    xQueueSend(s4743527QueueRadioPacket, (void*) &uncodedPacket, (portTickType) 10);
+}
+
+/**
+ * Saves the RCM data and JOIN status to backup SRAM, so it can be restored
+ * after a reset.
+ * 
+ * rcm: the current RCM data.
+ * joined: 1 if the JOIN packet has been sent, 0 otherwise.
+ * 
+ * Returns: None
+ */
+void rcm_save(RCMData* rcm, int joined) {
+
+    RCMRecord record;
+
+    record.rcm = *rcm;
+    record.joined = joined;
+    s4743527_lib_bkpsram_write(&record, sizeof(RCMRecord));
+}
+
+/**
+ * Sends the RCM data to the display and MFS SSD tasks.
+ * 
+ * rcm: the current RCM data.
+ * joined: 1 if the JOIN packet has been sent, 0 otherwise.
+ * 
+ * Returns: None
+ */
+void rcm_send_display(RCMData* rcm, int joined) {
+
+    SSDData ssdData;
+
+    // Update state for other tasks, and save it with the JOIN status so a
+    // reset resumes in the same state.
+    s4743527RcmState = *rcm;
+    rcm_save(rcm, joined);
+
+    // Send updated position data, replacing any the display has not read
+    // yet so it always draws the newest state.
+    xQueueOverwrite(s4743527QueueDisplayData, (void*) rcm);
+
+    // Send position to MFS SSD task
+    ssdData.xPos = rcm->xPos;
+    ssdData.yPos = rcm->yPos;
+    ssdData.zPos = rcm->zPos;
+    xQueueOverwrite(s4743527QueueSSD, (void*) &ssdData);
+}
+
+/**
+ * Moves the RCM directly to a target, keeping the axes that are not given.
+ * 
+ * rcm: the current RCM data, updated to the target.
+ * target: the target RCM data.
+ * axes: bits of the axes of the target to move to.
+ * 
+ * Returns: None
+ */
+void rcm_goto(RCMData* rcm, RCMData* target, int axes) {
+
+    RCMData old = *rcm;
+
+    for (uint8_t axis = 0; axis < NUM_OF_AXES; axis++) {
+        if (axes & RCM_AXIS_BIT(axis)) {
+            s4743527_lib_rcmcont_set_axis(s4743527_lib_rcmcont_axis(rcm, axis),
+                    *s4743527_lib_rcmcont_axis(target, axis), &s4743527RcmConfig.axis[axis]);
+        }
+    }
+
+    // Stop at the boundary of the first keep-out zone on the way.
+    if (s4743527_lib_rcmkeepout_sweep(&old, rcm)) {
+        s4743527KeepoutStats.moves++;
+    }
+
+    // Queue the move behind earlier ones, so none are dropped. Commands are
+    // only taken when there is room, so this doesn't wait.
+    if (rcm->xPos != old.xPos || rcm->yPos != old.yPos || rcm->zPos != old.zPos ||
+            rcm->zoom != old.zoom || rcm->rotate != old.rotate) {
+        s4743527_lib_rcmtraj_send(rcm, TRAJ_WAYPOINT);
+    }
+
+    // Gotos are only taken once joined.
+    rcm_send_display(rcm, 1);
+}
+
+/**
+ * Checks if two RCM states are the same.
+ * 
+ * a: the first RCM data.
+ * b: the second RCM data.
+ * 
+ * Returns: 1 if every axis is the same, 0 otherwise.
+ */
+int rcm_same(RCMData* a, RCMData* b) {
+
+    return a->xPos == b->xPos && a->yPos == b->yPos && a->zPos == b->zPos &&
+            a->zoom == b->zoom && a->rotate == b->rotate;
+}
+
+/**
+ * Adds the current state to position history if it is not already its
+ * current state, as when a scan or script has moved the RCM since.
+ * 
+ * history: the position history.
+ * rcm: the current RCM data.
+ * 
+ * Returns: None
+ */
+void rcm_history_keep(RCMHistory* history, RCMData* rcm) {
+
+    if (!rcm_same(&history->states[history->current], rcm)) {
+        s4743527_lib_rcmcont_history_push(history, rcm);
+    }
+}
+
+/**
+ * Takes the position the trajectory task stopped a target at, if it was
+ * stopped at a keep-out zone, as the current state. A target sent since
+ * replaces it, as the trajectory task moves on to that target from where
+ * it stopped.
+ * 
+ * rcm: the current RCM data, updated to where the target stopped.
+ * history: the position history, updated if its current state is the
+ *     target that stopped.
+ * 
+ * Returns: None
+ */
+void rcm_take_stop(RCMData* rcm, RCMHistory* history) {
+
+    TrajStop stop;
+
+    if (xQueueReceive(s4743527QueueTrajStop, &stop, 0) != pdTRUE ||
+            !rcm_same(rcm, &stop.target)) {
+        return;
+    }
+
+    if (rcm_same(&history->states[history->current], &stop.target)) {
+        history->states[history->current] = stop.stopped;
+    }
+
+    *rcm = stop.stopped;
+    rcm_send_display(rcm, 1);
+}
 
 /**
  * FSM for RCM Control.
@@ -44,6 +553,9 @@ void rcm_fsm_task(void) {
 
     BRD_debuguart_init();
 
+    // Send debug UART output with DMA, so tasks don't wait for the UART.
+    s4743527_reg_uarttx_init();
+
     // Initialise LED bar
     s4743527_reg_lta1000g_init();
 
@@ -63,13 +575,52 @@ void rcm_fsm_task(void) {
     s4743527_reg_mfs_ssd_init();
     s4743527_reg_mfs_ssd_clear();
 
+    // Initialise backup SRAM
+    s4743527_reg_bkpsram_init();
+
     S4743527_REG_RGB_BLACK();
 
     taskEXIT_CRITICAL();
 
+    // Load axis limits and step sizes, and bookmarks.
+    s4743527_lib_rcmcont_config_load();
+    s4743527_lib_rcmbookmark_load();
+    s4743527_lib_rcmkeepout_load();
+
+    uint8_t state = JOIN;
+
+    // Position data.
+    RCMData rcm = {0, 0, 0, 1, 0};
+
+    // Resume from the state saved before reset, before the trajectory task
+    // starts from it.
+    RCMRecord record;
+    int restored = 0;
+    if (s4743527_lib_bkpsram_read(&record, sizeof(RCMRecord)) == 0) {
+        rcm = record.rcm;
+        s4743527RcmState = rcm;
+        restored = 1;
+
+        if (record.joined) {
+            state = IDLE;
+        }
+    }
+
+    // Initialise queue for commands.
+    s4743527QueueRcmCommand = xQueueCreate(10, sizeof(RCMCommand));
+
     // Start radio task.
     s4743527_tsk_radio_init();
 
+    // Start trajectory task
+    s4743527_tsk_rcmtraj_init();
+
+    // Start scan task
+    s4743527_tsk_rcmscan_init();
+
+    // Start script task
+    s4743527_tsk_rcmscript_init();
+
     // Start console task
     s4743527_tsk_console_init();
 
@@ -79,37 +630,26 @@ void rcm_fsm_task(void) {
     // Start MFS SSD task
     s4743527_tsk_mfs_ssd_init();
 
-    uint8_t state = JOIN;
+    // Show restored position.
+    if (restored) {
+        rcm_send_display(&rcm, record.joined);
+    }
 
-    // Initialise variables for console input and event bits.
+    // Initialise variable for event bits.
     EventBits_t uxBits;
-    char validInput[25] = INPUT;
-    char keyPressed = EMPTY;
-
-    // Integer form of position data.
-    int xPos = 0;
-    int yPos = 0;
-    int zPos = 0;
-    int zoom = 1;
-    int rotate = 0;
-
-    // ASCII form of position data.
-    char x3;
-    char x2;
-    char x1;
-    char y3;
-    char y2;
-    char y1;
-    char z2;
-    char z1;
-    char zoomAscii;
-    char r3;
-    char r2;
-    char r1;
-
-    // Structs for position data.
-    RCMData displayData;
-    SSDData ssdData;
+
+    // Command received from console.
+    RCMCommand command;
+
+    // Repeats of held key for jogging.
+    JogState jog = {-1, 0, 0};
+
+    // Whether X/Y keys move in the rotated sample frame.
+    int sampleFrame = 0;
+
+    // Past states for undo and redo.
+    RCMHistory history;
+    s4743527_lib_rcmcont_history_init(&history, &rcm);
 
     for (;;) {
 
@@ -120,17 +660,14 @@ void rcm_fsm_task(void) {
                     
                     if (xSemaphoreTake(s4743527SemaphorePushbutton, 10)) {
 
-                        // Form the JOIN packet.
-                        uint8_t uncodedPacket[16] = {0x20, 0x47, 0x43, 0x52, 0x78, 'J', 'O', 'I', 'N',
-                                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+                        rcm_send_join_packet();
+                        rcm_save(&rcm, 1);
 
-                        // Send the packet
-                        xQueueSend(s4743527QueueRadioPacket, (void*) &uncodedPacket, (portTickType) 10);
-
-                        // Reset event group bits if any key was pressed
-                        // before join packet was sent.
+                        // Reset event group bits and commands if any key was
+                        // pressed before join packet was sent.
                         uxBits = xEventGroupClearBits(s4743527GroupEventConsoleInput,
                                 INPUT_EVT_MASK);
+                        xQueueReset(s4743527QueueRcmCommand);
 
                         state = IDLE;
                     }
@@ -139,242 +676,151 @@ void rcm_fsm_task(void) {
             
             case IDLE:
 
+                // Join again if button is pressed, e.g. if the RCM was reset
+                // but the controller resumed.
+                if (s4743527SemaphorePushbutton != NULL && 
+                        xSemaphoreTake(s4743527SemaphorePushbutton, 0)) {
+                    rcm_send_join_packet();
+                }
+
                 // Check event group bits and allow 10ms wait time
                 uxBits = xEventGroupWaitBits(s4743527GroupEventConsoleInput,
                         INPUT_EVT_MASK, pdTRUE, pdFALSE, 10);
 
+                // Keys move from where a target stopped at a keep-out zone.
+                rcm_take_stop(&rcm, &history);
+                RCMData previous = rcm;
+
                 // Check which key was pressed.
-                for (uint8_t i = 0; i < 24; i++) {
+                for (uint8_t i = 0; i < NUM_OF_INPUT_BITS; i++) {
                     if (uxBits & (1 << i)) {
 
-                        keyPressed = validInput[i];
-                        
-                        // Check which type of key press it is.
-                        if ((i <= 17) || (i == 22)) { // Move position
+                        int changed = 0;
+                        int axis;
+                        int distance;
 
-                            // Determine if distance moved should be postive or negative.
-                            int numberType = POSITIVE;
-                            if ((i % 2) == 1) {
-                                numberType = NEGATIVE;
-                            }
-                            
-                            // Determine the distance to move by.
-                            int distance = 0;
-                            if (i <= 5) {
-                                distance = 2;
-                            } else if (i >= 6 && i <= 11) {
-                                distance = 10;
-                            } else if (i >= 12 && i <= 17) {
-                                distance = 50;
-                            }
-
-                            distance *= numberType;
-
-                            // Determine which position (x,y, or z) to move.
-                            switch (keyPressed) {
-                                case 'W':
-                                case 'Q':
-                                case 'A':
-                                case 'S':
-                                case 'Z':
-                                case 'X':
-
-                                    if ((xPos == 200 && distance > 0) ||
-                                            (xPos == 0 && distance < 0)) {
-                                        uxBits &= ~(1 << i);
-                                    }
-
-                                    xPos += distance;
-                                    if (xPos < 0) {
-                                        xPos = 0;
-                                    } else if (xPos > 200){
-                                        xPos = 200;
-                                    }
-                                    break;
-                                
-                                case 'E':
-                                case 'R':
-                                case 'D':
-                                case 'F':
-                                case 'C':
-                                case 'V':
-
-                                    if ((yPos == 200 && distance > 0) ||
-                                            (yPos == 0 && distance < 0)) {
-                                        uxBits &= ~(1 << i);
-                                    }
-
-                                    yPos += distance;
-                                    if (yPos < 0) {
-                                        yPos = 0;
-                                    } else if (yPos > 200){
-                                        yPos = 200;
-                                    }
-                                    break;
-                                
-                                case 'T':
-                                case 'Y':
-                                case 'G':
-                                case 'H':
-                                case 'B':
-                                case 'N':
-
-                                    if ((zPos == 99 && distance > 0) ||
-                                            (zPos == 0 && distance < 0)) {
-                                        uxBits &= ~(1 << i);
-                                    }
-
-                                    zPos += distance;
-                                    if (zPos < 0) {
-                                        zPos = 0;
-                                    } else if (zPos > 99){
-                                        zPos = 99;
-                                    }
-                                    break;
-                                
-                                case '5':
-                                    xPos = 0;
-                                    yPos = 0;
-                                    zPos = 0;
-                                    zoom = 1;
-                                    rotate = 0;
-                                    break;
-
-                                default:
-                                    break;
-                            }
-                        
-                        } else if (i == 18 || i == 19) { // Move zoom
+                        if (i == INPUT_BIT_RESET) { // Reset position to origin
 
-                            int zoomInc = POSITIVE;
-                            if (i == 19) {
-                                zoomInc = NEGATIVE;
+                            for (axis = 0; axis < NUM_OF_AXES; axis++) {
+                                changed |= s4743527_lib_rcmcont_set_axis(
+                                        s4743527_lib_rcmcont_axis(&rcm, axis),
+                                        s4743527RcmConfig.axis[axis].min,
+                                        &s4743527RcmConfig.axis[axis]);
                             }
 
-                            if ((zoom == 1 && zoomInc == NEGATIVE) ||
-                                    (zoom == 9 && zoomInc == POSITIVE)) {
-                                uxBits &= ~(1 << i);
+                        } else {
+
+                            // Determine the axis and distance to move by.
+                            if (i < INPUT_BIT_ZOOM) { // Move position
+                                axis = (i % 6) / 2;
+                                distance = s4743527RcmConfig.axis[axis].step[i / 6];
+
+                                // Only fine keys speed up when held, and
+                                // never past the coarse step.
+                                if ((i / 6) == 0) {
+                                    distance = s4743527_lib_rcmcont_jog_step(&jog, i, 
+                                            s4743527ConsoleInputTicks[i], distance,
+                                            s4743527RcmConfig.axis[axis].step[1]);
+                                }
+                            } else if (i < INPUT_BIT_ROTATE) { // Move zoom
+                                axis = AXIS_ZOOM;
+                                distance = s4743527RcmConfig.axis[axis].step[0];
+                            } else { // Rotate
+                                axis = AXIS_ROTATE;
+                                distance = s4743527RcmConfig.axis[axis].step[0];
                             }
 
-                            zoom += zoomInc;
-                            if (zoom < 1) {
-                                zoom = 1;
-                            } else if (zoom > 9) {
-                                zoom = 9;
+                            // Odd keys move in the negative direction.
+                            if ((i % 2) == 1) {
+                                distance *= NEGATIVE;
                             }
-                        
-                        } else if (i == 20 || i == 21) { // Rotate
 
-                            int rotateType = POSITIVE;
-                            if (i == 21) {
-                                rotateType = NEGATIVE;
+                            if (sampleFrame && (axis == AXIS_X || axis == AXIS_Y)) {
+
+                                // Rotate the move so keys follow the sample.
+                                int x = (axis == AXIS_X) ? distance : 0;
+                                int y = (axis == AXIS_Y) ? distance : 0;
+                                s4743527_lib_rcmcont_frame_transform(rcm.rotate, &x, &y);
+
+                                changed = s4743527_lib_rcmcont_set_axis(&rcm.xPos,
+                                        rcm.xPos + x, &s4743527RcmConfig.axis[AXIS_X]);
+                                changed |= s4743527_lib_rcmcont_set_axis(&rcm.yPos,
+                                        rcm.yPos + y, &s4743527RcmConfig.axis[AXIS_Y]);
+                            } else {
+                                int* value = s4743527_lib_rcmcont_axis(&rcm, axis);
+                                changed = s4743527_lib_rcmcont_set_axis(value, *value + distance,
+                                        &s4743527RcmConfig.axis[axis]);
                             }
+                        }
 
-                            int rotateInc = 10 * rotateType;
-
-                            if ((rotate == 0 && rotateType == NEGATIVE) ||
-                                    (rotate == 180 && rotateType == POSITIVE)) {
-                                uxBits &= ~(1 << i);
-                            }
-                            
-                            rotate += rotateInc;
-                            if (rotate < 0) {
-                                rotate = 0;
-                            } else if (rotate > 180) {
-                                rotate = 180;
-                            }
+                        // Don't send packet if axis is already at its limit.
+                        if (!changed) {
+                            uxBits &= ~(1 << i);
                         }
+
                         state = PACKET;
                     }
                 }
-                break;
-
-            case PACKET:
-                
-                // Get ASCII form of each digit of position data.
-
-                x3 = s4743527_lib_console_dec2ascii(xPos / 100);
-                x2 = s4743527_lib_console_dec2ascii((xPos / 10) % 10);
-                x1 = s4743527_lib_console_dec2ascii(xPos % 10);
-
-                y3 = s4743527_lib_console_dec2ascii(yPos / 100);
-                y2 = s4743527_lib_console_dec2ascii((yPos / 10) % 10);
-                y1 = s4743527_lib_console_dec2ascii(yPos % 10);
-
-                z2 = s4743527_lib_console_dec2ascii((zPos / 10) % 10);
-                z1 = s4743527_lib_console_dec2ascii(zPos % 10);
 
-                zoomAscii = s4743527_lib_console_dec2ascii(zoom);
-
-                r3 = s4743527_lib_console_dec2ascii(rotate / 100);
-                r2 = s4743527_lib_console_dec2ascii((rotate / 10) % 10);
-                r1 = s4743527_lib_console_dec2ascii(rotate % 10);
-
-                // Check which key was pressed.
-                for (uint8_t i = 0; i < 23; i++) {
-                    if (uxBits & (1 << i)) {
-                        
-                        // Check which type of key press it is.
-                        if (i <= 17) { // Position packet
-
-                            uint8_t uncodedPacket[16] = {0x22, 0x47, 0x43, 0x52, 0x78, 'X', 'Y', 'Z', 
-                                    x3, x2, x1, y3, y2, y1, z2, z1};
-
-                            // Send the packet
-                            xQueueSend(s4743527QueueRadioPacket, (void*) &uncodedPacket, (portTickType) 10);
-
-                        } else if (i == 18 || i == 19) { // Zoom packet
-
-                            uint8_t uncodedPacket[16] = {0x25, 0x47, 0x43, 0x52, 0x78, 'Z', 'O', 'O', 'M',
-                                    zoomAscii, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-
-                            // Send the packet
-                            xQueueSend(s4743527QueueRadioPacket, (void*) &uncodedPacket, (portTickType) 10);
-
-                        } else if (i == 20 || i == 21) { // Rotate Packet
+                // Stop moves at the boundary of the first keep-out zone on
+                // the way.
+                if (state == PACKET && s4743527_lib_rcmkeepout_sweep(&previous, &rcm)) {
+                    s4743527KeepoutStats.moves++;
+                }
 
-                            uint8_t uncodedPacket[16] = {0x23, 0x47, 0x43, 0x52, 0x78, 'R', 'O', 'T', 
-                                    r3, r2, r1, 0x00, 0x00, 0x00, 0x00, 0x00};
+                // Move directly to a target received from console, once the
+                // trajectory task has room to queue it and a jog ahead of it.
+                if (state == IDLE && uxQueueSpacesAvailable(s4743527QueueTrajectory) > 1 &&
+                        xQueueReceive(s4743527QueueRcmCommand, &command, 0)) {
+                    if (command.type == RCM_CMD_GOTO || command.type == RCM_CMD_MOVE) {
+                        rcm_goto(&rcm, &command.target, command.axes);
+
+                        // Only moves made by the operator can be undone, not
+                        // each step of a scan or script.
+                        if (command.type == RCM_CMD_GOTO) {
+                            s4743527_lib_rcmcont_history_push(&history, &rcm);
+                        }
 
-                            // Send the packet
-                            xQueueSend(s4743527QueueRadioPacket, (void*) &uncodedPacket, (portTickType) 10);
+                    } else if (command.type == RCM_CMD_KEEP) {
 
-                        } else if (i == 22) { // Reset position to origin
-                            
-                            // Form the 3 packets.
-                            uint8_t uncodedPositionPacket[16] = {0x22, 0x47, 0x43, 0x52, 0x78, 'X', 'Y', 'Z', 
-                                    x3, x2, x1, y3, y2, y1, z2, z1};
-                            uint8_t uncodedZoomPacket[16] = {0x25, 0x47, 0x43, 0x52, 0x78, 'Z', 'O', 'O', 'M',
-                                    zoomAscii, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-                            uint8_t uncodedRotatePacket[16] = {0x23, 0x47, 0x43, 0x52, 0x78, 'R', 'O', 'T', 
-                                    r3, r2, r1, 0x00, 0x00, 0x00, 0x00, 0x00};
+                        // Keep where a scan or script starts, so undo returns
+                        // to it.
+                        rcm_history_keep(&history, &rcm);
 
-                            // Send the 3 packets.
+                    } else if (command.type == RCM_CMD_UNDO || command.type == RCM_CMD_REDO) {
 
-                            xQueueSend(s4743527QueueRadioPacket, (void*) &uncodedRotatePacket, (portTickType) 10);
-                            vTaskDelay(300);
+                        // Keep where a scan or script ended, so undo goes back
+                        // to where it started and redo returns here.
+                        rcm_history_keep(&history, &rcm);
 
-                            xQueueSend(s4743527QueueRadioPacket, (void*) &uncodedZoomPacket, (portTickType) 10);
-                            vTaskDelay(500);
+                        if ((command.type == RCM_CMD_UNDO) ?
+                                s4743527_lib_rcmcont_history_undo(&history, &command.target) :
+                                s4743527_lib_rcmcont_history_redo(&history, &command.target)) {
+                            rcm_goto(&rcm, &command.target, RCM_AXES_ALL);
 
-                            xQueueSend(s4743527QueueRadioPacket, (void*) &uncodedPositionPacket, (portTickType) 10);
+                            // Limits or a keep-out zone may stop short of the
+                            // state, so keep where it actually went.
+                            history.states[history.current] = rcm;
                         }
 
-                        // Send updated position data
-                        displayData.xPos = xPos;
-                        displayData.yPos = yPos;
-                        displayData.zPos = zPos;
-                        displayData.zoom = zoom;
-                        displayData.rotate = rotate;
-                        xQueueSend(s4743527QueueDisplayData, (void*) &displayData, (portTickType) 10);
-
-                        // Send position to MFS SSD task
-                        ssdData.xPos = xPos;
-                        ssdData.yPos = yPos;
-                        ssdData.zPos = zPos;
-                        xQueueSend(s4743527QueueSSD, (void*) &ssdData, (portTickType) 10);
+                    } else if (command.type == RCM_CMD_FRAME) {
+                        sampleFrame = !sampleFrame;
+                        s4743527_lib_uarttx_printf("Moving in %s frame\n\r", 
+                                sampleFrame ? "sample" : "machine");
                     }
                 }
+                break;
+
+            case PACKET:
+
+                // Send the new state once for all keys that moved the RCM.
+                // The trajectory task sends the packets for the parts that
+                // changed, and moves the position back smoothly on a reset.
+                if (uxBits & ((1 << NUM_OF_INPUT_BITS) - 1)) {
+                    s4743527_lib_rcmtraj_send(&rcm, TRAJ_JOG);
+                    rcm_send_display(&rcm, 1);
+                    s4743527_lib_rcmcont_history_push(&history, &rcm);
+                }
 
                 state = IDLE;
                 break;
@@ -8,6 +8,20 @@
  ***************************************************************
  * EXTERNAL FUNCTIONS
  ***************************************************************
+ * s4743527_lib_rcmcont_clamp() - Limits a value to within a range.
+ * s4743527_lib_rcmcont_axis() - Gets the value of an axis.
+ * s4743527_lib_rcmcont_set_axis() - Sets an axis within its limits.
+ * s4743527_lib_rcmcont_config_set() - Sets limits and steps of an axis.
+ * s4743527_lib_rcmcont_config_load() - Loads axis config from flash.
+ * s4743527_lib_rcmcont_config_save() - Saves axis config to flash.
+ * s4743527_lib_rcmcont_history_init() - Initialises position history.
+ * s4743527_lib_rcmcont_history_push() - Adds a state to history.
+ * s4743527_lib_rcmcont_history_undo() - Gets the previous state.
+ * s4743527_lib_rcmcont_history_redo() - Gets the next undone state.
+ * s4743527_lib_rcmcont_jog_step() - Scales step of a repeated key.
+ * s4743527_lib_rcmcont_sin() - Gets the sine of an angle.
+ * s4743527_lib_rcmcont_cos() - Gets the cosine of an angle.
+ * s4743527_lib_rcmcont_frame_transform() - Rotates a move into the sample frame.
  * s4743527_tsk_rcmcont_init() - Initialises the RCM control task.
  *************************************************************** 
  */
@@ -15,6 +29,10 @@
 #ifndef S4743527_RCMCONT_H
 #define S4743527_RCMCONT_H
 
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "s4743527_rcmdisplay.h"
+
 // Task Priority
 #define TASK_RCM_CONT_PRIORITY  (tskIDLE_PRIORITY + 2)
 
@@ -29,7 +47,161 @@
 #define POSITIVE 1
 #define NEGATIVE -1
 
-// Function prototype
+// Default limits of each axis.
+#define X_MIN       0
+#define X_MAX       200
+#define Y_MIN       0
+#define Y_MAX       200
+#define Z_MIN       0
+#define Z_MAX       99
+#define ZOOM_MIN    1
+#define ZOOM_MAX    9
+#define ROTATE_MIN  0
+#define ROTATE_MAX  180
+
+// Axes of the RCM.
+#define AXIS_X      0
+#define AXIS_Y      1
+#define AXIS_Z      2
+#define AXIS_ZOOM   3
+#define AXIS_ROTATE 4
+#define NUM_OF_AXES 5
+
+// Number of step sizes for each axis (small, medium, large).
+#define NUM_OF_STEPS 3
+
+// Largest value of each axis that fits in its packet.
+#define AXIS_PACKET_MAX {999, 999, 99, 9, 999}
+
+// Default limits and step sizes of each axis.
+#define RCM_CONFIG_DEFAULT {{ \
+        {X_MIN, X_MAX, {2, 10, 50}}, \
+        {Y_MIN, Y_MAX, {2, 10, 50}}, \
+        {Z_MIN, Z_MAX, {2, 10, 50}}, \
+        {ZOOM_MIN, ZOOM_MAX, {1, 1, 1}}, \
+        {ROTATE_MIN, ROTATE_MAX, {10, 10, 10}}}}
+
+// Types of commands for RCM control.
+#define RCM_CMD_GOTO    0
+#define RCM_CMD_UNDO    1
+#define RCM_CMD_REDO    2
+#define RCM_CMD_FRAME   3
+#define RCM_CMD_MOVE    4 // Goto from a scan or script, not kept in history
+#define RCM_CMD_KEEP    5 // Keeps the current state in history as a scan or script starts
+
+// Number of states kept in position history.
+#define HISTORY_SIZE    32
+
+// Bit of an axis in the axes moved by a command.
+#define RCM_AXIS_BIT(axis)      (0x01 << (axis))
+
+// Bits of the first count axes, in the order x, y, z, zoom, rotate.
+#define RCM_AXES_FIRST(count)   ((0x01 << (count)) - 1)
+#define RCM_AXES_XYZ            RCM_AXES_FIRST(3)
+#define RCM_AXES_ALL            RCM_AXES_FIRST(NUM_OF_AXES)
+
+// Struct for the limits and step sizes of an axis.
+typedef struct {
+    int min;
+    int max;
+    int step[NUM_OF_STEPS];
+} AxisConfig;
+
+// Struct for the limits and step sizes of all axes.
+typedef struct {
+    AxisConfig axis[NUM_OF_AXES];
+} RCMConfig;
+
+// Multiplier of step size for each repeat of a held key.
+#define JOG_CURVE {1, 1, 2, 2, 3, 4, 5, 6, 8, 10}
+#define JOG_CURVE_LENGTH 10
+
+// Time between repeats of a key that resets the step size (ms).
+#define JOG_TIMEOUT 200
+
+// Fractional bits of sine and cosine (Q14).
+#define TRIG_SHIFT 14
+
+// Struct for tracking repeats of a held key.
+typedef struct {
+    int key;
+    TickType_t lastTick;
+    int repeats;
+} JogState;
+
+// Struct for a ring buffer of past RCM states.
+typedef struct {
+    RCMData states[HISTORY_SIZE];
+    int current; // Index of current state
+    int undoCount; // Number of states before current
+    int redoCount; // Number of undone states after current
+} RCMHistory;
+
+// Struct for RCM state saved in backup SRAM.
+typedef struct {
+    RCMData rcm;
+    int joined;
+} RCMRecord;
+
+// Struct for a command sent to RCM control.
+typedef struct {
+    int type;
+    RCMData target;
+    int axes; // Bits of the axes to move, others keep their value
+} RCMCommand;
+
+// Global variables
+// Handle for queue of commands sent to RCM control.
+extern QueueHandle_t s4743527QueueRcmCommand;
+// Last RCM data sent to the display.
+extern RCMData s4743527RcmState;
+// Limits and step sizes of each axis.
+extern RCMConfig s4743527RcmConfig;
+
+// Function prototypes
+// Limits a value to within a range.
+extern int s4743527_lib_rcmcont_clamp(int value, int min, int max);
+
+// Gets a pointer to the value of an axis in RCM data.
+extern int* s4743527_lib_rcmcont_axis(RCMData* rcm, int axis);
+
+// Sets the value of an axis, limited to its range.
+extern int s4743527_lib_rcmcont_set_axis(int* value, int target, AxisConfig* axis);
+
+// Sets the limits and step sizes of an axis.
+extern int s4743527_lib_rcmcont_config_set(int axis, AxisConfig* config);
+
+// Loads the limits and step sizes of all axes from flash.
+extern void s4743527_lib_rcmcont_config_load(void);
+
+// Saves the limits and step sizes of all axes to flash.
+extern int s4743527_lib_rcmcont_config_save(void);
+
+// Initialises position history with the current state.
+extern void s4743527_lib_rcmcont_history_init(RCMHistory* history, RCMData* rcm);
+
+// Adds a new state to position history.
+extern void s4743527_lib_rcmcont_history_push(RCMHistory* history, RCMData* rcm);
+
+// Gets the state before the current state in position history.
+extern int s4743527_lib_rcmcont_history_undo(RCMHistory* history, RCMData* rcm);
+
+// Gets the state after the current state in position history.
+extern int s4743527_lib_rcmcont_history_redo(RCMHistory* history, RCMData* rcm);
+
+// Scales the step size of a key by how long it has been held.
+extern int s4743527_lib_rcmcont_jog_step(JogState* jog, int key, TickType_t tick,
+        int step, int max);
+
+// Gets the sine of an angle in degrees (Q14).
+extern int s4743527_lib_rcmcont_sin(int degrees);
+
+// Gets the cosine of an angle in degrees (Q14).
+extern int s4743527_lib_rcmcont_cos(int degrees);
+
+// Rotates an X/Y move in the sample frame into the machine frame.
+extern void s4743527_lib_rcmcont_frame_transform(int degrees, int* x, int* y);
+
 // Initialises the RCM control task.
 extern void s4743527_tsk_rcmcont_init(void);
 
@@ -18,7 +18,9 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
-#include "debug_log.h"
+#include "s4743527_uarttx.h"
+#include <stdio.h>
+#include <string.h>
 
 // Global variable
 // Handle for queue that receives rcm data to display.
@@ -26,29 +28,198 @@ QueueHandle_t s4743527QueueDisplayData;
 // Handle for queue that receives key pressed.
 QueueHandle_t s4743527QueueDisplayKey;
 
+// Screen model of the characters shown, with a dirty bit for each cell
+// changed since the last flush.
+static uint8_t screen[DISPLAY_ROWS][DISPLAY_COLUMNS];
+static uint32_t dirty[DISPLAY_ROWS][DISPLAY_ROW_WORDS];
+
+// Bytes waiting to be written to the terminal, and the cursor position
+// they leave it at, with 0 if it is not known.
+static char displayBuffer[DISPLAY_BUFFER_SIZE];
+static int displayLength = 0;
+static int cursorX = 0;
+static int cursorY = 0;
+
 /**
- * Moves the position of the cursor on VT100 display.
+ * Sets a cell of the screen model, marking it dirty if it changed.
  * 
- * xPos: the x coordinate to move the cursor.
- * yPos: the y coordinate to move the cursor.
+ * xPos: the column of the cell, from 1.
+ * yPos: the row of the cell, from 1.
+ * cell: the character, or CELL_HORIZONTAL.
  * 
  * Returns: None
  */
-void display_move_cursor(int xPos, int yPos) {
-    debug_log("\e[%d;%dH", yPos, xPos);
+void display_put(int xPos, int yPos, uint8_t cell) {
+
+    if (xPos < 1 || xPos > DISPLAY_COLUMNS || yPos < 1 || yPos > DISPLAY_ROWS) {
+        return;
+    }
+
+    xPos--;
+    yPos--;
+
+    if (screen[yPos][xPos] != cell) {
+        screen[yPos][xPos] = cell;
+        dirty[yPos][xPos / 32] |= 1UL << (xPos % 32);
+    }
 }
 
 /**
- * Displays text at the specified position in VT100 display.
+ * Sets cells of the screen model to text.
  * 
- * xPos: the x coordinate to move the cursor.
- * yPos: the y coordinate to move the cursor.
- * text: the text to display.
+ * xPos: the column of the first character, from 1.
+ * yPos: the row of the text, from 1.
+ * text: the text, which must be printable ASCII.
  * 
  * Returns: None
  */
-void display_text(int xPos, int yPos, const signed char* text) {
-    debug_log("\e[%d;%dH%s", yPos, xPos, text);
+void display_text(int xPos, int yPos, const char* text) {
+
+    for (int i = 0; text[i] != '\0'; i++) {
+        display_put(xPos + i, yPos, text[i]);
+    }
+}
+
+/**
+ * Sends the bytes waiting in the buffer to the terminal in one write. The
+ * screen model assumes every cell flushed is drawn, so this waits for room
+ * rather than have the bytes dropped.
+ * 
+ * Returns: None
+ */
+void display_write(void) {
+
+    if (displayLength > 0) {
+        if (s4743527_lib_uarttx_free() < displayLength) {
+            s4743527_lib_uarttx_flush(portMAX_DELAY);
+        }
+        s4743527_lib_uarttx_write(displayBuffer, displayLength);
+        displayLength = 0;
+    }
+}
+
+/**
+ * Adds bytes to the buffer, writing it first if they do not fit.
+ * 
+ * bytes: the bytes, ending with a null character.
+ * 
+ * Returns: None
+ */
+void display_add(const char* bytes) {
+
+    int length = strlen(bytes);
+
+    if (displayLength + length > DISPLAY_BUFFER_SIZE) {
+        display_write();
+    }
+
+    memcpy(&displayBuffer[displayLength], bytes, length);
+    displayLength += length;
+}
+
+/**
+ * Gets the bytes that draw a cell.
+ * 
+ * cell: the cell.
+ * text: where a single character is stored.
+ * 
+ * Returns: the bytes, ending with a null character.
+ */
+const char* display_cell_bytes(uint8_t cell, char* text) {
+
+    if (cell == CELL_HORIZONTAL) {
+        return HORIZONTAL_SYMBOL;
+    }
+
+    text[0] = (cell == 0) ? ' ' : cell;
+    text[1] = '\0';
+
+    return text;
+}
+
+/**
+ * Moves the cursor of the terminal with the shortest sequence, by
+ * rewriting the cells between when that is shorter.
+ * 
+ * xPos: the column to move to.
+ * yPos: the row to move to.
+ * 
+ * Returns: None
+ */
+void display_cursor(int xPos, int yPos) {
+
+    char move[16];
+    char text[2];
+    int length;
+    int fill = 0;
+
+    if (xPos == cursorX && yPos == cursorY) {
+        return;
+    }
+
+    if (yPos == cursorY && xPos > cursorX) {
+
+        length = snprintf(move, sizeof(move), "\e[%dC", xPos - cursorX);
+
+        // Count the bytes that rewrite the cells between.
+        for (int x = cursorX; x < xPos && fill <= length; x++) {
+            fill += strlen(display_cell_bytes(screen[yPos - 1][x - 1], text));
+        }
+
+        if (fill <= length) {
+            for (int x = cursorX; x < xPos; x++) {
+                display_add(display_cell_bytes(screen[yPos - 1][x - 1], text));
+            }
+            move[0] = '\0';
+        }
+
+    } else {
+        snprintf(move, sizeof(move), "\e[%d;%dH", yPos, xPos);
+    }
+
+    display_add(move);
+    cursorX = xPos;
+    cursorY = yPos;
+}
+
+/**
+ * Draws the cells changed since the last flush, in as few bytes as
+ * possible, and leaves the cursor at a position. Other tasks also write
+ * to the terminal, so the cursor is not known at the start of a flush.
+ * 
+ * xPos: the column to leave the cursor at.
+ * yPos: the row to leave the cursor at.
+ * 
+ * Returns: None
+ */
+void display_flush(int xPos, int yPos) {
+
+    char text[2];
+    uint32_t bits;
+    int x;
+
+    cursorX = 0;
+    cursorY = 0;
+
+    for (int y = 0; y < DISPLAY_ROWS; y++) {
+        for (int word = 0; word < DISPLAY_ROW_WORDS; word++) {
+
+            // Take the lowest dirty bit each time.
+            for (bits = dirty[y][word]; bits != 0; bits &= bits - 1) {
+                x = (word * 32) + __builtin_ctz(bits);
+                display_cursor(x + 1, y + 1);
+                display_add(display_cell_bytes(screen[y][x], text));
+                cursorX++;
+            }
+            dirty[y][word] = 0;
+        }
+    }
+
+    if (cursorX != 0) {
+        display_cursor(xPos, yPos);
+    }
+
+    display_write();
 }
 
 /**
@@ -58,10 +229,6 @@ void display_text(int xPos, int yPos, const signed char* text) {
  */
 void display_task(void) {
 
-    // Initialise queues
-    s4743527QueueDisplayData = xQueueCreate(10, sizeof(RCMData));
-    s4743527QueueDisplayKey = xQueueCreate(10, sizeof(char));
-
     RCMData data;
     char keyPressed;
 
@@ -71,36 +238,34 @@ void display_task(void) {
 
     S4743527_REG_RGB_BLACK();
 
-    // Clear screen
-    debug_log("\e[2J");
-
-    // Move cursor to top left
-    debug_log("\e[H");
+    // Clear screen, which matches the blank screen model.
+    s4743527_lib_uarttx_printf("\e[2J");
 
-    // Print top and bottom borders
-    for (uint8_t x = 1; x < 104; x++) {
-        display_text(x, 1, HORIZONTAL_SYMBOL);
-        display_text(x, 103, HORIZONTAL_SYMBOL);
+    // Draw top and bottom borders
+    for (uint8_t x = 1; x <= BORDER_SIZE; x++) {
+        display_put(x, 1, CELL_HORIZONTAL);
+        display_put(x, BORDER_SIZE, CELL_HORIZONTAL);
     }
 
-    // Print left and right borders
-    for (uint8_t y = 1; y < 104; y++) {
-        display_text(1, y, VERTICAL_SYMBOL);
-        display_text(103, y, VERTICAL_SYMBOL);
+    // Draw left and right borders
+    for (uint8_t y = 2; y < BORDER_SIZE; y++) {
+        display_put(1, y, VERTICAL_SYMBOL);
+        display_put(BORDER_SIZE, y, VERTICAL_SYMBOL);
     }
 
-    // Print 'key pressed'
-    display_text(110, 50, KEY_PRESSED_MSG);
+    // Draw 'key pressed'
+    display_text(KEY_PRESSED_X, KEY_PRESSED_Y, KEY_PRESSED_MSG);
 
-    // Print initial position
-    display_text(INITIAL_X, INITIAL_Y, RCM_POSITION_SYMBOL);
-    display_move_cursor(INITIAL_X, INITIAL_Y);
+    // Draw initial position
+    display_put(INITIAL_X, INITIAL_Y, RCM_POSITION_SYMBOL);
+    display_flush(INITIAL_X, INITIAL_Y);
 
     for (;;) {
         
         // Receive key pressed from console task and display it.
         if (xQueueReceive(s4743527QueueDisplayKey, &keyPressed, 10)) {
-            debug_log("\e[%d;%dH%c", 50, 123, keyPressed);
+            display_put(KEY_X, KEY_PRESSED_Y, 
+                    (keyPressed >= ' ' && keyPressed <= '~') ? keyPressed : ' ');
         }
 
         // Receive RCM position data.
@@ -110,13 +275,12 @@ void display_task(void) {
             if (data.xPos != oldXPos || data.yPos != oldYPos) {
                 
                 // Replace old position with empty space
-                display_text(INITIAL_X + (oldXPos / 2), INITIAL_Y - (oldYPos / 2), EMPTY_SYMBOL);
-
-                // Print new position in terminal
-                display_text(INITIAL_X + (data.xPos / 2), INITIAL_Y - (data.yPos / 2), RCM_POSITION_SYMBOL);
+                display_put(INITIAL_X + (oldXPos / 2), INITIAL_Y - (oldYPos / 2), 
+                        EMPTY_SYMBOL);
 
-                // Move cursor back to position of rcm.
-                display_move_cursor(INITIAL_X + (data.xPos / 2), INITIAL_Y - (data.yPos / 2));
+                // Draw new position
+                display_put(INITIAL_X + (data.xPos / 2), INITIAL_Y - (data.yPos / 2), 
+                        RCM_POSITION_SYMBOL);
 
                 // Update old position to current position.
                 oldXPos = data.xPos;
@@ -137,6 +301,10 @@ void display_task(void) {
             s4743527_reg_lta1000g_write(data.rotate);
         }
 
+        // Draw everything changed in this pass, leaving the cursor at the
+        // position of the rcm.
+        display_flush(INITIAL_X + (oldXPos / 2), INITIAL_Y - (oldYPos / 2));
+
         vTaskDelay(50);
     }
 }
@@ -148,6 +316,12 @@ void display_task(void) {
  */
 extern void s4743527_tsk_rcmdisplay_init(void) {
 
+    // Initialise queues before task so they can be used straight away.
+    // Each holds only the newest value, which senders overwrite, so the
+    // display never falls behind a burst of keys.
+    s4743527QueueDisplayData = xQueueCreate(1, sizeof(RCMData));
+    s4743527QueueDisplayKey = xQueueCreate(1, sizeof(char));
+
     xTaskCreate((void*) &display_task, (const signed char *) "RCM Display",
             TASK_RCM_DISPLAY_STACK_SIZE, NULL, TASK_RCM_DISPLAY_PRIORITY, NULL);
 }
\ No newline at end of file
@@ -12,33 +12,58 @@
  *************************************************************** 
  */
 
+#ifndef S4743527_RCMDISPLAY_H
+#define S4743527_RCMDISPLAY_H
+
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
 
 // Global variable
-// Handle for queue for position data
+// Handle for queue for newest position data, of length 1
 extern QueueHandle_t s4743527QueueDisplayData;
-// Handle for queue for key pressed
+// Handle for queue for newest key pressed, of length 1
 extern QueueHandle_t s4743527QueueDisplayKey;
 
 // Symbols for borders
 #define HORIZONTAL_SYMBOL "—"
-#define VERTICAL_SYMBOL "|"
+#define VERTICAL_SYMBOL '|'
 
 // Key pressed message for display
 #define KEY_PRESSED_MSG "Key Pressed: "
 
 // Symbol for RCM position
-#define RCM_POSITION_SYMBOL "+"
+#define RCM_POSITION_SYMBOL '+'
 
 // Symbol for empty space
-#define EMPTY_SYMBOL " "
+#define EMPTY_SYMBOL ' '
 
 // Initial x and y positions on display
 #define INITIAL_X 2
 #define INITIAL_Y 102
 
+// Position of key pressed message and key on display
+#define KEY_PRESSED_X 110
+#define KEY_PRESSED_Y 50
+#define KEY_X 123
+
+// Size of the border around the map of positions.
+#define BORDER_SIZE 103
+
+// Size of the screen model, which covers the map and key pressed message.
+// Other reports to the right are written directly.
+#define DISPLAY_COLUMNS 124
+#define DISPLAY_ROWS    BORDER_SIZE
+
+// Words of dirty bits in each row of the screen model.
+#define DISPLAY_ROW_WORDS ((DISPLAY_COLUMNS + 31) / 32)
+
+// Cells that are drawn with a symbol rather than their own character.
+#define CELL_HORIZONTAL 0x01
+
+// Number of bytes sent to the terminal in one write.
+#define DISPLAY_BUFFER_SIZE 512
+
 // Task Priority
 #define TASK_RCM_DISPLAY_PRIORITY  (tskIDLE_PRIORITY + 1)
 
@@ -56,4 +81,6 @@ typedef struct {
 
 // Function Prototype
 // Intialises task for RCM display.
-extern void s4743527_tsk_rcmdisplay_init(void);
\ No newline at end of file
+extern void s4743527_tsk_rcmdisplay_init(void);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,262 @@
+/** 
+ **************************************************************
+ * @file project/s4743527_rcmkeepout.c
+ * @author agent
+ * @date 18102026
+ * @brief Keep-out zones the RCM position must not enter.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4743527_lib_rcmkeepout_load() - Loads keep-out zones from flash.
+ * s4743527_lib_rcmkeepout_add() - Adds a keep-out zone.
+ * s4743527_lib_rcmkeepout_clear() - Removes all keep-out zones.
+ * s4743527_lib_rcmkeepout_get() - Gets a keep-out zone by number.
+ * s4743527_lib_rcmkeepout_blocked() - Checks if a position is blocked.
+ * s4743527_lib_rcmkeepout_sweep() - Stops a path at keep-out zones.
+ *************************************************************** 
+ */
+
+#include "s4743527_rcmkeepout.h"
+#include "s4743527_flash.h"
+#include <stddef.h>
+#include <stdlib.h>
+
+// Global variables
+// Number of paths stopped at keep-out zones.
+KeepoutStats s4743527KeepoutStats;
+
+// All keep-out zones.
+static KeepoutTable keepoutTable;
+
+// Bitmaps of blocked cells for each Z band, with a bit set for each cell
+// that touches a keep-out zone, in use and being compiled. RCM control and
+// the trajectory task read the pointer once per check, so a path is never
+// checked against a bitmap that is partly compiled.
+static uint32_t keepoutMaps[2][KEEPOUT_BANDS][KEEPOUT_CELLS][KEEPOUT_ROW_WORDS];
+static const uint32_t (* volatile keepoutMap)[KEEPOUT_CELLS][KEEPOUT_ROW_WORDS] = keepoutMaps[0];
+
+/**
+ * Compiles the keep-out zones into the bitmap that is not in use, then
+ * switches to it. A cell is blocked if any part of it is inside a zone, so
+ * every free cell is legal.
+ * 
+ * Returns: None
+ */
+void keepout_compile(void) {
+
+    uint32_t (*map)[KEEPOUT_CELLS][KEEPOUT_ROW_WORDS] = 
+            (keepoutMap == keepoutMaps[0]) ? keepoutMaps[1] : keepoutMaps[0];
+
+    for (int band = 0; band < KEEPOUT_BANDS; band++) {
+        for (int row = 0; row < KEEPOUT_CELLS; row++) {
+            for (int word = 0; word < KEEPOUT_ROW_WORDS; word++) {
+                map[band][row][word] = 0;
+            }
+        }
+    }
+
+    for (int i = 0; i < keepoutTable.count; i++) {
+
+        KeepoutZone* zone = &keepoutTable.zones[i];
+
+        // Zones outside the grid are cut to fit.
+        int xMin = s4743527_lib_rcmcont_clamp(zone->xMin, 0, KEEPOUT_GRID_SIZE - 1) / KEEPOUT_CELL_SIZE;
+        int xMax = s4743527_lib_rcmcont_clamp(zone->xMax, 0, KEEPOUT_GRID_SIZE - 1) / KEEPOUT_CELL_SIZE;
+        int yMin = s4743527_lib_rcmcont_clamp(zone->yMin, 0, KEEPOUT_GRID_SIZE - 1) / KEEPOUT_CELL_SIZE;
+        int yMax = s4743527_lib_rcmcont_clamp(zone->yMax, 0, KEEPOUT_GRID_SIZE - 1) / KEEPOUT_CELL_SIZE;
+        int bandMin = s4743527_lib_rcmcont_clamp(zone->zMin, 0, Z_MAX) / KEEPOUT_BAND_SIZE;
+        int bandMax = s4743527_lib_rcmcont_clamp(zone->zMax, 0, Z_MAX) / KEEPOUT_BAND_SIZE;
+
+        for (int band = bandMin; band <= bandMax; band++) {
+            for (int row = yMin; row <= yMax; row++) {
+                for (int cell = xMin; cell <= xMax; cell++) {
+                    map[band][row][cell / 32] |= (1UL << (cell % 32));
+                }
+            }
+        }
+    }
+
+    keepoutMap = (const uint32_t (*)[KEEPOUT_CELLS][KEEPOUT_ROW_WORDS]) map;
+}
+
+/**
+ * Checks if a position is inside a keep-out zone by looking up its cell in
+ * a bitmap. Positions outside the grid are never blocked.
+ * 
+ * map: the bitmap.
+ * x: the x position.
+ * y: the y position.
+ * z: the z position.
+ * 
+ * Returns: 1 if the position is blocked, 0 otherwise.
+ */
+int keepout_map_blocked(const uint32_t (*map)[KEEPOUT_CELLS][KEEPOUT_ROW_WORDS], 
+        int x, int y, int z) {
+
+    if (x < 0 || x >= KEEPOUT_GRID_SIZE || y < 0 || y >= KEEPOUT_GRID_SIZE) {
+        return 0;
+    }
+
+    int band = s4743527_lib_rcmcont_clamp(z, 0, Z_MAX) / KEEPOUT_BAND_SIZE;
+    int row = y / KEEPOUT_CELL_SIZE;
+    int cell = x / KEEPOUT_CELL_SIZE;
+
+    return (map[band][row][cell / 32] >> (cell % 32)) & 1;
+}
+
+/**
+ * Loads keep-out zones saved in flash, or starts with no zones if none are
+ * saved.
+ * 
+ * Returns: None
+ */
+extern void s4743527_lib_rcmkeepout_load(void) {
+
+    if (s4743527_lib_flash_load(FLASH_KEEPOUT_SECTOR, &keepoutTable, 
+            sizeof(KeepoutTable)) != 0 || keepoutTable.count < 0 || 
+            keepoutTable.count > NUM_OF_KEEPOUT_ZONES) {
+        keepoutTable.count = 0;
+    }
+
+    keepout_compile();
+}
+
+/**
+ * Adds a keep-out zone and writes all zones to flash.
+ * 
+ * zone: the zone to add, with each minimum at most its maximum.
+ * 
+ * Returns: 0 if added, -1 otherwise.
+ */
+extern int s4743527_lib_rcmkeepout_add(KeepoutZone* zone) {
+
+    if (keepoutTable.count >= NUM_OF_KEEPOUT_ZONES || zone->xMin > zone->xMax || 
+            zone->yMin > zone->yMax || zone->zMin > zone->zMax) {
+        return -1;
+    }
+
+    keepoutTable.zones[keepoutTable.count++] = *zone;
+    keepout_compile();
+
+    return s4743527_lib_flash_save(FLASH_KEEPOUT_SECTOR, &keepoutTable, 
+            sizeof(KeepoutTable));
+}
+
+/**
+ * Removes all keep-out zones and writes them to flash.
+ * 
+ * Returns: 0 if cleared, -1 otherwise.
+ */
+extern int s4743527_lib_rcmkeepout_clear(void) {
+
+    keepoutTable.count = 0;
+    keepout_compile();
+
+    return s4743527_lib_flash_save(FLASH_KEEPOUT_SECTOR, &keepoutTable, 
+            sizeof(KeepoutTable));
+}
+
+/**
+ * Gets a keep-out zone by its number.
+ * 
+ * number: the zone number.
+ * 
+ * Returns: the zone, or NULL if there is no such zone.
+ */
+extern const KeepoutZone* s4743527_lib_rcmkeepout_get(int number) {
+
+    if (number < 0 || number >= keepoutTable.count) {
+        return NULL;
+    }
+
+    return &keepoutTable.zones[number];
+}
+
+/**
+ * Checks if a position is inside a keep-out zone by looking up its cell in
+ * the bitmap. Positions outside the grid are never blocked.
+ * 
+ * x: the x position.
+ * y: the y position.
+ * z: the z position.
+ * 
+ * Returns: 1 if the position is blocked, 0 otherwise.
+ */
+extern int s4743527_lib_rcmkeepout_blocked(int x, int y, int z) {
+
+    return keepout_map_blocked(keepoutMap, x, y, z);
+}
+
+/**
+ * Scales the distance along one axis of a path by the fraction of steps
+ * taken, rounded to the nearest unit.
+ * 
+ * delta: the total distance along the axis.
+ * step: the number of steps taken.
+ * steps: the number of steps in the path.
+ * 
+ * Returns: the distance moved along the axis.
+ */
+int keepout_scale(int delta, int step, int steps) {
+
+    int scaled = (abs(delta) * step + (steps / 2)) / steps;
+
+    return (delta < 0) ? -scaled : scaled;
+}
+
+/**
+ * Checks the straight path between two positions against the bitmap, one
+ * unit at a time along the longest axis so no cell is skipped, and stops
+ * it at the last free point before it enters a keep-out zone. A path that
+ * starts inside a zone may leave it, but not enter another. Zoom and
+ * rotate are not changed.
+ * 
+ * from: the position the path starts at.
+ * to: the position the path ends at, moved back to the boundary if the
+ *     path is blocked.
+ * 
+ * Returns: 1 if the path was stopped, 0 otherwise.
+ */
+extern int s4743527_lib_rcmkeepout_sweep(const RCMData* from, RCMData* to) {
+
+    int dx = to->xPos - from->xPos;
+    int dy = to->yPos - from->yPos;
+    int dz = to->zPos - from->zPos;
+    int steps = abs(dx);
+
+    if (abs(dy) > steps) {
+        steps = abs(dy);
+    }
+    if (abs(dz) > steps) {
+        steps = abs(dz);
+    }
+
+    const uint32_t (*map)[KEEPOUT_CELLS][KEEPOUT_ROW_WORDS] = keepoutMap;
+    int leaving = keepout_map_blocked(map, from->xPos, from->yPos, from->zPos);
+    int lastX = from->xPos;
+    int lastY = from->yPos;
+    int lastZ = from->zPos;
+
+    for (int step = 1; step <= steps; step++) {
+
+        int x = from->xPos + keepout_scale(dx, step, steps);
+        int y = from->yPos + keepout_scale(dy, step, steps);
+        int z = from->zPos + keepout_scale(dz, step, steps);
+        int blocked = keepout_map_blocked(map, x, y, z);
+
+        if (leaving && !blocked) {
+            leaving = 0;
+        } else if (!leaving && blocked) {
+            to->xPos = lastX;
+            to->yPos = lastY;
+            to->zPos = lastZ;
+            return 1;
+        }
+
+        lastX = x;
+        lastY = y;
+        lastZ = z;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+/** 
+ **************************************************************
+ * @file project/s4743527_rcmkeepout.h
+ * @author agent
+ * @date 18102026
+ * @brief Keep-out zones the RCM position must not enter.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4743527_lib_rcmkeepout_load() - Loads keep-out zones from flash.
+ * s4743527_lib_rcmkeepout_add() - Adds a keep-out zone.
+ * s4743527_lib_rcmkeepout_clear() - Removes all keep-out zones.
+ * s4743527_lib_rcmkeepout_get() - Gets a keep-out zone by number.
+ * s4743527_lib_rcmkeepout_blocked() - Checks if a position is blocked.
+ * s4743527_lib_rcmkeepout_sweep() - Stops a path at keep-out zones.
+ *************************************************************** 
+ */
+
+#ifndef S4743527_RCMKEEPOUT_H
+#define S4743527_RCMKEEPOUT_H
+
+#include <stdint.h>
+#include "s4743527_rcmcont.h"
+
+// Maximum number of keep-out zones.
+#define NUM_OF_KEEPOUT_ZONES 8
+
+// Size of the XY grid covered by keep-out zones, from 0 to X_MAX and Y_MAX.
+// X and Y limits can't be set beyond the grid.
+#define KEEPOUT_GRID_SIZE   (X_MAX + 1)
+
+// Width of each cell of the bitmap in XY and height of each Z band.
+#define KEEPOUT_CELL_SIZE   4
+#define KEEPOUT_BAND_SIZE   10
+
+// Number of cells along X and Y, and number of Z bands.
+#define KEEPOUT_CELLS   ((KEEPOUT_GRID_SIZE + KEEPOUT_CELL_SIZE - 1) / KEEPOUT_CELL_SIZE)
+#define KEEPOUT_BANDS   ((Z_MAX + KEEPOUT_BAND_SIZE) / KEEPOUT_BAND_SIZE)
+
+// Number of 32 bit words in each row of cells.
+#define KEEPOUT_ROW_WORDS   ((KEEPOUT_CELLS + 31) / 32)
+
+// Position of keep-out zone list on display, below the bookmark list.
+#define KEEPOUT_LIST_X  110
+#define KEEPOUT_LIST_Y  64
+
+// Struct for a rectangle that is blocked over a band of Z positions.
+typedef struct {
+    int xMin;
+    int yMin;
+    int xMax;
+    int yMax;
+    int zMin;
+    int zMax;
+} KeepoutZone;
+
+// Struct for all keep-out zones saved in flash.
+typedef struct {
+    int count;
+    KeepoutZone zones[NUM_OF_KEEPOUT_ZONES];
+} KeepoutTable;
+
+// Struct for the number of paths stopped at keep-out zones.
+typedef struct {
+    uint32_t moves; // Targets stopped by RCM control
+    uint32_t setpoints; // Moves stopped by the trajectory task
+} KeepoutStats;
+
+// Global variable
+// Number of paths stopped at keep-out zones.
+extern KeepoutStats s4743527KeepoutStats;
+
+// Function prototypes
+
+// Loads keep-out zones saved in flash.
+extern void s4743527_lib_rcmkeepout_load(void);
+
+// Adds a keep-out zone and writes all zones to flash.
+extern int s4743527_lib_rcmkeepout_add(KeepoutZone* zone);
+
+// Removes all keep-out zones and writes them to flash.
+extern int s4743527_lib_rcmkeepout_clear(void);
+
+// Gets a keep-out zone by its number.
+extern const KeepoutZone* s4743527_lib_rcmkeepout_get(int number);
+
+// Checks if a position is inside a keep-out zone.
+extern int s4743527_lib_rcmkeepout_blocked(int x, int y, int z);
+
+// Stops a straight path at the boundary of the first keep-out zone it enters.
+extern int s4743527_lib_rcmkeepout_sweep(const RCMData* from, RCMData* to);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,491 @@
+/** 
+ **************************************************************
+ * @file project/s4743527_rcmscan.c
+ * @author agent
+ * @date 18102026
+ * @brief Scan task for tiling a sample with the RCM.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4743527_lib_rcmscan_path_init() - Initialises a serpentine scan path.
+ * s4743527_lib_rcmscan_path_next() - Gets next move of a scan path.
+ * s4743527_lib_rcmscan_zstack_plan() - Plans the moves of a Z stack.
+ * s4743527_lib_rcmscan_timelapse_add() - Adds a time-lapse position.
+ * s4743527_lib_rcmscan_timelapse_clear() - Clears time-lapse positions.
+ * s4743527_lib_rcmscan_order() - Orders positions by nearest neighbour.
+ * s4743527_tsk_rcmscan_init() - Initialises task for RCM scan.
+ *************************************************************** 
+ */
+
+#include "s4743527_rcmscan.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "event_groups.h"
+#include "s4743527_uarttx.h"
+
+// Global variables
+// Handle for queue of scans to run.
+QueueHandle_t s4743527QueueScan;
+// Event group for pausing and aborting a scan.
+EventGroupHandle_t s4743527GroupEventScan;
+// Progress and timing of the current or last scan.
+ScanStats s4743527ScanStats;
+
+// Positions visited in each time-lapse cycle.
+static RCMData timelapsePositions[TIMELAPSE_MAX_POSITIONS];
+static int timelapseAxes[TIMELAPSE_MAX_POSITIONS];
+static int timelapseCount = 0;
+
+/**
+ * Initialises a serpentine scan path over a rectangle, starting from the
+ * start corner and moving along x, then stepping y at the end of each row.
+ * 
+ * path: the scan path to initialise.
+ * config: the rectangle, step, z position, and dwell time of the scan.
+ * 
+ * Returns: None
+ */
+extern void s4743527_lib_rcmscan_path_init(ScanPath* path, ScanConfig* config) {
+
+    int swap;
+
+    path->config = *config;
+
+    // Order corners so the scan always moves in the positive direction.
+    if (path->config.xEnd < path->config.xStart) {
+        swap = path->config.xStart;
+        path->config.xStart = path->config.xEnd;
+        path->config.xEnd = swap;
+    }
+    if (path->config.yEnd < path->config.yStart) {
+        swap = path->config.yStart;
+        path->config.yStart = path->config.yEnd;
+        path->config.yEnd = swap;
+    }
+    if (path->config.step < 1) {
+        path->config.step = 1;
+    }
+
+    path->xLast = path->config.xStart + 
+            (((path->config.xEnd - path->config.xStart) / path->config.step) * path->config.step);
+    path->xPos = path->config.xStart;
+    path->yPos = path->config.yStart;
+    path->direction = POSITIVE;
+    path->done = 0;
+}
+
+/**
+ * Gets the next move along a scan path.
+ * 
+ * path: the scan path.
+ * target: set to the next x, y and z position to move to.
+ * 
+ * Returns: 1 if there is a next move, 0 if the scan path is finished.
+ */
+extern int s4743527_lib_rcmscan_path_next(ScanPath* path, RCMData* target) {
+
+    if (path->done) {
+        return 0;
+    }
+
+    target->xPos = path->xPos;
+    target->yPos = path->yPos;
+    target->zPos = path->config.zPos;
+
+    // Move along row, or step to the next row and reverse direction.
+    int nextX = path->xPos + (path->direction * path->config.step);
+
+    if (nextX >= path->config.xStart && nextX <= path->xLast) {
+        path->xPos = nextX;
+    } else {
+        path->yPos += path->config.step;
+        path->direction = -path->direction;
+
+        if (path->yPos > path->config.yEnd) {
+            path->done = 1;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * Plans the z positions of a Z stack, from the start to the end in fixed
+ * steps, limited to the range of the z axis.
+ * 
+ * zStart: the first z position.
+ * zEnd: the last z position.
+ * step: the distance between each z position.
+ * zList: array to store the z positions in.
+ * maxMoves: the maximum number of z positions to store.
+ * 
+ * Returns: the number of z positions stored.
+ */
+extern int s4743527_lib_rcmscan_zstack_plan(int zStart, int zEnd, int step,
+        int* zList, int maxMoves) {
+
+    int count = 0;
+
+    zStart = s4743527_lib_rcmcont_clamp(zStart, s4743527RcmConfig.axis[AXIS_Z].min,
+            s4743527RcmConfig.axis[AXIS_Z].max);
+    zEnd = s4743527_lib_rcmcont_clamp(zEnd, s4743527RcmConfig.axis[AXIS_Z].min,
+            s4743527RcmConfig.axis[AXIS_Z].max);
+
+    if (step < 1) {
+        step = 1;
+    }
+
+    // Sweep down if the end is below the start.
+    if (zEnd < zStart) {
+        step = -step;
+    }
+
+    for (int z = zStart; (step > 0) ? (z <= zEnd) : (z >= zEnd); z += step) {
+
+        if (count == maxMoves) {
+            break;
+        }
+        zList[count++] = z;
+    }
+
+    return count;
+}
+
+/**
+ * Adds a position to visit in each time-lapse cycle.
+ * 
+ * position: the position to add.
+ * axes: bits of the axes of the position to move to.
+ * 
+ * Returns: 0 if added, -1 if the list is full.
+ */
+extern int s4743527_lib_rcmscan_timelapse_add(RCMData* position, int axes) {
+
+    if (timelapseCount == TIMELAPSE_MAX_POSITIONS) {
+        return -1;
+    }
+
+    timelapsePositions[timelapseCount] = *position;
+    timelapseAxes[timelapseCount] = axes;
+    timelapseCount++;
+
+    return 0;
+}
+
+/**
+ * Clears all time-lapse positions.
+ * 
+ * Returns: None
+ */
+extern void s4743527_lib_rcmscan_timelapse_clear(void) {
+    timelapseCount = 0;
+}
+
+/**
+ * Orders positions to visit by repeatedly moving to the nearest position
+ * not yet visited, which keeps the total distance travelled short.
+ * 
+ * start: the position to start from.
+ * positions: the positions to visit.
+ * count: the number of positions (up to TIMELAPSE_MAX_POSITIONS).
+ * order: set to the index of each position in the order to visit them.
+ * 
+ * Returns: None
+ */
+extern void s4743527_lib_rcmscan_order(RCMData* start, RCMData* positions, int count,
+        int* order) {
+
+    uint32_t visited = 0;
+    RCMData* current = start;
+
+    for (int i = 0; i < count; i++) {
+
+        int nearest = -1;
+        int nearestDistance = 0;
+
+        for (int j = 0; j < count; j++) {
+
+            if (visited & (1 << j)) {
+                continue;
+            }
+
+            // Compare squared distances to avoid square roots.
+            int dx = positions[j].xPos - current->xPos;
+            int dy = positions[j].yPos - current->yPos;
+            int dz = positions[j].zPos - current->zPos;
+            int distance = (dx * dx) + (dy * dy) + (dz * dz);
+
+            if (nearest == -1 || distance < nearestDistance) {
+                nearest = j;
+                nearestDistance = distance;
+            }
+        }
+
+        order[i] = nearest;
+        visited |= (1 << nearest);
+        current = &positions[nearest];
+    }
+}
+
+/**
+ * Waits for the dwell time of a move to end, pausing or aborting the scan if
+ * requested. The event group is always checked, so a zero dwell, or a
+ * time-lapse cycle that is already late, can still be paused or aborted.
+ * 
+ * releaseTick: the tick the move was released at.
+ * dwell: the time to stay at the position (ms).
+ * 
+ * Returns: SCAN_RUNNING once the dwell has ended, or SCAN_IDLE if aborted.
+ */
+int scan_dwell(TickType_t releaseTick, TickType_t dwell) {
+
+    EventBits_t uxBits;
+    TickType_t elapsed;
+
+    do {
+
+        elapsed = xTaskGetTickCount() - releaseTick;
+        uxBits = xEventGroupWaitBits(s4743527GroupEventScan, SCAN_EVT_MASK,
+                pdTRUE, pdFALSE, (elapsed < dwell) ? dwell - elapsed : 0);
+
+        if (uxBits & SCAN_EVT_ABORT) {
+            return SCAN_IDLE;
+        }
+
+        if (uxBits & SCAN_EVT_PAUSE) {
+
+            // Wait until resumed or aborted.
+            s4743527ScanStats.state = SCAN_PAUSED;
+            uxBits = xEventGroupWaitBits(s4743527GroupEventScan, SCAN_EVT_MASK,
+                    pdTRUE, pdFALSE, portMAX_DELAY);
+
+            if (uxBits & SCAN_EVT_ABORT) {
+                return SCAN_IDLE;
+            }
+
+            // Restart dwell from when the scan was resumed.
+            s4743527ScanStats.state = SCAN_RUNNING;
+            releaseTick = xTaskGetTickCount();
+        }
+
+    } while ((xTaskGetTickCount() - releaseTick) < dwell);
+
+    return SCAN_RUNNING;
+}
+
+/**
+ * Runs a serpentine scan of a rectangle.
+ * 
+ * config: the scan to run.
+ * 
+ * Returns: None
+ */
+void scan_run_tile(ScanConfig* config) {
+
+    ScanPath path;
+    RCMCommand command;
+    TickType_t releaseTick;
+    int hasMove;
+
+    command.type = RCM_CMD_MOVE;
+    command.axes = RCM_AXES_XYZ;
+    s4743527_lib_rcmscan_path_init(&path, config);
+
+    s4743527ScanStats.totalMoves = 
+            (((path.xLast - path.config.xStart) / path.config.step) + 1) *
+            (((path.config.yEnd - path.config.yStart) / path.config.step) + 1);
+
+    hasMove = s4743527_lib_rcmscan_path_next(&path, &command.target);
+
+    while (hasMove && s4743527ScanStats.state != SCAN_IDLE) {
+
+        // Release the move.
+        xQueueSend(s4743527QueueRcmCommand, (void*) &command, portMAX_DELAY);
+        releaseTick = xTaskGetTickCount();
+        s4743527ScanStats.moves++;
+
+        // Prepare the next move while the dwell time elapses, so
+        // each move is released on time.
+        hasMove = s4743527_lib_rcmscan_path_next(&path, &command.target);
+
+        s4743527ScanStats.state = scan_dwell(releaseTick, config->dwell);
+    }
+}
+
+/**
+ * Runs a Z stack, then returns to the z position it started from.
+ * 
+ * config: the Z stack to run.
+ * 
+ * Returns: None
+ */
+void scan_run_zstack(ScanConfig* config) {
+
+    static int zList[ZSTACK_MAX_MOVES];
+    RCMCommand command;
+    TickType_t releaseTick;
+    int count;
+
+    // Plan all moves before the first is released.
+    count = s4743527_lib_rcmscan_zstack_plan(config->zPos, config->zEnd, config->step,
+            zList, ZSTACK_MAX_MOVES - 1);
+    zList[count++] = s4743527RcmState.zPos;
+
+    s4743527ScanStats.totalMoves = count;
+
+    command.type = RCM_CMD_MOVE;
+    command.axes = RCM_AXIS_BIT(AXIS_Z);
+
+    for (int i = 0; i < count; i++) {
+
+        // Always return to start, even if aborted.
+        if (s4743527ScanStats.state == SCAN_IDLE) {
+            i = count - 1;
+        }
+
+        command.target.zPos = zList[i];
+        xQueueSend(s4743527QueueRcmCommand, (void*) &command, portMAX_DELAY);
+        releaseTick = xTaskGetTickCount();
+        s4743527ScanStats.moves++;
+
+        if (i < count - 1) {
+            s4743527ScanStats.state = scan_dwell(releaseTick, config->dwell);
+        }
+    }
+}
+
+/**
+ * Runs a time-lapse, visiting each time-lapse position once per period and
+ * reporting the time of each cycle and how late it started.
+ * 
+ * config: the time-lapse to run.
+ * 
+ * Returns: None
+ */
+void scan_run_timelapse(ScanConfig* config) {
+
+    static RCMData positions[TIMELAPSE_MAX_POSITIONS];
+    static int axes[TIMELAPSE_MAX_POSITIONS];
+    int order[TIMELAPSE_MAX_POSITIONS];
+    RCMData start = s4743527RcmState;
+    RCMCommand command;
+    TickType_t releaseTick;
+    TickType_t scheduledTick;
+    TickType_t cycleTick;
+    int count;
+
+    // Copy positions so they can be changed while running.
+    count = timelapseCount;
+    for (int i = 0; i < count; i++) {
+        positions[i] = timelapsePositions[i];
+        axes[i] = timelapseAxes[i];
+    }
+
+    if (count == 0) {
+        return;
+    }
+
+    command.type = RCM_CMD_MOVE;
+    s4743527ScanStats.totalMoves = count * config->cycles;
+    s4743527ScanStats.cycles = 0;
+    scheduledTick = xTaskGetTickCount();
+
+    while (s4743527ScanStats.state != SCAN_IDLE &&
+            (config->cycles == 0 || s4743527ScanStats.cycles < config->cycles)) {
+
+        cycleTick = xTaskGetTickCount();
+        s4743527ScanStats.drift = cycleTick - scheduledTick;
+
+        // Order from where the last cycle ended.
+        s4743527_lib_rcmscan_order(&start, positions, count, order);
+
+        for (int i = 0; i < count && s4743527ScanStats.state != SCAN_IDLE; i++) {
+
+            command.target = positions[order[i]];
+            command.axes = axes[order[i]];
+            xQueueSend(s4743527QueueRcmCommand, (void*) &command, portMAX_DELAY);
+            releaseTick = xTaskGetTickCount();
+            s4743527ScanStats.moves++;
+
+            s4743527ScanStats.state = scan_dwell(releaseTick, config->dwell);
+        }
+
+        start = positions[order[count - 1]];
+        s4743527ScanStats.cycleTime = xTaskGetTickCount() - cycleTick;
+        s4743527ScanStats.cycles++;
+
+        // Report cycle timing.
+        s4743527_lib_uarttx_printf("\e[%d;%dHCycle %d: %d ms, drift %d ms   ", SCAN_REPORT_Y + 1, SCAN_REPORT_X,
+                s4743527ScanStats.cycles, (int) s4743527ScanStats.cycleTime,
+                s4743527ScanStats.drift);
+
+        // Wait for the next cycle. If the cycle took longer than the period,
+        // the next cycle starts late and the drift grows.
+        if (s4743527ScanStats.state != SCAN_IDLE) {
+            s4743527ScanStats.state = scan_dwell(scheduledTick, config->period);
+        }
+        scheduledTick += config->period;
+    }
+}
+
+/**
+ * Task for RCM scan which sends each move of a scan to RCM control.
+ * 
+ * Returns: None
+ */
+void scan_task(void) {
+
+    ScanConfig config;
+    RCMCommand keep;
+
+    keep.type = RCM_CMD_KEEP;
+
+    for (;;) {
+
+        // Wait for a scan to run.
+        if (xQueueReceive(s4743527QueueScan, &config, portMAX_DELAY)) {
+
+            xEventGroupClearBits(s4743527GroupEventScan, SCAN_EVT_MASK);
+
+            s4743527ScanStats.state = SCAN_RUNNING;
+            s4743527ScanStats.moves = 0;
+            s4743527ScanStats.startTick = xTaskGetTickCount();
+
+            // Have RCM control keep where the scan starts, so undo returns
+            // to it.
+            xQueueSend(s4743527QueueRcmCommand, (void*) &keep, portMAX_DELAY);
+
+            if (config.type == SCAN_ZSTACK) {
+                scan_run_zstack(&config);
+            } else if (config.type == SCAN_TIMELAPSE) {
+                scan_run_timelapse(&config);
+            } else {
+                scan_run_tile(&config);
+            }
+
+            s4743527ScanStats.elapsed = xTaskGetTickCount() - s4743527ScanStats.startTick;
+            s4743527ScanStats.state = SCAN_IDLE;
+
+            // Report scan timing.
+            s4743527_lib_uarttx_printf("\e[%d;%dHScan: %d/%d moves in %d ms   ", SCAN_REPORT_Y, SCAN_REPORT_X,
+                    s4743527ScanStats.moves, s4743527ScanStats.totalMoves,
+                    (int) s4743527ScanStats.elapsed);
+        }
+    }
+}
+
+/**
+ * Initialises task for RCM scan.
+ * 
+ * Returns: None
+ */
+extern void s4743527_tsk_rcmscan_init(void) {
+
+    // Create queue and event group before task so console can use them.
+    s4743527QueueScan = xQueueCreate(1, sizeof(ScanConfig));
+    s4743527GroupEventScan = xEventGroupCreate();
+
+    xTaskCreate((void*) &scan_task, (const signed char *) "RCM Scan",
+            TASK_RCM_SCAN_STACK_SIZE, NULL, TASK_RCM_SCAN_PRIORITY, NULL);
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+/** 
+ **************************************************************
+ * @file project/s4743527_rcmscan.h
+ * @author agent
+ * @date 18102026
+ * @brief Scan task for tiling a sample with the RCM.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4743527_lib_rcmscan_path_init() - Initialises a serpentine scan path.
+ * s4743527_lib_rcmscan_path_next() - Gets next move of a scan path.
+ * s4743527_lib_rcmscan_zstack_plan() - Plans the moves of a Z stack.
+ * s4743527_lib_rcmscan_timelapse_add() - Adds a time-lapse position.
+ * s4743527_lib_rcmscan_timelapse_clear() - Clears time-lapse positions.
+ * s4743527_lib_rcmscan_order() - Orders positions by nearest neighbour.
+ * s4743527_tsk_rcmscan_init() - Initialises task for RCM scan.
+ *************************************************************** 
+ */
+
+#ifndef S4743527_RCMSCAN_H
+#define S4743527_RCMSCAN_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "event_groups.h"
+#include "s4743527_rcmdisplay.h"
+#include "s4743527_rcmcont.h"
+
+// Task Priority
+#define TASK_RCM_SCAN_PRIORITY  (tskIDLE_PRIORITY + 1)
+
+// Task Stack Allocation
+#define TASK_RCM_SCAN_STACK_SIZE    (configMINIMAL_STACK_SIZE * 5)
+
+// Event group bits for controlling a scan.
+#define SCAN_EVT_PAUSE  (1 << 0)
+#define SCAN_EVT_ABORT  (1 << 1)
+#define SCAN_EVT_MASK   (SCAN_EVT_PAUSE | SCAN_EVT_ABORT)
+
+// Types of scan
+#define SCAN_TILE       0
+#define SCAN_ZSTACK     1
+#define SCAN_TIMELAPSE  2
+
+// Maximum number of moves in a Z stack, including return to start.
+#define ZSTACK_MAX_MOVES    101
+
+// Maximum number of positions visited in a time-lapse.
+#define TIMELAPSE_MAX_POSITIONS 16
+
+// States of a scan
+#define SCAN_IDLE       0
+#define SCAN_RUNNING    1
+#define SCAN_PAUSED     2
+
+// Position of scan report on display
+#define SCAN_REPORT_X   110
+#define SCAN_REPORT_Y   52
+
+// Struct for a scan of a rectangle, a Z stack from zPos to zEnd, or a
+// time-lapse of the time-lapse positions.
+typedef struct {
+    int type;
+    int xStart;
+    int yStart;
+    int xEnd;
+    int yEnd;
+    int step;
+    int zPos;
+    int zEnd;
+    int dwell; // Time to stay at each position (ms)
+    int period; // Time between the start of each time-lapse cycle (ms)
+    int cycles; // Number of time-lapse cycles, or 0 to run until aborted
+} ScanConfig;
+
+// Struct for the position along a scan path.
+typedef struct {
+    ScanConfig config;
+    int xLast; // Last x position on each row
+    int xPos;
+    int yPos;
+    int direction;
+    int done;
+} ScanPath;
+
+// Struct for progress and timing of the current or last scan.
+typedef struct {
+    int state;
+    int moves;
+    int totalMoves;
+    TickType_t startTick;
+    TickType_t elapsed;
+    int cycles; // Time-lapse cycles completed
+    TickType_t cycleTime; // Time to visit all positions in last cycle
+    int drift; // How late the last cycle started (ms)
+} ScanStats;
+
+// Global variables
+// Handle for queue of scans to run.
+extern QueueHandle_t s4743527QueueScan;
+// Event group for pausing and aborting a scan.
+extern EventGroupHandle_t s4743527GroupEventScan;
+// Progress and timing of the current or last scan.
+extern ScanStats s4743527ScanStats;
+
+// Function prototypes
+
+// Initialises a serpentine scan path over a rectangle.
+extern void s4743527_lib_rcmscan_path_init(ScanPath* path, ScanConfig* config);
+
+// Gets the next move along a scan path.
+extern int s4743527_lib_rcmscan_path_next(ScanPath* path, RCMData* target);
+
+// Plans the z positions of a Z stack.
+extern int s4743527_lib_rcmscan_zstack_plan(int zStart, int zEnd, int step,
+        int* zList, int maxMoves);
+
+// Adds a position to visit in each time-lapse cycle.
+extern int s4743527_lib_rcmscan_timelapse_add(RCMData* position, int axes);
+
+// Clears all time-lapse positions.
+extern void s4743527_lib_rcmscan_timelapse_clear(void);
+
+// Orders positions to visit by nearest neighbour.
+extern void s4743527_lib_rcmscan_order(RCMData* start, RCMData* positions, int count,
+        int* order);
+
+// Initialises task for RCM scan.
+extern void s4743527_tsk_rcmscan_init(void);
+
+#endif
\ No newline at end of file
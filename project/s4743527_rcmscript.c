@@ -0,0 +1,430 @@
+/** 
+ **************************************************************
+ * @file project/s4743527_rcmscript.c
+ * @author agent
+ * @date 18102026
+ * @brief Script task for running G-code like motion scripts.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4743527_lib_rcmscript_parser_init() - Initialises a script parser.
+ * s4743527_lib_rcmscript_parse() - Parses the next script character.
+ * s4743527_lib_rcmscript_send() - Sends a command to the script task.
+ * s4743527_tsk_rcmscript_init() - Initialises task for RCM scripts.
+ *************************************************************** 
+ */
+
+#include "s4743527_rcmscript.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "s4743527_uarttx.h"
+
+// Bit for each letter of a word.
+#define WORD(letter) (1UL << ((letter) - 'A'))
+
+// Words that give a position to move to.
+#define AXIS_WORDS (WORD('X') | WORD('Y') | WORD('Z') | WORD('M') | WORD('A'))
+
+// Largest number of digits in a word value.
+#define SCRIPT_MAX_DIGITS 6
+
+// Global variables
+// Handle for lookahead buffer of decoded script commands.
+QueueHandle_t s4743527QueueScript;
+
+// Set while the sender has been told to stop sending.
+static volatile int scriptPaused = 0;
+
+/**
+ * Clears the words read so far, ready for the next line.
+ * 
+ * parser: the script parser.
+ * 
+ * Returns: None
+ */
+void script_line_reset(ScriptParser* parser) {
+
+    parser->letter = 0;
+    parser->words = 0;
+    parser->code = -1;
+    parser->comment = 0;
+    parser->error = 0;
+
+    parser->command.type = SCRIPT_MOVE;
+    parser->command.axes = 0;
+    parser->command.value = 0;
+}
+
+/**
+ * Stores the value of the word being read in the command being decoded.
+ * 
+ * parser: the script parser.
+ * 
+ * Returns: None
+ */
+void script_word_end(ScriptParser* parser) {
+
+    int value = parser->sign * parser->value;
+    char letter = parser->letter;
+
+    if (letter == 0) {
+        return;
+    }
+
+    parser->letter = 0;
+
+    // Each word may only appear once, and only E has no value.
+    if ((parser->words & WORD(letter)) || 
+            ((parser->digits == 0) != (letter == 'E'))) {
+        parser->error = 1;
+        return;
+    }
+
+    parser->words |= WORD(letter);
+
+    switch (letter) {
+        case 'G':
+            parser->code = value;
+            break;
+        case 'X':
+            parser->command.target.xPos = value;
+            parser->command.axes |= RCM_AXIS_BIT(AXIS_X);
+            break;
+        case 'Y':
+            parser->command.target.yPos = value;
+            parser->command.axes |= RCM_AXIS_BIT(AXIS_Y);
+            break;
+        case 'Z':
+            parser->command.target.zPos = value;
+            parser->command.axes |= RCM_AXIS_BIT(AXIS_Z);
+            break;
+        case 'M':
+            parser->command.target.zoom = value;
+            parser->command.axes |= RCM_AXIS_BIT(AXIS_ZOOM);
+            break;
+        case 'A':
+            parser->command.target.rotate = value;
+            parser->command.axes |= RCM_AXIS_BIT(AXIS_ROTATE);
+            break;
+        case 'P':
+        case 'L':
+            parser->command.value = value;
+            break;
+        case 'E':
+        case 'N': // Line numbers are ignored.
+            break;
+        default:
+            parser->error = 1;
+            break;
+    }
+}
+
+/**
+ * Decodes the words read on a line into a command.
+ * 
+ * parser: the script parser.
+ * command: set to the decoded command.
+ * 
+ * Returns: 1 if a command was decoded, 0 if the line was blank, or -1 if
+ * the line was bad.
+ */
+int script_line_end(ScriptParser* parser, ScriptCommand* command) {
+
+    script_word_end(parser);
+
+    // Line numbers do not change the meaning of a line.
+    uint32_t words = parser->words & ~WORD('N');
+    int result = 1;
+
+    if (parser->error) {
+        result = -1;
+
+    } else if (words & WORD('G')) {
+
+        if ((parser->code == 0 || parser->code == 1) && (words & AXIS_WORDS) &&
+                !(words & ~(WORD('G') | AXIS_WORDS))) {
+            parser->command.type = SCRIPT_MOVE;
+        } else if (parser->code == 4 && words == (WORD('G') | WORD('P')) && 
+                parser->command.value >= 0) {
+            parser->command.type = SCRIPT_DWELL;
+        } else {
+            result = -1;
+        }
+
+    } else if (words == WORD('L') && parser->command.value > 0) {
+        parser->command.type = SCRIPT_LOOP;
+
+    } else if (words == WORD('E')) {
+        parser->command.type = SCRIPT_END_LOOP;
+
+    } else if (words != 0 && !(words & ~AXIS_WORDS)) {
+        // Axis words without G move like the last G0.
+        parser->command.type = SCRIPT_MOVE;
+
+    } else if (words != 0) {
+        result = -1;
+
+    } else {
+        result = 0;
+    }
+
+    if (result == 1) {
+        *command = parser->command;
+    } else if (result == -1) {
+        parser->errors++;
+    }
+
+    script_line_reset(parser);
+
+    return result;
+}
+
+/**
+ * Initialises a parser at the start of a script.
+ * 
+ * parser: the script parser.
+ * 
+ * Returns: None
+ */
+extern void s4743527_lib_rcmscript_parser_init(ScriptParser* parser) {
+
+    parser->errors = 0;
+    script_line_reset(parser);
+}
+
+/**
+ * Parses the next character of a script, so lines of any length are decoded
+ * as they arrive without being stored. Each line holds one command made of
+ * words, which are a letter followed by an integer, e.g. G1 X100 Y50. Text
+ * from ; to the end of the line is a comment.
+ * 
+ * parser: the script parser.
+ * character: the next character of the script.
+ * command: set to the decoded command at the end of a line.
+ * 
+ * Returns: 1 if a command was decoded, 0 if more characters are needed, or
+ * -1 if a bad line was skipped.
+ */
+extern int s4743527_lib_rcmscript_parse(ScriptParser* parser, char character,
+        ScriptCommand* command) {
+
+    // Convert lowercase letter to uppercase.
+    if ((character >= 'a') && (character <= 'z')) {
+        character -= 32;
+    }
+
+    if (character == '\r' || character == '\n') {
+        return script_line_end(parser, command);
+    }
+
+    if (parser->comment) {
+        return 0;
+    }
+
+    if (character >= 'A' && character <= 'Z') {
+        script_word_end(parser);
+        parser->letter = character;
+        parser->value = 0;
+        parser->sign = 1;
+        parser->digits = 0;
+
+    } else if (character >= '0' && character <= '9') {
+        if (parser->letter == 0 || parser->digits >= SCRIPT_MAX_DIGITS) {
+            parser->error = 1;
+        } else {
+            parser->value = (parser->value * 10) + (character - '0');
+            parser->digits++;
+        }
+
+    } else if (character == '-') {
+        if (parser->letter == 0 || parser->digits > 0 || parser->sign < 0) {
+            parser->error = 1;
+        } else {
+            parser->sign = -1;
+        }
+
+    } else if (character == ' ' || character == '\t') {
+        script_word_end(parser);
+
+    } else if (character == ';') {
+        script_word_end(parser);
+        parser->comment = 1;
+
+    } else {
+        parser->error = 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Sends a decoded command to the script task, waiting for space rather than
+ * dropping it. The sender is sent XOFF when the lookahead buffer is nearly
+ * full so no more lines arrive than can be buffered.
+ * 
+ * command: the command to send.
+ * 
+ * Returns: None
+ */
+extern void s4743527_lib_rcmscript_send(ScriptCommand* command) {
+
+    int pause = 0;
+    char flow = SCRIPT_XOFF;
+
+    xQueueSend(s4743527QueueScript, (void*) command, portMAX_DELAY);
+
+    taskENTER_CRITICAL();
+    if (!scriptPaused && uxQueueMessagesWaiting(s4743527QueueScript) >= 
+            SCRIPT_LOOKAHEAD - SCRIPT_XOFF_SPACE) {
+        scriptPaused = 1;
+        pause = 1;
+    }
+    taskEXIT_CRITICAL();
+
+    // Flow control waits for room, since a lost XOFF overruns the buffer.
+    if (pause) {
+        s4743527_lib_uarttx_write_wait(&flow, 1);
+    }
+}
+
+/**
+ * Runs a move or dwell command. Moves go through RCM control, so they are
+ * limited and kept out of keep-out zones like any other move.
+ * 
+ * command: the command to run.
+ * 
+ * Returns: None
+ */
+void script_run(ScriptCommand* command) {
+
+    RCMCommand move;
+
+    if (command->type == SCRIPT_MOVE) {
+        move.type = RCM_CMD_MOVE;
+        move.target = command->target;
+        move.axes = command->axes;
+        xQueueSend(s4743527QueueRcmCommand, (void*) &move, portMAX_DELAY);
+
+    } else if (command->type == SCRIPT_DWELL) {
+        vTaskDelay(command->value);
+    }
+}
+
+/**
+ * Task for RCM scripts which runs decoded commands from the lookahead
+ * buffer while the console decodes the lines after them.
+ * 
+ * Returns: None
+ */
+void script_task(void) {
+
+    ScriptCommand command;
+    int resume;
+    char flow = SCRIPT_XON;
+
+    // Body of the current loop, which is run once as it arrives and then
+    // repeated from here. Loops cannot be nested.
+    ScriptCommand loop[SCRIPT_LOOP_LENGTH];
+    int loopLength = 0;
+    int loopCount = 0;
+    int looping = 0;
+
+    int commands = 0;
+    int longLoops = 0;
+    TickType_t startTick = 0;
+    RCMCommand keep;
+
+    keep.type = RCM_CMD_KEEP;
+
+    for (;;) {
+
+        // Let the sender resume once the buffer has drained.
+        resume = 0;
+        taskENTER_CRITICAL();
+        if (scriptPaused && uxQueueMessagesWaiting(s4743527QueueScript) <= 
+                SCRIPT_XON_LEVEL) {
+            scriptPaused = 0;
+            resume = 1;
+        }
+        taskEXIT_CRITICAL();
+
+        // A lost XON would leave the sender paused for good.
+        if (resume) {
+            s4743527_lib_uarttx_write_wait(&flow, 1);
+        }
+
+        xQueueReceive(s4743527QueueScript, &command, portMAX_DELAY);
+
+        // Have RCM control keep where the script starts, so undo returns
+        // to it.
+        if (commands == 0) {
+            startTick = xTaskGetTickCount();
+            xQueueSend(s4743527QueueRcmCommand, (void*) &keep, portMAX_DELAY);
+        }
+
+        switch (command.type) {
+            case SCRIPT_LOOP:
+                looping = 1;
+                loopCount = command.value;
+                loopLength = 0;
+                break;
+
+            case SCRIPT_END_LOOP:
+                if (looping) {
+                    looping = 0;
+
+                    for (int repeat = 1; repeat < loopCount; repeat++) {
+                        for (int i = 0; i < loopLength; i++) {
+                            script_run(&loop[i]);
+                            commands++;
+                        }
+                    }
+                }
+                break;
+
+            case SCRIPT_END:
+                s4743527_lib_uarttx_printf("\e[%d;%dHScript: %d commands, %d bad lines, "
+                        "%d long loops in %d ms   ", SCRIPT_REPORT_Y, SCRIPT_REPORT_X, 
+                        commands, command.value, longLoops,
+                        (int) (xTaskGetTickCount() - startTick));
+                looping = 0;
+                commands = 0;
+                longLoops = 0;
+                break;
+
+            default:
+                if (looping) {
+                    if (loopLength < SCRIPT_LOOP_LENGTH) {
+                        loop[loopLength++] = command;
+                    } else if (loopCount > 1) {
+                        // Too long to repeat, so run the loop once and
+                        // report it now, as the script goes on.
+                        loopCount = 1;
+                        longLoops++;
+                        s4743527_lib_uarttx_printf("\e[%d;%dHScript: loop longer than "
+                                "%d commands runs once   ", SCRIPT_REPORT_Y, 
+                                SCRIPT_REPORT_X, SCRIPT_LOOP_LENGTH);
+                    }
+                }
+
+                script_run(&command);
+                commands++;
+                break;
+        }
+    }
+}
+
+/**
+ * Initialises task for RCM scripts.
+ * 
+ * Returns: None
+ */
+extern void s4743527_tsk_rcmscript_init(void) {
+
+    // Create queue before task so console can use it.
+    s4743527QueueScript = xQueueCreate(SCRIPT_LOOKAHEAD, sizeof(ScriptCommand));
+
+    xTaskCreate((void*) &script_task, (const signed char *) "RCM Script",
+            TASK_RCM_SCRIPT_STACK_SIZE, NULL, TASK_RCM_SCRIPT_PRIORITY, NULL);
+}
\ No newline at end of file
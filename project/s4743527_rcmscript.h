@@ -0,0 +1,107 @@
+/** 
+ **************************************************************
+ * @file project/s4743527_rcmscript.h
+ * @author agent
+ * @date 18102026
+ * @brief Script task for running G-code like motion scripts.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4743527_lib_rcmscript_parser_init() - Initialises a script parser.
+ * s4743527_lib_rcmscript_parse() - Parses the next script character.
+ * s4743527_lib_rcmscript_send() - Sends a command to the script task.
+ * s4743527_tsk_rcmscript_init() - Initialises task for RCM scripts.
+ *************************************************************** 
+ */
+
+#ifndef S4743527_RCMSCRIPT_H
+#define S4743527_RCMSCRIPT_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "s4743527_rcmdisplay.h"
+#include "s4743527_rcmcont.h"
+
+// Task Priority
+#define TASK_RCM_SCRIPT_PRIORITY  (tskIDLE_PRIORITY + 1)
+
+// Task Stack Allocation
+#define TASK_RCM_SCRIPT_STACK_SIZE    (configMINIMAL_STACK_SIZE * 5)
+
+// Key that starts and ends a script. G-code programs use %, but that
+// recalls bookmark 5.
+#define SCRIPT_KEY '~'
+
+// Number of decoded commands buffered ahead of the one running.
+#define SCRIPT_LOOKAHEAD    32
+
+// Free space left in the lookahead buffer when the sender is told to stop,
+// leaving room for lines already being sent.
+#define SCRIPT_XOFF_SPACE   8
+
+// Number of buffered commands when the sender is told to resume.
+#define SCRIPT_XON_LEVEL    8
+
+// Software flow control characters.
+#define SCRIPT_XON  0x11
+#define SCRIPT_XOFF 0x13
+
+// Maximum number of commands in the body of a loop. Longer loops are run
+// once and reported.
+#define SCRIPT_LOOP_LENGTH  32
+
+// Types of script command
+#define SCRIPT_MOVE     0 // G0 or G1 [X x] [Y y] [Z z] [M zoom] [A rotate]
+#define SCRIPT_DWELL    1 // G4 P ms
+#define SCRIPT_LOOP     2 // L count, repeating the lines up to E
+#define SCRIPT_END_LOOP 3 // E
+#define SCRIPT_END      4 // SCRIPT_KEY at the end of the script
+
+// Position of script report on display
+#define SCRIPT_REPORT_X 110
+#define SCRIPT_REPORT_Y 51
+
+// Struct for a decoded script command.
+typedef struct {
+    int type;
+    RCMData target; // Position to move to
+    int axes; // Bits of the axes given, others keep their value
+    int value; // Dwell time (ms), loop count, or number of bad lines at end
+} ScriptCommand;
+
+// Struct for the state of a script being parsed one character at a time.
+typedef struct {
+    char letter; // Letter of the word being read, or 0 between words
+    int value;
+    int sign;
+    int digits;
+    uint32_t words; // Bit set for each letter read on this line
+    int code; // Value of the G word
+    int comment; // Set from ; to the end of the line
+    int error; // Set if this line has a bad word
+    int errors; // Number of bad lines
+    ScriptCommand command;
+} ScriptParser;
+
+// Global variable
+// Handle for lookahead buffer of decoded script commands.
+extern QueueHandle_t s4743527QueueScript;
+
+// Function prototypes
+
+// Initialises a parser at the start of a script.
+extern void s4743527_lib_rcmscript_parser_init(ScriptParser* parser);
+
+// Parses the next character of a script.
+extern int s4743527_lib_rcmscript_parse(ScriptParser* parser, char character,
+        ScriptCommand* command);
+
+// Sends a decoded command to the script task, pausing the sender if the
+// lookahead buffer is nearly full.
+extern void s4743527_lib_rcmscript_send(ScriptCommand* command);
+
+// Initialises task for RCM scripts.
+extern void s4743527_tsk_rcmscript_init(void);
+
+#endif
\ No newline at end of file
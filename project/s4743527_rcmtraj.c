@@ -0,0 +1,402 @@
+/** 
+ **************************************************************
+ * @file project/s4743527_rcmtraj.c
+ * @author agent
+ * @date 18102026
+ * @brief Trajectory task for moving the RCM position smoothly.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4743527_lib_rcmtraj_plan() - Plans a trajectory to a target.
+ * s4743527_lib_rcmtraj_next() - Gets next setpoint of a trajectory.
+ * s4743527_lib_rcmtraj_send() - Sends a target to the trajectory task.
+ * s4743527_tsk_rcmtraj_init() - Initialises task for RCM trajectory.
+ *************************************************************** 
+ */
+
+#include "s4743527_rcmtraj.h"
+#include "s4743527_txradio.h"
+#include "s4743527_console.h"
+#include "s4743527_rcmcont.h"
+#include "s4743527_rcmkeepout.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include <stdlib.h>
+
+// Global variables
+// Handle for queue of waypoints for the RCM.
+QueueHandle_t s4743527QueueTrajectory;
+
+// Handle for mailbox of the latest jog target for the RCM.
+QueueHandle_t s4743527QueueJog;
+
+// Handle for mailbox of the latest target stopped at a keep-out zone.
+QueueHandle_t s4743527QueueTrajStop;
+
+// Trajectory task, woken when a target is sent.
+static TaskHandle_t trajTask = NULL;
+
+/**
+ * Scales the distance moved along one axis by the fraction of the
+ * trajectory travelled, rounded to the nearest unit.
+ * 
+ * delta: the total distance to move along the axis.
+ * travelled: the distance travelled along the trajectory (fixed point).
+ * length: the length of the trajectory (fixed point).
+ * 
+ * Returns: the distance moved along the axis.
+ */
+int traj_scale(int delta, int travelled, int length) {
+
+    int scaled = (abs(delta) * travelled + (length / 2)) / length;
+
+    return (delta < 0) ? -scaled : scaled;
+}
+
+/**
+ * Gets the distance needed to stop from a speed.
+ * 
+ * speed: the speed (fixed point).
+ * 
+ * Returns: the stopping distance (fixed point).
+ */
+int traj_braking(int speed) {
+    return (speed * speed) / (2 * TRAJ_ACCEL);
+}
+
+/**
+ * Plans a trapezoidal trajectory from the current setpoint to a target. The
+ * longest axis follows the velocity profile and the other axes are scaled
+ * so all axes arrive together.
+ * 
+ * A moving trajectory keeps its speed if the target is ahead and far enough
+ * away to stop in. Otherwise it is shortened to stop along its current
+ * path, and the target is planned again once it has stopped.
+ * 
+ * traj: the trajectory to plan, which may be moving.
+ * setpoint: the current setpoint.
+ * target: the target position.
+ * 
+ * Returns: 1 if the trajectory now ends at the target, or 0 if it is
+ * stopping first.
+ */
+extern int s4743527_lib_rcmtraj_plan(Trajectory* traj, RCMData* setpoint, RCMData* target) {
+
+    int delta[3] = {target->xPos - setpoint->xPos, target->yPos - setpoint->yPos,
+            target->zPos - setpoint->zPos};
+    int moving[3] = {traj->end.xPos - traj->start.xPos, traj->end.yPos - traj->start.yPos,
+            traj->end.zPos - traj->start.zPos};
+    int distance = 0;
+    int reverse = 0;
+    int stop;
+
+    for (int i = 0; i < 3; i++) {
+
+        if (abs(delta[i]) > distance) {
+            distance = abs(delta[i]);
+        }
+
+        if ((delta[i] < 0 && moving[i] > 0) || (delta[i] > 0 && moving[i] < 0)) {
+            reverse = 1;
+        }
+    }
+
+    if (traj->speed > 0 && 
+            (reverse || traj_braking(traj->speed) > (distance << TRAJ_FRACTION_BITS))) {
+
+        // Stop as soon as possible along the current path.
+        stop = traj->travelled + traj_braking(traj->speed);
+
+        if (stop < traj->length) {
+            traj->end.xPos = traj->start.xPos + traj_scale(moving[0], stop, traj->length);
+            traj->end.yPos = traj->start.yPos + traj_scale(moving[1], stop, traj->length);
+            traj->end.zPos = traj->start.zPos + traj_scale(moving[2], stop, traj->length);
+            traj->length = stop;
+        }
+
+        return 0;
+    }
+
+    traj->start = *setpoint;
+    traj->end = *target;
+    traj->length = distance << TRAJ_FRACTION_BITS;
+    traj->travelled = 0;
+
+    // Short moves from rest arrive at the first setpoint.
+    if (traj->speed == 0 && distance <= TRAJ_MIN_DISTANCE) {
+        traj->speed = traj->length;
+    }
+
+    return 1;
+}
+
+/**
+ * Gets the next setpoint of a trajectory, accelerating to the maximum speed
+ * then decelerating so it stops at the target.
+ * 
+ * traj: the trajectory.
+ * setpoint: set to the next setpoint.
+ * 
+ * Returns: 1 if there are more setpoints, 0 if the target is reached.
+ */
+extern int s4743527_lib_rcmtraj_next(Trajectory* traj, RCMData* setpoint) {
+
+    int remaining = traj->length - traj->travelled;
+
+    if (traj->speed < traj->length) {
+
+        if (traj_braking(traj->speed) >= remaining) {
+            traj->speed -= TRAJ_ACCEL;
+
+            // Keep moving until the target is reached.
+            if (traj->speed < TRAJ_ACCEL) {
+                traj->speed = TRAJ_ACCEL;
+            }
+        } else if (traj->speed < TRAJ_MAX_SPEED) {
+            traj->speed += TRAJ_ACCEL;
+
+            if (traj->speed > TRAJ_MAX_SPEED) {
+                traj->speed = TRAJ_MAX_SPEED;
+            }
+        }
+    }
+
+    traj->travelled += traj->speed;
+
+    if (traj->travelled >= traj->length) {
+        traj->travelled = traj->length;
+        traj->speed = 0;
+        *setpoint = traj->end;
+        return 0;
+    }
+
+    setpoint->xPos = traj->start.xPos + 
+            traj_scale(traj->end.xPos - traj->start.xPos, traj->travelled, traj->length);
+    setpoint->yPos = traj->start.yPos + 
+            traj_scale(traj->end.yPos - traj->start.yPos, traj->travelled, traj->length);
+    setpoint->zPos = traj->start.zPos + 
+            traj_scale(traj->end.zPos - traj->start.zPos, traj->travelled, traj->length);
+
+    return 1;
+}
+
+/**
+ * Sends a packet with the x, y, and z position of a setpoint. Packets wait
+ * for room in the radio queue, so no setpoint is lost when the radio falls
+ * behind.
+ * 
+ * setpoint: the setpoint to send.
+ * 
+ * Returns: None
+ */
+void traj_send_position_packet(RCMData* setpoint) {
+
+    uint8_t uncodedPacket[16] = {0x22, 0x47, 0x43, 0x52, 0x78, 'X', 'Y', 'Z', 
+            s4743527_lib_console_dec2ascii(setpoint->xPos / 100),
+            s4743527_lib_console_dec2ascii((setpoint->xPos / 10) % 10),
+            s4743527_lib_console_dec2ascii(setpoint->xPos % 10),
+            s4743527_lib_console_dec2ascii(setpoint->yPos / 100),
+            s4743527_lib_console_dec2ascii((setpoint->yPos / 10) % 10),
+            s4743527_lib_console_dec2ascii(setpoint->yPos % 10),
+            s4743527_lib_console_dec2ascii((setpoint->zPos / 10) % 10),
+            s4743527_lib_console_dec2ascii(setpoint->zPos % 10)};
+
+    xQueueSend(s4743527QueueRadioPacket, (void*) &uncodedPacket, portMAX_DELAY);
+}
+
+/**
+ * Sends a packet with the zoom of the RCM.
+ * 
+ * rcm: the RCM data to send.
+ * 
+ * Returns: None
+ */
+void traj_send_zoom_packet(RCMData* rcm) {
+
+    uint8_t uncodedPacket[16] = {0x25, 0x47, 0x43, 0x52, 0x78, 'Z', 'O', 'O', 'M',
+            s4743527_lib_console_dec2ascii(rcm->zoom), 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+    xQueueSend(s4743527QueueRadioPacket, (void*) &uncodedPacket, portMAX_DELAY);
+}
+
+/**
+ * Sends a packet with the rotation of the RCM.
+ * 
+ * rcm: the RCM data to send.
+ * 
+ * Returns: None
+ */
+void traj_send_rotate_packet(RCMData* rcm) {
+
+    uint8_t uncodedPacket[16] = {0x23, 0x47, 0x43, 0x52, 0x78, 'R', 'O', 'T', 
+            s4743527_lib_console_dec2ascii(rcm->rotate / 100),
+            s4743527_lib_console_dec2ascii((rcm->rotate / 10) % 10),
+            s4743527_lib_console_dec2ascii(rcm->rotate % 10),
+            0x00, 0x00, 0x00, 0x00, 0x00};
+
+    xQueueSend(s4743527QueueRadioPacket, (void*) &uncodedPacket, portMAX_DELAY);
+}
+
+/**
+ * Sends the rotation and zoom of a target if they changed, so they are set
+ * in order with the moves queued before it.
+ * 
+ * target: the target being started.
+ * sent: the last rotation and zoom sent, updated to the target.
+ * 
+ * Returns: None
+ */
+void traj_send_optics(RCMData* target, RCMData* sent) {
+
+    if (target->rotate != sent->rotate) {
+        traj_send_rotate_packet(target);
+        sent->rotate = target->rotate;
+    }
+    if (target->zoom != sent->zoom) {
+        traj_send_zoom_packet(target);
+        sent->zoom = target->zoom;
+    }
+}
+
+/**
+ * Sends a target to the trajectory task. A waypoint is queued behind the
+ * others, so none is dropped, and a jog replaces the last jog sent. Each
+ * jog is an absolute target that already includes the moves before it, so
+ * only the latest is needed. A jog not yet taken is queued ahead of a
+ * waypoint sent after it, so the waypoint is still reached last.
+ * 
+ * rcm: the target.
+ * type: TRAJ_JOG or TRAJ_WAYPOINT.
+ * 
+ * Returns: None
+ */
+extern void s4743527_lib_rcmtraj_send(RCMData* rcm, int type) {
+
+    TrajTarget target;
+    TrajTarget jog;
+
+    target.type = type;
+    target.rcm = *rcm;
+
+    if (type == TRAJ_JOG) {
+        xQueueOverwrite(s4743527QueueJog, (void*) &target);
+    } else {
+        if (xQueueReceive(s4743527QueueJog, &jog, 0) == pdTRUE) {
+            xQueueSend(s4743527QueueTrajectory, (void*) &jog, portMAX_DELAY);
+        }
+        xQueueSend(s4743527QueueTrajectory, (void*) &target, portMAX_DELAY);
+    }
+
+    xTaskNotifyGive(trajTask);
+}
+
+/**
+ * Task for RCM trajectory which moves to each queued target in turn,
+ * sending setpoints at a steady rate. The latest jog is taken once no
+ * waypoints are left, and replaces a jog being moved to without stopping
+ * if it can.
+ * 
+ * Returns: None
+ */
+void traj_task(void) {
+
+    Trajectory traj;
+    TrajTarget target;
+    TrajTarget jog;
+    TrajStop stop;
+    int jogged = 0; // A jog was taken but is not yet being moved to
+    RCMData setpoint = s4743527RcmState;
+    RCMData sent = s4743527RcmState;
+    TickType_t lastWake;
+    int moving = 0;
+
+    traj.start = setpoint;
+    traj.end = setpoint;
+    traj.length = 0;
+    traj.travelled = 0;
+    traj.speed = 0;
+
+    for (;;) {
+
+        if (!moving) {
+
+            // Wait for a target, then send the first setpoint straight away.
+            // A jog already taken was sent before any queued waypoint.
+            if (jogged) {
+                target = jog;
+                jogged = 0;
+            } else {
+                while (xQueueReceive(s4743527QueueTrajectory, &target, 0) != pdTRUE &&
+                        xQueueReceive(s4743527QueueJog, &target, 0) != pdTRUE) {
+                    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+                }
+            }
+
+            s4743527_lib_rcmtraj_plan(&traj, &setpoint, &target.rcm);
+            traj_send_optics(&target.rcm, &sent);
+            lastWake = xTaskGetTickCount();
+
+            // Targets that only change zoom or rotation don't move.
+            if (traj.length == 0) {
+                continue;
+            }
+
+        } else {
+
+            vTaskDelayUntil(&lastWake, TRAJ_PERIOD);
+
+            // Replan from the current setpoint for the latest jog while
+            // moving to a jog. Waypoints wait until the current move ends,
+            // and a jog is only taken once none are queued ahead of it.
+            if (target.type == TRAJ_JOG &&
+                    uxQueueMessagesWaiting(s4743527QueueTrajectory) == 0 &&
+                    xQueueReceive(s4743527QueueJog, &jog, 0) == pdTRUE) {
+                jogged = 1;
+            }
+
+            if (jogged && s4743527_lib_rcmtraj_plan(&traj, &setpoint, &jog.rcm)) {
+                target = jog;
+                jogged = 0;
+                traj_send_optics(&target.rcm, &sent);
+            }
+        }
+
+        RCMData previous = setpoint;
+        moving = s4743527_lib_rcmtraj_next(&traj, &setpoint);
+
+        // A jog replanned during a move takes a path RCM control did not
+        // check, so stop at the boundary of any keep-out zone it enters,
+        // and tell RCM control where the target was stopped.
+        if (s4743527_lib_rcmkeepout_sweep(&previous, &setpoint)) {
+            s4743527KeepoutStats.setpoints++;
+            stop.target = target.rcm;
+            stop.stopped = setpoint;
+            xQueueOverwrite(s4743527QueueTrajStop, &stop);
+            traj.start = setpoint;
+            traj.end = setpoint;
+            traj.length = 0;
+            traj.travelled = 0;
+            traj.speed = 0;
+            moving = 0;
+        }
+
+        traj_send_position_packet(&setpoint);
+    }
+}
+
+/**
+ * Initialises task for RCM trajectory.
+ * 
+ * Returns: None
+ */
+extern void s4743527_tsk_rcmtraj_init(void) {
+
+    // Create queues before task so RCM control can use them.
+    s4743527QueueTrajectory = xQueueCreate(TRAJ_QUEUE_LENGTH, sizeof(TrajTarget));
+    s4743527QueueJog = xQueueCreate(1, sizeof(TrajTarget));
+    s4743527QueueTrajStop = xQueueCreate(1, sizeof(TrajStop));
+
+    xTaskCreate((void*) &traj_task, (const signed char *) "RCM Trajectory",
+            TASK_RCM_TRAJ_STACK_SIZE, NULL, TASK_RCM_TRAJ_PRIORITY, &trajTask);
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+/** 
+ **************************************************************
+ * @file project/s4743527_rcmtraj.h
+ * @author agent
+ * @date 18102026
+ * @brief Trajectory task for moving the RCM position smoothly.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4743527_lib_rcmtraj_plan() - Plans a trajectory to a target.
+ * s4743527_lib_rcmtraj_next() - Gets next setpoint of a trajectory.
+ * s4743527_lib_rcmtraj_send() - Sends a target to the trajectory task.
+ * s4743527_tsk_rcmtraj_init() - Initialises task for RCM trajectory.
+ *************************************************************** 
+ */
+
+#ifndef S4743527_RCMTRAJ_H
+#define S4743527_RCMTRAJ_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "s4743527_rcmdisplay.h"
+
+// Task Priority
+#define TASK_RCM_TRAJ_PRIORITY  (tskIDLE_PRIORITY + 2)
+
+// Task Stack Allocation
+#define TASK_RCM_TRAJ_STACK_SIZE    (configMINIMAL_STACK_SIZE * 3)
+
+// Number of fractional bits in fixed point values.
+#define TRAJ_FRACTION_BITS  8
+
+// Time between setpoints (ms).
+#define TRAJ_PERIOD         20
+
+// Maximum speed (units per period) and acceleration (units per period 
+// squared) in fixed point.
+#define TRAJ_MAX_SPEED      (8 << TRAJ_FRACTION_BITS)
+#define TRAJ_ACCEL          (1 << TRAJ_FRACTION_BITS)
+
+// Moves up to this distance from rest are sent as a single setpoint.
+#define TRAJ_MIN_DISTANCE   10
+
+// Number of waypoints queued behind the current move.
+#define TRAJ_QUEUE_LENGTH   16
+
+// Types of trajectory targets.
+#define TRAJ_WAYPOINT   0 // Reached and stopped at before the next target
+#define TRAJ_JOG        1 // Replaces the last jog, taken once no waypoints are left
+
+// Struct for a target sent to the trajectory task.
+typedef struct {
+    int type;
+    RCMData rcm;
+} TrajTarget;
+
+// Struct for a target stopped at a keep-out zone, and where it stopped.
+typedef struct {
+    RCMData target;
+    RCMData stopped;
+} TrajStop;
+
+// Struct for a trapezoidal trajectory between two positions.
+typedef struct {
+    RCMData start;
+    RCMData end;
+    int length; // Distance along the longest axis (fixed point)
+    int travelled; // Distance moved so far (fixed point)
+    int speed; // Distance moved per period (fixed point)
+} Trajectory;
+
+// Global variables
+// Handle for queue of waypoints for the RCM.
+extern QueueHandle_t s4743527QueueTrajectory;
+
+// Handle for mailbox of the latest jog target for the RCM.
+extern QueueHandle_t s4743527QueueJog;
+
+// Handle for mailbox of the latest target stopped at a keep-out zone.
+extern QueueHandle_t s4743527QueueTrajStop;
+
+// Function prototypes
+
+// Plans a trajectory from the current setpoint to a target.
+extern int s4743527_lib_rcmtraj_plan(Trajectory* traj, RCMData* setpoint, RCMData* target);
+
+// Gets the next setpoint of a trajectory.
+extern int s4743527_lib_rcmtraj_next(Trajectory* traj, RCMData* setpoint);
+
+// Sends a waypoint or jog target to the trajectory task.
+extern void s4743527_lib_rcmtraj_send(RCMData* rcm, int type);
+
+// Initialises task for RCM trajectory.
+extern void s4743527_tsk_rcmtraj_init(void);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,63 @@
+/** 
+ **************************************************************
+ * @file project/sim/FreeRTOSConfig.h
+ * @author agent
+ * @date 18102026
+ * @brief FreeRTOS config for the host simulation build on the POSIX port.
+ * REFERENCE: https://www.freertos.org/FreeRTOS-simulator-for-Linux.html
+ ***************************************************************
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <assert.h>
+#include <stdint.h>
+
+// Same kernel features and tick rate as project/FreeRTOSConfig.h, so tasks
+// behave and time the same as on the board.
+#define configCOMMAND_INT_MAX_OUTPUT_SIZE   100
+#define configUSE_PREEMPTION                1
+#define configUSE_IDLE_HOOK                 0
+#define configUSE_TICK_HOOK                 0
+#define configTICK_RATE_HZ                  ((TickType_t) 1000)
+#define configMAX_PRIORITIES                (7)
+#define configMAX_TASK_NAME_LEN             (16)
+#define configUSE_TRACE_FACILITY            1
+#define configUSE_16_BIT_TICKS              0
+#define configIDLE_SHOULD_YIELD             1
+#define configUSE_QUEUE_SETS                1
+#define configUSE_MUTEXES                   1
+#define configQUEUE_REGISTRY_SIZE           8
+#define configCHECK_FOR_STACK_OVERFLOW      0
+#define configUSE_RECURSIVE_MUTEXES         1
+#define configUSE_MALLOC_FAILED_HOOK        0
+#define configUSE_APPLICATION_TASK_TAG      0
+#define configUSE_COUNTING_SEMAPHORES       1
+#define configGENERATE_RUN_TIME_STATS       0
+#define configUSE_CO_ROUTINES               0
+#define configUSE_TIMERS                    0
+#define configENABLE_BACKWARD_COMPATIBILITY 1
+
+// Each task is a pthread, which needs a larger stack than on the board.
+#define configMINIMAL_STACK_SIZE            ((uint16_t) 2048)
+#define configSTACK_DEPTH_TYPE              uint32_t
+
+// Tasks are allocated with malloc (heap_3.c), so this is not used.
+#define configTOTAL_HEAP_SIZE               ((size_t) (75 * 1024))
+
+#define INCLUDE_vTaskPrioritySet            1
+#define INCLUDE_uxTaskPriorityGet           1
+#define INCLUDE_vTaskDelete                 1
+#define INCLUDE_vTaskCleanUpResources       0
+#define INCLUDE_vTaskSuspend                1
+#define INCLUDE_vTaskDelayUntil             1
+#define INCLUDE_vTaskDelay                  1
+#define INCLUDE_xTaskGetSchedulerState      1
+#define INCLUDE_xTaskGetHandle              1
+#define INCLUDE_xTaskGetCurrentTaskHandle   1
+#define INCLUDE_uxTaskGetStackHighWaterMark 1
+
+#define configASSERT(x) assert(x)
+
+#endif
\ No newline at end of file
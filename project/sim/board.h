@@ -0,0 +1,51 @@
+/** 
+ **************************************************************
+ * @file project/sim/board.h
+ * @author agent
+ * @date 18102026
+ * @brief Simulated board support for the host simulation build.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * BRD_debuguart_init() - Sets up the terminal as the debug UART.
+ *************************************************************** 
+ */
+
+#ifndef SIM_BOARD_H
+#define SIM_BOARD_H
+
+#include "processor_hal.h"
+
+// Key that presses the USER pushbutton (Ctrl+B).
+#define SIM_BUTTON_KEY 0x02
+
+// Environment variable naming a trace from R DUMP to replay as input.
+#define SIM_TRACE_ENV "RCMSIM_TRACE"
+
+// Maximum number of keys in a replayed trace.
+#define SIM_TRACE_LENGTH 4096
+
+// Line rate of the debug UART, with 10 bits sent for each byte.
+#define SIM_UART_BAUD   115200
+#define SIM_UART_BITS   10
+
+// Most ticks of line time received at once when the host stalls the
+// simulation. Longer stalls pause the line, as no task could have taken
+// the bytes in them.
+#define SIM_UART_CATCHUP    4
+
+// Number of bytes queued by tests that are not yet received.
+#define SIM_UART_INPUT_SIZE 16384
+
+// Task Priority, above the firmware so bytes arrive as an interrupt would.
+#define TASK_SIM_UART_PRIORITY  (configMAX_PRIORITIES - 1)
+
+// Task Stack Allocation
+#define TASK_SIM_UART_STACK_SIZE    (configMINIMAL_STACK_SIZE * 2)
+
+// Function prototypes
+
+// Sets up stdin as the debug UART receiver, and loads a trace to replay.
+extern void BRD_debuguart_init(void);
+
+#endif
\ No newline at end of file
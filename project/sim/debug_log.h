@@ -0,0 +1,27 @@
+/** 
+ **************************************************************
+ * @file project/sim/debug_log.h
+ * @author agent
+ * @date 18102026
+ * @brief Simulated debug UART output for the host simulation build.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * debug_log() - Writes formatted text to stdout.
+ * sim_uart_send() - Sends bytes on the debug UART as DMA would.
+ *************************************************************** 
+ */
+
+#ifndef SIM_DEBUG_LOG_H
+#define SIM_DEBUG_LOG_H
+
+// Function prototypes
+
+// Writes formatted text, including VT100 sequences, to stdout.
+extern int debug_log(const char* format, ...);
+
+// Sends bytes on the debug UART at its line rate, then raises the DMA
+// interrupt, as the transmit DMA stream does on the board.
+extern void sim_uart_send(const char* data, int length);
+
+#endif
\ No newline at end of file
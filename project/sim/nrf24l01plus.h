@@ -0,0 +1,31 @@
+/** 
+ **************************************************************
+ * @file project/sim/nrf24l01plus.h
+ * @author agent
+ * @date 18102026
+ * @brief Simulated nRF24L01+ radio for the host simulation build.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * nrf24l01plus_init() - Initialises the simulated radio.
+ * nrf24l01plus_send() - Logs a radio frame to stderr.
+ *************************************************************** 
+ */
+
+#ifndef SIM_NRF24L01PLUS_H
+#define SIM_NRF24L01PLUS_H
+
+#include <stdint.h>
+
+// Number of bytes in a radio frame.
+#define SIM_RADIO_FRAME_SIZE 32
+
+// Function prototypes
+
+// Initialises the simulated radio.
+extern void nrf24l01plus_init(void);
+
+// Logs a Hamming encoded radio frame and its decoded packet to stderr.
+extern void nrf24l01plus_send(uint8_t* frame);
+
+#endif
\ No newline at end of file
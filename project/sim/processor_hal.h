@@ -0,0 +1,194 @@
+/** 
+ **************************************************************
+ * @file project/sim/processor_hal.h
+ * @author agent
+ * @date 18102026
+ * @brief Simulated STM32F429 registers for the host simulation build.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * HAL_Init() - Initialises the simulated board.
+ * HAL_NVIC_SetPriority() - Sets an interrupt priority (ignored).
+ * HAL_NVIC_EnableIRQ() - Enables an interrupt (ignored).
+ * NVIC_ClearPendingIRQ() - Clears a pending interrupt (ignored).
+ *************************************************************** 
+ */
+
+#ifndef SIM_PROCESSOR_HAL_H
+#define SIM_PROCESSOR_HAL_H
+
+#include <stdint.h>
+
+// Peripherals are plain structs in RAM, so the register drivers run
+// unchanged and their outputs can be read back by the simulation.
+typedef struct {
+    volatile uint32_t MODER;
+    volatile uint32_t OTYPER;
+    volatile uint32_t OSPEEDR;
+    volatile uint32_t PUPDR;
+    volatile uint32_t IDR;
+    volatile uint32_t ODR;
+    volatile uint32_t BSRR;
+    volatile uint32_t LCKR;
+    volatile uint32_t AFR[2];
+} GPIO_TypeDef;
+
+typedef struct {
+    volatile uint32_t CR1;
+    volatile uint32_t CR2;
+    volatile uint32_t SMCR;
+    volatile uint32_t DIER;
+    volatile uint32_t SR;
+    volatile uint32_t EGR;
+    volatile uint32_t CCMR1;
+    volatile uint32_t CCMR2;
+    volatile uint32_t CCER;
+    volatile uint32_t CNT;
+    volatile uint32_t PSC;
+    volatile uint32_t ARR;
+    volatile uint32_t RCR;
+    volatile uint32_t CCR1;
+    volatile uint32_t CCR2;
+    volatile uint32_t CCR3;
+    volatile uint32_t CCR4;
+    volatile uint32_t BDTR;
+} TIM_TypeDef;
+
+typedef struct {
+    volatile uint32_t IMR;
+    volatile uint32_t EMR;
+    volatile uint32_t RTSR;
+    volatile uint32_t FTSR;
+    volatile uint32_t SWIER;
+    volatile uint32_t PR;
+} EXTI_TypeDef;
+
+typedef struct {
+    volatile uint32_t MEMRMP;
+    volatile uint32_t PMC;
+    volatile uint32_t EXTICR[4];
+} SYSCFG_TypeDef;
+
+typedef struct {
+    volatile uint32_t AHB1ENR;
+    volatile uint32_t APB1ENR;
+    volatile uint32_t APB2ENR;
+} RCC_TypeDef;
+
+typedef struct {
+    volatile uint32_t CR;
+    volatile uint32_t CSR;
+} PWR_TypeDef;
+
+typedef struct {
+    volatile uint32_t ACR;
+    volatile uint32_t KEYR;
+    volatile uint32_t OPTKEYR;
+    volatile uint32_t SR;
+    volatile uint32_t CR;
+    volatile uint32_t OPTCR;
+} FLASH_TypeDef;
+
+typedef struct {
+    volatile uint32_t SR;
+    volatile uint32_t DR;
+    volatile uint32_t BRR;
+    volatile uint32_t CR1;
+    volatile uint32_t CR2;
+    volatile uint32_t CR3;
+    volatile uint32_t GTPR;
+} USART_TypeDef;
+
+// Simulated peripherals
+extern GPIO_TypeDef simGpio[7];
+extern TIM_TypeDef simTim1;
+extern EXTI_TypeDef simExti;
+extern SYSCFG_TypeDef simSyscfg;
+extern RCC_TypeDef simRcc;
+extern PWR_TypeDef simPwr;
+extern FLASH_TypeDef simFlash;
+extern USART_TypeDef simUsart3;
+extern uint32_t SystemCoreClock;
+
+#define GPIOA   (&simGpio[0])
+#define GPIOB   (&simGpio[1])
+#define GPIOC   (&simGpio[2])
+#define GPIOD   (&simGpio[3])
+#define GPIOE   (&simGpio[4])
+#define GPIOF   (&simGpio[5])
+#define GPIOG   (&simGpio[6])
+#define TIM1    (&simTim1)
+#define EXTI    (&simExti)
+#define SYSCFG  (&simSyscfg)
+#define RCC     (&simRcc)
+#define PWR     (&simPwr)
+#define FLASH   (&simFlash)
+#define USART3  (&simUsart3)
+
+// Clocks are always on.
+#define __GPIOA_CLK_ENABLE()
+#define __GPIOB_CLK_ENABLE()
+#define __GPIOC_CLK_ENABLE()
+#define __GPIOD_CLK_ENABLE()
+#define __GPIOE_CLK_ENABLE()
+#define __GPIOF_CLK_ENABLE()
+#define __GPIOG_CLK_ENABLE()
+#define __TIM1_CLK_ENABLE()
+
+// Register bits used by the drivers.
+#define GPIO_AF1_TIM1           0x01
+#define TIM_CR1_CEN             (1UL << 0)
+#define TIM_CR1_DIR             (1UL << 4)
+#define TIM_CR1_ARPE            (1UL << 7)
+#define TIM_CCMR1_OC1CE         (1UL << 7)
+#define TIM_CCMR1_OC1M          (7UL << 4)
+#define TIM_CCMR1_OC1M_1        (1UL << 5)
+#define TIM_CCMR1_OC1M_2        (1UL << 6)
+#define TIM_CCMR1_OC1PE         (1UL << 3)
+#define TIM_CCER_CC1E           (1UL << 0)
+#define TIM_CCER_CC1P           (1UL << 1)
+#define TIM_CCER_CC1NE          (1UL << 2)
+#define TIM_BDTR_OSSI           (1UL << 10)
+#define TIM_BDTR_OSSR           (1UL << 11)
+#define TIM_BDTR_MOE            (1UL << 15)
+#define EXTI_IMR_IM13           (1UL << 13)
+#define EXTI_RTSR_TR13          (1UL << 13)
+#define EXTI_FTSR_TR13          (1UL << 13)
+#define EXTI_PR_PR13            (1UL << 13)
+#define SYSCFG_EXTICR4_EXTI13   (0xFUL << 4)
+#define SYSCFG_EXTICR4_EXTI13_PC (0x2UL << 4)
+#define RCC_APB2ENR_SYSCFGEN    (1UL << 14)
+#define RCC_APB1ENR_PWREN       (1UL << 28)
+#define RCC_AHB1ENR_BKPSRAMEN   (1UL << 18)
+#define PWR_CR_DBP              (1UL << 8)
+#define PWR_CSR_BRR             (1UL << 3)
+#define PWR_CSR_BRE             (1UL << 9)
+#define FLASH_SR_WRPERR         (1UL << 4)
+#define FLASH_SR_PGAERR         (1UL << 5)
+#define FLASH_SR_PGPERR         (1UL << 6)
+#define FLASH_SR_PGSERR         (1UL << 7)
+#define FLASH_SR_BSY            (1UL << 16)
+#define FLASH_CR_PG             (1UL << 0)
+#define FLASH_CR_SER            (1UL << 1)
+#define FLASH_CR_SNB            (0x1FUL << 3)
+#define FLASH_CR_PSIZE          (3UL << 8)
+#define FLASH_CR_PSIZE_1        (2UL << 8)
+#define FLASH_CR_STRT           (1UL << 16)
+#define FLASH_CR_LOCK           (1UL << 31)
+#define USART_SR_ORE            (1UL << 3)
+#define USART_SR_RXNE           (1UL << 5)
+#define USART_CR1_RXNEIE        (1UL << 5)
+
+// Interrupts
+typedef enum {
+    USART3_IRQn = 39,
+    EXTI15_10_IRQn = 40
+} IRQn_Type;
+
+// Function prototypes
+extern void HAL_Init(void);
+extern void HAL_NVIC_SetPriority(IRQn_Type irq, uint32_t priority, uint32_t subPriority);
+extern void HAL_NVIC_EnableIRQ(IRQn_Type irq);
+extern void NVIC_ClearPendingIRQ(IRQn_Type irq);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,77 @@
+/**
+ **************************************************************
+ * @file project/sim/sim.h
+ * @author agent
+ * @date 18102026
+ * @brief Hooks for tests and harnesses to drive and watch the simulation.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * sim_button_press() - Presses and releases the USER pushbutton.
+ * sim_output_hook() - Sets a function called with all UART output.
+ * sim_uart_input() - Queues bytes to be received by the debug UART.
+ * sim_uart_pending() - Gets the number of queued bytes not yet received.
+ * sim_uart_key_count() - Gets the number of bytes received.
+ * sim_uart_key_get() - Gets a byte received.
+ * sim_radio_frame_count() - Gets the number of radio frames sent.
+ * sim_radio_frame_get() - Gets a radio frame sent.
+ ***************************************************************
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+
+// Number of bytes in a decoded radio packet.
+#define SIM_RADIO_PACKET_SIZE   16
+
+// Maximum number of radio frames kept for tests.
+#define SIM_RADIO_LOG_LENGTH    8192
+
+// Maximum number of received bytes kept for tests.
+#define SIM_UART_LOG_LENGTH     8192
+
+// Struct for a byte received by the debug UART, or a pushbutton press.
+typedef struct {
+    TickType_t tick;
+    uint8_t key;
+} SimKey;
+
+// Struct for a radio frame sent, decoded to its packet.
+typedef struct {
+    TickType_t tick;
+    uint8_t packet[SIM_RADIO_PACKET_SIZE];
+} SimFrame;
+
+// Function called with all text written to the debug UART.
+typedef void (*SimOutputHook)(const char* text, int length);
+
+// Function prototypes
+
+// Presses and releases the USER pushbutton by running its interrupt.
+extern void sim_button_press(void);
+
+// Sets a function called with all text written to the debug UART.
+extern void sim_output_hook(SimOutputHook hook);
+
+// Queues bytes to be received by the debug UART at its line rate.
+extern int sim_uart_input(const char* data, int length);
+
+// Gets the number of queued or traced bytes not yet received.
+extern int sim_uart_pending(void);
+
+// Gets the number of bytes received, including pushbutton presses.
+extern int sim_uart_key_count(void);
+
+// Gets a byte received by its number, from 0.
+extern const SimKey* sim_uart_key_get(int number);
+
+// Gets the number of radio frames sent.
+extern int sim_radio_frame_count(void);
+
+// Gets a radio frame sent by its number, from 0.
+extern const SimFrame* sim_radio_frame_get(int number);
+
+#endif
\ No newline at end of file
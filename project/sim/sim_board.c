@@ -0,0 +1,498 @@
+/** 
+ **************************************************************
+ * @file project/sim/sim_board.c
+ * @author agent
+ * @date 18102026
+ * @brief Simulated board support for the host simulation build.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * BRD_debuguart_init() - Sets up the terminal as the debug UART.
+ * debug_log() - Writes formatted text to stdout.
+ * sim_uart_send() - Sends bytes on the debug UART as DMA would.
+ * sim_button_press() - Presses and releases the USER pushbutton.
+ * sim_output_hook() - Sets a function called with all UART output.
+ * sim_uart_input() - Queues bytes to be received by the debug UART.
+ * sim_uart_pending() - Gets the number of queued bytes not yet received.
+ * sim_uart_key_count() - Gets the number of bytes received.
+ * sim_uart_key_get() - Gets a byte received.
+ *************************************************************** 
+ */
+
+#include "board.h"
+#include "debug_log.h"
+#include "sim.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+
+// termios.h names a terminal flag CR1, which hides the USART register.
+#undef CR1
+
+// USER pushbutton pin and interrupt handler of the board driver.
+#define SIM_BUTTON_PIN 13
+extern void EXTI15_10_IRQHandler(void);
+
+// Receive interrupt handler of the UART driver.
+extern void USART3_IRQHandler(void);
+
+// Transmit DMA interrupt handler of the UART transmit driver.
+extern void DMA1_Stream3_IRQHandler(void);
+
+// Global variables
+// Terminal settings restored on exit.
+static struct termios savedTerminal;
+static int terminalSaved = 0;
+
+// Trace being replayed, with the time since the last key (ms).
+static TickType_t traceDelay[SIM_TRACE_LENGTH];
+static char traceKey[SIM_TRACE_LENGTH];
+static int traceLength = 0;
+static int traceIndex = 0;
+static TickType_t traceNext;
+
+// Bytes queued by tests, received before stdin.
+static char uartInput[SIM_UART_INPUT_SIZE];
+static int uartInputHead = 0;
+static int uartInputTail = 0;
+
+// Bytes received, with the tick each arrived, kept for tests.
+static SimKey keyLog[SIM_UART_LOG_LENGTH];
+static int keyCount = 0;
+
+// Function called with all text written to the debug UART.
+static SimOutputHook outputHook = NULL;
+
+// Text of debug_log, formatted before it is written. It holds a whole
+// transmit buffer.
+static char outputText[2048];
+
+// Transfer started by the transmit driver, with the tick it started, and
+// the time the line is busy until, in bit times.
+static const char* volatile dmaData;
+static volatile int dmaLength = 0;
+static volatile TickType_t dmaStart;
+static uint64_t lineBusyUntil = 0;
+
+// Task that plays the transmit DMA stream, woken when a transfer starts.
+static TaskHandle_t dmaTask = NULL;
+
+/**
+ * Restores the terminal settings on exit.
+ * 
+ * Returns: None
+ */
+void sim_terminal_restore(void) {
+
+    if (terminalSaved) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &savedTerminal);
+    }
+}
+
+/**
+ * Loads a trace dumped by the console (R DUMP), with one key per line as
+ * the time since the last key (ms) and the key in hex.
+ * 
+ * path: the file to load.
+ * 
+ * Returns: None
+ */
+void sim_trace_load(const char* path) {
+
+    FILE* file = fopen(path, "r");
+    char text[64];
+    unsigned long delay;
+    unsigned int key;
+
+    if (file == NULL) {
+        fprintf(stderr, "Cannot open trace %s\n", path);
+        return;
+    }
+
+    // Lines that are not keys, such as the trace header, are skipped.
+    while (fgets(text, sizeof(text), file) != NULL && traceLength < SIM_TRACE_LENGTH) {
+        if (sscanf(text, "%lu %x", &delay, &key) == 2) {
+            traceDelay[traceLength] = delay;
+            traceKey[traceLength] = key;
+            traceLength++;
+        }
+    }
+
+    fclose(file);
+}
+
+/**
+ * Presses and releases the USER pushbutton by running its interrupt.
+ * 
+ * Returns: None
+ */
+extern void sim_button_press(void) {
+
+    GPIOC->IDR |= (0x01 << SIM_BUTTON_PIN);
+    EXTI->PR |= EXTI_PR_PR13;
+
+    EXTI15_10_IRQHandler();
+
+    EXTI->PR &= ~EXTI_PR_PR13;
+    GPIOC->IDR &= ~(0x01 << SIM_BUTTON_PIN);
+}
+
+/**
+ * Gets the next byte on the debug UART line: a replayed trace key when its
+ * time is reached, then bytes queued by tests, then stdin.
+ * 
+ * now: the current tick.
+ * key: set to the byte.
+ * 
+ * Returns: 1 if there is a byte, 0 otherwise.
+ */
+int sim_uart_next(TickType_t now, uint8_t* key) {
+
+    if (traceIndex < traceLength) {
+
+        if (traceIndex == 0 && traceNext == 0) {
+            traceNext = now + traceDelay[0];
+        }
+
+        if ((int32_t) (now - traceNext) < 0) {
+            return 0;
+        }
+
+        *key = traceKey[traceIndex++];
+        if (traceIndex < traceLength) {
+            traceNext += traceDelay[traceIndex];
+        }
+
+        return 1;
+    }
+
+    taskENTER_CRITICAL();
+
+    if (uartInputTail != uartInputHead) {
+        *key = uartInput[uartInputTail];
+        uartInputTail = (uartInputTail + 1) % SIM_UART_INPUT_SIZE;
+        taskEXIT_CRITICAL();
+        return 1;
+    }
+
+    taskEXIT_CRITICAL();
+
+    return read(STDIN_FILENO, key, 1) == 1;
+}
+
+/**
+ * Receives a byte on the debug UART by setting the data register and
+ * running the receive interrupt, as the hardware does. Each key is logged
+ * to stderr with the tick it arrived, so latency can be matched against
+ * the radio frames it causes.
+ * 
+ * now: the current tick.
+ * key: the byte received.
+ * 
+ * Returns: None
+ */
+void sim_uart_receive(TickType_t now, uint8_t key) {
+
+    if (keyCount < SIM_UART_LOG_LENGTH) {
+        keyLog[keyCount].tick = now;
+        keyLog[keyCount].key = key;
+        keyCount++;
+    }
+
+    if (key == SIM_BUTTON_KEY) {
+        fprintf(stderr, "%lu BUTTON\n", (unsigned long) now);
+        sim_button_press();
+        return;
+    }
+
+    fprintf(stderr, "%lu KEY %02X\n", (unsigned long) now, key);
+
+    USART3->DR = key;
+    USART3->SR |= USART_SR_RXNE;
+
+    USART3_IRQHandler();
+
+    USART3->SR &= ~USART_SR_RXNE;
+}
+
+/**
+ * Task that plays the wire side of the debug UART. Each tick it receives
+ * as many bytes as the line rate carries, so a pasted burst arrives over
+ * time as it would from a terminal. Idle line time is not saved up, and
+ * at most SIM_UART_CATCHUP ticks are caught up after a stall. Input waits
+ * until the firmware enables the receive interrupt.
+ * 
+ * Returns: None
+ */
+void sim_uart_task(void) {
+
+    TickType_t last = xTaskGetTickCount();
+    TickType_t now;
+    uint32_t bits = 0;
+    int idle = 1; // No byte was ready when the line last had room
+    uint8_t key;
+
+    for (;;) {
+
+        vTaskDelay(1);
+
+        now = xTaskGetTickCount();
+        bits += (now - last) * SIM_UART_BAUD / configTICK_RATE_HZ;
+        last = now;
+
+        if (!(USART3->CR1 & USART_CR1_RXNEIE)) {
+            bits = 0;
+            continue;
+        }
+
+        // A tick missed while the line was idle adds nothing either.
+        if (idle && bits > SIM_UART_BAUD / configTICK_RATE_HZ) {
+            bits = SIM_UART_BAUD / configTICK_RATE_HZ;
+        } else if (bits > SIM_UART_CATCHUP * SIM_UART_BAUD / configTICK_RATE_HZ) {
+            bits = SIM_UART_CATCHUP * SIM_UART_BAUD / configTICK_RATE_HZ;
+        }
+
+        idle = 0;
+        while (bits >= SIM_UART_BITS) {
+            if (!sim_uart_next(now, &key)) {
+                idle = 1;
+                break;
+            }
+            sim_uart_receive(now, key);
+            bits -= SIM_UART_BITS;
+        }
+    }
+}
+
+/**
+ * Writes bytes sent on the debug UART to stdout and passes them to the
+ * output hook.
+ * 
+ * data: the bytes.
+ * length: the number of bytes.
+ * 
+ * Returns: None
+ */
+void sim_uart_output(const char* data, int length) {
+
+    fwrite(data, 1, length, stdout);
+    fflush(stdout);
+
+    if (outputHook != NULL) {
+        outputHook(data, length);
+    }
+}
+
+/**
+ * Task that plays the transmit DMA stream of the debug UART. A transfer
+ * takes as long as the line rate needs to carry it, starting when the
+ * transfer before it ended if the line was still busy. It sleeps until a
+ * transfer starts, then until it has been sent, then writes it out and
+ * raises the DMA interrupt, which starts the next.
+ * 
+ * Returns: None
+ */
+void sim_dma_task(void) {
+
+    uint64_t start;
+    TickType_t done;
+    TickType_t now;
+
+    for (;;) {
+
+        while (dmaLength == 0) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+
+        // Work out when the transfer ends, rounded up to a whole tick.
+        start = (uint64_t) dmaStart * SIM_UART_BAUD / configTICK_RATE_HZ;
+        if (start > lineBusyUntil) {
+            lineBusyUntil = start;
+        }
+        lineBusyUntil += (uint64_t) dmaLength * SIM_UART_BITS;
+        done = (lineBusyUntil * configTICK_RATE_HZ + SIM_UART_BAUD - 1) / SIM_UART_BAUD;
+
+        now = xTaskGetTickCount();
+        if ((int32_t) (done - now) > 0) {
+            vTaskDelay(done - now);
+        }
+
+        sim_uart_output(dmaData, dmaLength);
+        dmaLength = 0;
+
+        DMA1_Stream3_IRQHandler();
+    }
+}
+
+/**
+ * Starts sending bytes on the debug UART at its line rate, as the transmit
+ * DMA stream does. The DMA interrupt is raised once they are sent. Called
+ * with interrupts masked.
+ * 
+ * data: the bytes, left unchanged until they are sent.
+ * length: the number of bytes.
+ * 
+ * Returns: None
+ */
+extern void sim_uart_send(const char* data, int length) {
+
+    dmaData = data;
+    dmaStart = xTaskGetTickCount();
+    dmaLength = length;
+
+    vTaskNotifyGiveFromISR(dmaTask, NULL);
+}
+
+/**
+ * Sets up stdin as the wire side of the debug UART, reading keys as they
+ * are typed without echo, and loads a trace to replay if one is named.
+ * 
+ * Returns: None
+ */
+extern void BRD_debuguart_init(void) {
+
+    struct termios terminal;
+    const char* path;
+
+    if (tcgetattr(STDIN_FILENO, &savedTerminal) == 0) {
+        terminal = savedTerminal;
+        terminal.c_lflag &= ~(ICANON | ECHO);
+        tcsetattr(STDIN_FILENO, TCSANOW, &terminal);
+        terminalSaved = 1;
+        atexit(sim_terminal_restore);
+    }
+
+    fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+
+    if ((path = getenv(SIM_TRACE_ENV)) != NULL) {
+        sim_trace_load(path);
+    }
+
+    xTaskCreate((void*) &sim_uart_task, (const signed char *) "Sim UART",
+            TASK_SIM_UART_STACK_SIZE, NULL, TASK_SIM_UART_PRIORITY, NULL);
+    xTaskCreate((void*) &sim_dma_task, (const signed char *) "Sim DMA",
+            TASK_SIM_UART_STACK_SIZE, NULL, TASK_SIM_UART_PRIORITY, &dmaTask);
+}
+
+/**
+ * Queues bytes to be received by the debug UART at its line rate, after
+ * any bytes already queued.
+ * 
+ * data: the bytes.
+ * length: the number of bytes.
+ * 
+ * Returns: the number of bytes queued, less than length if the queue is
+ * full.
+ */
+extern int sim_uart_input(const char* data, int length) {
+
+    int count = 0;
+    int next;
+
+    taskENTER_CRITICAL();
+
+    while (count < length) {
+
+        next = (uartInputHead + 1) % SIM_UART_INPUT_SIZE;
+        if (next == uartInputTail) {
+            break;
+        }
+
+        uartInput[uartInputHead] = data[count++];
+        uartInputHead = next;
+    }
+
+    taskEXIT_CRITICAL();
+
+    return count;
+}
+
+/**
+ * Gets the number of bytes queued by sim_uart_input() or left in the
+ * replayed trace that are not yet received.
+ * 
+ * Returns: the number of bytes.
+ */
+extern int sim_uart_pending(void) {
+
+    int pending;
+
+    taskENTER_CRITICAL();
+    pending = (uartInputHead - uartInputTail + SIM_UART_INPUT_SIZE) % SIM_UART_INPUT_SIZE;
+    pending += traceLength - traceIndex;
+    taskEXIT_CRITICAL();
+
+    return pending;
+}
+
+/**
+ * Gets the number of bytes received by the debug UART, including presses
+ * of the pushbutton key.
+ * 
+ * Returns: the number of bytes.
+ */
+extern int sim_uart_key_count(void) {
+
+    return keyCount;
+}
+
+/**
+ * Gets a byte received by the debug UART, if it was kept.
+ * 
+ * number: the byte number, from 0 for the first byte received.
+ * 
+ * Returns: the byte, or NULL if there is no such byte.
+ */
+extern const SimKey* sim_uart_key_get(int number) {
+
+    if (number < 0 || number >= keyCount) {
+        return NULL;
+    }
+
+    return &keyLog[number];
+}
+
+/**
+ * Sets a function called with all text written to the debug UART, so tests
+ * can read what the sender would see.
+ * 
+ * hook: the function, or NULL for none.
+ * 
+ * Returns: None
+ */
+extern void sim_output_hook(SimOutputHook hook) {
+
+    outputHook = hook;
+}
+
+/**
+ * Writes formatted text, including VT100 sequences, to stdout and passes it
+ * to the output hook. Text longer than the format buffer is cut.
+ * 
+ * format: the printf format.
+ * 
+ * Returns: the number of characters written.
+ */
+extern int debug_log(const char* format, ...) {
+
+    va_list args;
+    int count;
+
+    va_start(args, format);
+    count = vsnprintf(outputText, sizeof(outputText), format, args);
+    va_end(args);
+
+    if (count >= (int) sizeof(outputText)) {
+        count = sizeof(outputText) - 1;
+    }
+
+    sim_uart_output(outputText, count);
+
+    return count;
+}
\ No newline at end of file
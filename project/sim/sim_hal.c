@@ -0,0 +1,76 @@
+/** 
+ **************************************************************
+ * @file project/sim/sim_hal.c
+ * @author agent
+ * @date 18102026
+ * @brief Simulated STM32F429 registers for the host simulation build.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * HAL_Init() - Initialises the simulated board.
+ * HAL_NVIC_SetPriority() - Sets an interrupt priority (ignored).
+ * HAL_NVIC_EnableIRQ() - Enables an interrupt (ignored).
+ * NVIC_ClearPendingIRQ() - Clears a pending interrupt (ignored).
+ *************************************************************** 
+ */
+
+#include "processor_hal.h"
+
+// Global variables
+// Simulated peripherals
+GPIO_TypeDef simGpio[7];
+TIM_TypeDef simTim1;
+EXTI_TypeDef simExti;
+SYSCFG_TypeDef simSyscfg;
+RCC_TypeDef simRcc;
+PWR_TypeDef simPwr;
+FLASH_TypeDef simFlash;
+USART_TypeDef simUsart3;
+
+// Core clock of the board, used to set timer prescalers.
+uint32_t SystemCoreClock = 180000000;
+
+/**
+ * Initialises the simulated board. Backup regulator and flash are always
+ * ready, so drivers waiting on them do not hang.
+ * 
+ * Returns: None
+ */
+extern void HAL_Init(void) {
+
+    simPwr.CSR |= PWR_CSR_BRR;
+    simFlash.SR &= ~FLASH_SR_BSY;
+}
+
+/**
+ * Sets an interrupt priority, which the simulation ignores.
+ * 
+ * irq: the interrupt.
+ * priority: the preemption priority.
+ * subPriority: the sub priority.
+ * 
+ * Returns: None
+ */
+extern void HAL_NVIC_SetPriority(IRQn_Type irq, uint32_t priority, uint32_t subPriority) {
+}
+
+/**
+ * Enables an interrupt, which the simulation ignores as interrupts are
+ * called directly.
+ * 
+ * irq: the interrupt.
+ * 
+ * Returns: None
+ */
+extern void HAL_NVIC_EnableIRQ(IRQn_Type irq) {
+}
+
+/**
+ * Clears a pending interrupt, which the simulation ignores.
+ * 
+ * irq: the interrupt.
+ * 
+ * Returns: None
+ */
+extern void NVIC_ClearPendingIRQ(IRQn_Type irq) {
+}
\ No newline at end of file
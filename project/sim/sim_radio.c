@@ -0,0 +1,108 @@
+/** 
+ **************************************************************
+ * @file project/sim/sim_radio.c
+ * @author agent
+ * @date 18102026
+ * @brief Simulated nRF24L01+ radio for the host simulation build.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * nrf24l01plus_init() - Initialises the simulated radio.
+ * nrf24l01plus_send() - Logs a radio frame to stderr.
+ * sim_radio_frame_count() - Gets the number of radio frames sent.
+ * sim_radio_frame_get() - Gets a radio frame sent.
+ *************************************************************** 
+ */
+
+#include "nrf24l01plus.h"
+#include "sim.h"
+#include "s4743527_hamming.h"
+#include "myconfig.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stdio.h>
+#include <string.h>
+
+// Global variables
+// Number of frames sent.
+static unsigned long frameCount = 0;
+
+// Frames sent, kept for tests and harnesses to check.
+static SimFrame frameLog[SIM_RADIO_LOG_LENGTH];
+
+/**
+ * Initialises the simulated radio, logging its channel and address.
+ * 
+ * Returns: None
+ */
+extern void nrf24l01plus_init(void) {
+
+    fprintf(stderr, "RADIO channel %d address %02X%02X%02X%02X%02X\n", MYRADIOCHAN,
+            myradiotxaddr[4], myradiotxaddr[3], myradiotxaddr[2], myradiotxaddr[1],
+            myradiotxaddr[0]);
+}
+
+/**
+ * Logs a Hamming encoded radio frame to stderr with the tick it was sent,
+ * followed by the decoded packet with printable bytes as text. The frame is
+ * also kept for tests.
+ * 
+ * frame: the 32 byte encoded frame.
+ * 
+ * Returns: None
+ */
+extern void nrf24l01plus_send(uint8_t* frame) {
+
+    uint8_t packet[SIM_RADIO_FRAME_SIZE / 2];
+    TickType_t now = xTaskGetTickCount();
+
+    for (int i = 0; i < SIM_RADIO_FRAME_SIZE / 2; i++) {
+        packet[i] = s4743527_lib_hamming_byte_decode(frame[i * 2]) |
+                (s4743527_lib_hamming_byte_decode(frame[(i * 2) + 1]) << 4);
+    }
+
+    if (frameCount < SIM_RADIO_LOG_LENGTH) {
+        frameLog[frameCount].tick = now;
+        memcpy(frameLog[frameCount].packet, packet, SIM_RADIO_PACKET_SIZE);
+    }
+
+    fprintf(stderr, "%lu RADIO %lu ", (unsigned long) now, ++frameCount);
+
+    for (int i = 0; i < SIM_RADIO_FRAME_SIZE / 2; i++) {
+        fprintf(stderr, "%02X", packet[i]);
+    }
+
+    fprintf(stderr, " ");
+
+    for (int i = 0; i < SIM_RADIO_FRAME_SIZE / 2; i++) {
+        fputc((packet[i] >= ' ' && packet[i] <= '~') ? packet[i] : '.', stderr);
+    }
+
+    fprintf(stderr, "\n");
+}
+
+/**
+ * Gets the number of radio frames sent.
+ * 
+ * Returns: the number of frames.
+ */
+extern int sim_radio_frame_count(void) {
+
+    return frameCount;
+}
+
+/**
+ * Gets a radio frame sent, if it was kept.
+ * 
+ * number: the frame number, from 0 for the first frame sent.
+ * 
+ * Returns: the frame, or NULL if there is no such frame.
+ */
+extern const SimFrame* sim_radio_frame_get(int number) {
+
+    if (number < 0 || number >= (int) frameCount || number >= SIM_RADIO_LOG_LENGTH) {
+        return NULL;
+    }
+
+    return &frameLog[number];
+}
\ No newline at end of file
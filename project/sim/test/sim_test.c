@@ -0,0 +1,257 @@
+/**
+ **************************************************************
+ * @file project/sim/test/sim_test.c
+ * @author agent
+ * @date 18102026
+ * @brief Checks and helpers shared by the simulation tests.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * sim_test_check() - Records the result of a check.
+ * sim_test_report() - Prints a measurement.
+ * sim_test_result() - Prints the results and gets the exit status.
+ * sim_test_run() - Starts the firmware with a test task.
+ * sim_test_end() - Ends a test run from the test task.
+ * sim_test_wait_frames() - Waits until a number of frames are sent.
+ * sim_test_wait_idle() - Waits until no frames are sent for a time.
+ * sim_test_join() - Presses the pushbutton and waits for JOIN.
+ * sim_test_frame_text() - Gets the text of a radio packet.
+ * sim_test_frame_position() - Gets the position in a radio packet.
+ ***************************************************************
+ */
+
+#include "sim_test.h"
+#include "processor_hal.h"
+#include "s4743527_rcmcont.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+
+// Offset of the payload in a radio packet, after its type and address.
+#define SIM_TEST_PAYLOAD    5
+
+// Global variables
+// Number of checks run and failed.
+static int checks = 0;
+static int failures = 0;
+
+// Test run by the test task.
+static void (*testFunction)(void) = NULL;
+
+/**
+ * Records the result of a check, printing where it failed.
+ * 
+ * passed: non-zero if the check passed.
+ * text: the condition checked.
+ * file: the file of the check.
+ * line: the line of the check.
+ * 
+ * Returns: None
+ */
+extern void sim_test_check(int passed, const char* text, const char* file, int line) {
+
+    checks++;
+
+    if (!passed) {
+        failures++;
+        fprintf(stderr, "CHECK FAILED %s:%d: %s\n", file, line, text);
+    }
+}
+
+/**
+ * Prints a measurement on its own line, which make test shows for tests
+ * that pass.
+ * 
+ * format: the printf format.
+ * 
+ * Returns: None
+ */
+extern void sim_test_report(const char* format, ...) {
+
+    va_list args;
+
+    fprintf(stderr, "REPORT ");
+
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+
+    fprintf(stderr, "\n");
+}
+
+/**
+ * Prints the number of checks and failures.
+ * 
+ * Returns: 0 if every check passed, or 1 otherwise.
+ */
+extern int sim_test_result(void) {
+
+    fprintf(stderr, "TEST %d checks, %d failed\n", checks, failures);
+
+    return (failures == 0 && checks > 0) ? 0 : 1;
+}
+
+/**
+ * Task that waits for the firmware to start, then runs the test and ends
+ * the run.
+ * 
+ * Returns: None
+ */
+void sim_test_task(void) {
+
+    vTaskDelay(SIM_TEST_START_TIME);
+
+    testFunction();
+    sim_test_end();
+}
+
+/**
+ * Starts the firmware as main.c does, with a task that runs a test once it
+ * has started.
+ * 
+ * test: the test to run.
+ * 
+ * Returns: None
+ */
+extern void sim_test_run(void (*test)(void)) {
+
+    testFunction = test;
+
+    HAL_Init();
+
+    xTaskCreate((void*) &sim_test_task, (const signed char *) "Sim Test",
+            TASK_SIM_TEST_STACK_SIZE, NULL, TASK_SIM_TEST_PRIORITY, NULL);
+
+    // Starts the scheduler, and does not return.
+    s4743527_tsk_rcmcont_init();
+}
+
+/**
+ * Ends a test run from the test task, exiting with its result.
+ * 
+ * Returns: None
+ */
+extern void sim_test_end(void) {
+
+    exit(sim_test_result());
+}
+
+/**
+ * Waits until a number of radio frames have been sent.
+ * 
+ * count: the number of frames.
+ * wait: the most ticks to wait.
+ * 
+ * Returns: 1 if the frames were sent, 0 if the wait timed out.
+ */
+extern int sim_test_wait_frames(int count, TickType_t wait) {
+
+    TickType_t start = xTaskGetTickCount();
+
+    while (sim_radio_frame_count() < count) {
+
+        if ((xTaskGetTickCount() - start) >= wait) {
+            return 0;
+        }
+
+        vTaskDelay(1);
+    }
+
+    return 1;
+}
+
+/**
+ * Waits until no radio frames are sent for a time, e.g. until a move has
+ * ended.
+ * 
+ * quiet: the ticks without a frame.
+ * wait: the most ticks to wait.
+ * 
+ * Returns: 1 if the frames stopped, 0 if the wait timed out.
+ */
+extern int sim_test_wait_idle(TickType_t quiet, TickType_t wait) {
+
+    TickType_t start = xTaskGetTickCount();
+    TickType_t last = start;
+    int count = sim_radio_frame_count();
+
+    while ((xTaskGetTickCount() - last) < quiet) {
+
+        if ((xTaskGetTickCount() - start) >= wait) {
+            return 0;
+        }
+
+        if (sim_radio_frame_count() != count) {
+            count = sim_radio_frame_count();
+            last = xTaskGetTickCount();
+        }
+
+        vTaskDelay(1);
+    }
+
+    return 1;
+}
+
+/**
+ * Presses the pushbutton and waits until JOIN is sent, as positions are
+ * only sent once joined.
+ * 
+ * Returns: 1 if JOIN was sent, 0 otherwise.
+ */
+extern int sim_test_join(void) {
+
+    int count = sim_radio_frame_count();
+    char text[SIM_RADIO_PACKET_SIZE];
+
+    sim_button_press();
+
+    if (!sim_test_wait_frames(count + 1, 100)) {
+        return 0;
+    }
+
+    sim_test_frame_text(sim_radio_frame_get(count), text);
+
+    return strcmp(text, "JOIN") == 0;
+}
+
+/**
+ * Gets the text of a radio packet after its type and address, e.g.
+ * "XYZ00200000" or "JOIN".
+ * 
+ * frame: the frame.
+ * text: set to the text, which must hold SIM_RADIO_PACKET_SIZE bytes.
+ * 
+ * Returns: None
+ */
+extern void sim_test_frame_text(const SimFrame* frame, char* text) {
+
+    int length = SIM_RADIO_PACKET_SIZE - SIM_TEST_PAYLOAD;
+
+    memcpy(text, &frame->packet[SIM_TEST_PAYLOAD], length);
+    text[length] = '\0';
+}
+
+/**
+ * Gets the x, y, and z position in a radio packet.
+ * 
+ * frame: the frame.
+ * x: set to the x position.
+ * y: set to the y position.
+ * z: set to the z position.
+ * 
+ * Returns: 1 if the packet is a position, 0 otherwise.
+ */
+extern int sim_test_frame_position(const SimFrame* frame, int* x, int* y, int* z) {
+
+    char text[SIM_RADIO_PACKET_SIZE];
+
+    sim_test_frame_text(frame, text);
+
+    if (strncmp(text, "XYZ", 3) != 0 ||
+            sscanf(&text[3], "%3d%3d%2d", x, y, z) != 3) {
+        return 0;
+    }
+
+    return 1;
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+/**
+ **************************************************************
+ * @file project/sim/test/sim_test.h
+ * @author agent
+ * @date 18102026
+ * @brief Checks and helpers shared by the simulation tests.
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * sim_test_check() - Records the result of a check.
+ * sim_test_report() - Prints a measurement.
+ * sim_test_result() - Prints the results and gets the exit status.
+ * sim_test_run() - Starts the firmware with a test task.
+ * sim_test_end() - Ends a test run from the test task.
+ * sim_test_wait_frames() - Waits until a number of frames are sent.
+ * sim_test_wait_idle() - Waits until no frames are sent for a time.
+ * sim_test_join() - Presses the pushbutton and waits for JOIN.
+ * sim_test_frame_text() - Gets the text of a radio packet.
+ * sim_test_frame_position() - Gets the position in a radio packet.
+ ***************************************************************
+ */
+
+#ifndef SIM_TEST_H
+#define SIM_TEST_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "sim.h"
+
+// Time for the firmware to start and draw its screen (ms).
+#define SIM_TEST_START_TIME 300
+
+// Task Priority, the same as the console so input is taken in turn.
+#define TASK_SIM_TEST_PRIORITY  (tskIDLE_PRIORITY + 1)
+
+// Task Stack Allocation
+#define TASK_SIM_TEST_STACK_SIZE    (configMINIMAL_STACK_SIZE * 4)
+
+// Checks a condition, recording where it failed.
+#define SIM_CHECK(condition) \
+        sim_test_check((condition), #condition, __FILE__, __LINE__)
+
+// Function prototypes
+
+// Records the result of a check, printing it if it failed.
+extern void sim_test_check(int passed, const char* text, const char* file, int line);
+
+// Prints a measurement, which make test shows for tests that pass.
+extern void sim_test_report(const char* format, ...);
+
+// Prints the number of checks and failures, and gets the exit status.
+extern int sim_test_result(void);
+
+// Starts the firmware with a task that runs a test, and never returns.
+extern void sim_test_run(void (*test)(void));
+
+// Ends a test run from the test task, exiting with its result.
+extern void sim_test_end(void);
+
+// Waits until a number of radio frames have been sent.
+extern int sim_test_wait_frames(int count, TickType_t wait);
+
+// Waits until no radio frames are sent for a time.
+extern int sim_test_wait_idle(TickType_t quiet, TickType_t wait);
+
+// Presses the pushbutton and waits until JOIN is sent.
+extern int sim_test_join(void);
+
+// Gets the text of a radio packet after its header.
+extern void sim_test_frame_text(const SimFrame* frame, char* text);
+
+// Gets the x, y, and z position in a radio packet.
+extern int sim_test_frame_position(const SimFrame* frame, int* x, int* y, int* z);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,446 @@
+/**
+ **************************************************************
+ * @file project/sim/test/test_display.c
+ * @author agent
+ * @date 18102026
+ * @brief Measures the bytes the RCM display sends to draw its screen at
+ * startup and for each move, and checks a terminal shows what it drew.
+ * Then measures how far the display lags behind a stream of keys.
+ ***************************************************************
+ */
+
+#include "sim_test.h"
+#include "board.h"
+#include "s4743527_rcmcont.h"
+#include <stdio.h>
+#include <string.h>
+
+// Most bytes and transfers of output kept.
+#define DISPLAY_TEST_OUTPUT (1 << 20)
+#define DISPLAY_TEST_WRITES 16384
+
+// Number of moves measured, taking turns with the keys that move x by the
+// fine and medium steps. Medium steps leave a gap that the cursor moves
+// over by rewriting the cells between.
+#define DISPLAY_TEST_MOVES  10
+#define DISPLAY_TEST_KEYS   "qa"
+
+// The keys as the display shows them, in upper case.
+#define DISPLAY_TEST_KEYS_SHOWN "QA"
+
+// Time for the display to draw a move once the stage has stopped (ms),
+// more than a pass of the display task.
+#define DISPLAY_TEST_DRAW_TIME  150
+
+// Number of keys streamed, and the time between them (ms) for 30 keys a
+// second. The keys move x and y by the fine step in turn, so the jog curve
+// never speeds them up and each key moves to its own cell.
+#define DISPLAY_TEST_STREAM 90
+#define DISPLAY_TEST_STREAM_PERIOD  33
+#define DISPLAY_TEST_STREAM_KEYS    "qe"
+#define DISPLAY_TEST_STREAM_SHOWN   "QE"
+
+// Most time from a key to the terminal showing it or a newer position (ms),
+// a pass of the display task and its two receive timeouts, with a period
+// of the trajectory task to spare for the time on the wire.
+#define DISPLAY_TEST_MAX_LAG    100
+
+// Columns of the terminal, more than the display draws on.
+#define DISPLAY_TEST_COLUMNS    (DISPLAY_COLUMNS + 8)
+
+// Cell of the terminal showing HORIZONTAL_SYMBOL.
+#define DISPLAY_TEST_HORIZONTAL 0x80
+
+// Transfer of output to the terminal.
+typedef struct {
+    TickType_t tick;
+    int offset;
+    int length;
+} DisplayTestWrite;
+
+// Global variables
+// Output and the transfers it was sent in.
+static char output[DISPLAY_TEST_OUTPUT];
+static int outputLength = 0;
+static DisplayTestWrite writes[DISPLAY_TEST_WRITES];
+static int writeCount = 0;
+
+// Terminal the display's output is drawn on, and its cursor.
+static uint8_t terminal[DISPLAY_ROWS][DISPLAY_TEST_COLUMNS];
+static int terminalX = 1;
+static int terminalY = 1;
+
+// Cell the RCM position symbol was last drawn at.
+static int positionX = 0;
+static int positionY = 0;
+
+/**
+ * Output hook that keeps the output with the tick it reached the terminal.
+ * The simulation sends output as DMA does, a buffer of writes at a time
+ * once the line has carried it. Only the display writes while the test
+ * runs, apart from the join.
+ * 
+ * text: the output.
+ * length: the number of bytes.
+ * 
+ * Returns: None
+ */
+void display_test_output(const char* text, int length) {
+
+    if (writeCount >= DISPLAY_TEST_WRITES || outputLength + length > DISPLAY_TEST_OUTPUT) {
+        return;
+    }
+
+    writes[writeCount].tick = xTaskGetTickCount();
+    writes[writeCount].offset = outputLength;
+    writes[writeCount].length = length;
+    writeCount++;
+
+    memcpy(&output[outputLength], text, length);
+    outputLength += length;
+}
+
+/**
+ * Draws bytes on the terminal, following the VT100 sequences the display
+ * uses: clear, absolute moves and moves forward.
+ * 
+ * bytes: the bytes.
+ * length: the number of bytes.
+ * 
+ * Returns: None
+ */
+void display_test_draw(const char* bytes, int length) {
+
+    int params[2];
+    int count;
+    uint8_t byte;
+
+    for (int i = 0; i < length; i++) {
+
+        byte = bytes[i];
+
+        if (byte == '\e' && i + 1 < length && bytes[i + 1] == '[') {
+
+            params[0] = 0;
+            params[1] = 0;
+            count = 0;
+            for (i += 2; i < length && ((bytes[i] >= '0' && bytes[i] <= '9') ||
+                    bytes[i] == ';'); i++) {
+                if (bytes[i] == ';') {
+                    count = 1;
+                } else {
+                    params[count] = (params[count] * 10) + (bytes[i] - '0');
+                }
+            }
+
+            if (i >= length) {
+                return;
+            } else if (bytes[i] == 'H') {
+                terminalY = (params[0] > 0) ? params[0] : 1;
+                terminalX = (params[1] > 0) ? params[1] : 1;
+            } else if (bytes[i] == 'C') {
+                terminalX += (params[0] > 0) ? params[0] : 1;
+            } else if (bytes[i] == 'J' && params[0] == 2) {
+                memset(terminal, ' ', sizeof(terminal));
+            }
+
+        } else if (byte >= 0x80 && byte < 0xC0) {
+            // The rest of a UTF-8 character, drawn with its first byte.
+        } else if (byte >= ' ') {
+            if (terminalY >= 1 && terminalY <= DISPLAY_ROWS && terminalX >= 1 &&
+                    terminalX <= DISPLAY_TEST_COLUMNS) {
+                terminal[terminalY - 1][terminalX - 1] = (byte >= 0xC0) ?
+                        DISPLAY_TEST_HORIZONTAL : byte;
+            }
+            if (byte == RCM_POSITION_SYMBOL) {
+                positionX = terminalX;
+                positionY = terminalY;
+            }
+            terminalX++;
+        }
+    }
+}
+
+/**
+ * Counts the cells of the display drawn differently from the screen
+ * expected, with the RCM at a position and a key shown.
+ * 
+ * xPos: the x position of the RCM.
+ * yPos: the y position of the RCM.
+ * key: the key shown.
+ * 
+ * Returns: the number of cells that differ.
+ */
+int display_test_wrong(int xPos, int yPos, char key) {
+
+    uint8_t expected;
+    int wrong = 0;
+
+    for (int y = 1; y <= DISPLAY_ROWS; y++) {
+        for (int x = 1; x <= DISPLAY_TEST_COLUMNS; x++) {
+
+            expected = ' ';
+            if ((y == 1 || y == BORDER_SIZE) && x <= BORDER_SIZE) {
+                expected = DISPLAY_TEST_HORIZONTAL;
+            } else if ((x == 1 || x == BORDER_SIZE) && y <= BORDER_SIZE) {
+                expected = VERTICAL_SYMBOL;
+            } else if (x == INITIAL_X + (xPos / 2) && y == INITIAL_Y - (yPos / 2)) {
+                expected = RCM_POSITION_SYMBOL;
+            } else if (y == KEY_PRESSED_Y && x >= KEY_PRESSED_X && 
+                    x < KEY_PRESSED_X + (int) strlen(KEY_PRESSED_MSG)) {
+                expected = KEY_PRESSED_MSG[x - KEY_PRESSED_X];
+            } else if (y == KEY_PRESSED_Y && x == KEY_X && key != '\0') {
+                expected = key;
+            }
+
+            if (terminal[y - 1][x - 1] != expected) {
+                wrong++;
+            }
+        }
+    }
+
+    return wrong;
+}
+
+/**
+ * Draws the transfers of output from one on the terminal.
+ * 
+ * from: the number of the first transfer, updated past those drawn.
+ * bytes: added to with the number of bytes drawn.
+ * 
+ * Returns: the number of transfers drawn.
+ */
+int display_test_replay(int* from, int* bytes) {
+
+    int count = 0;
+
+    for (; *from < writeCount; (*from)++) {
+        display_test_draw(&output[writes[*from].offset], writes[*from].length);
+        *bytes += writes[*from].length;
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ * Gets the bytes the display sent one sequence per cell before it kept a
+ * screen model.
+ * 
+ * xPos: the column.
+ * yPos: the row.
+ * text: the text drawn.
+ * 
+ * Returns: the number of bytes.
+ */
+int display_test_old_bytes(int xPos, int yPos, const char* text) {
+
+    return snprintf(NULL, 0, "\e[%d;%dH%s", yPos, xPos, text);
+}
+
+/**
+ * Gets the bytes the display sent to draw its screen at startup before it
+ * kept a screen model.
+ * 
+ * Returns: the number of bytes.
+ */
+int display_test_old_startup(void) {
+
+    char vertical[2] = {VERTICAL_SYMBOL, '\0'};
+    char position[2] = {RCM_POSITION_SYMBOL, '\0'};
+    int bytes = strlen("\e[2J") + strlen("\e[H");
+
+    for (int i = 1; i <= BORDER_SIZE; i++) {
+        bytes += display_test_old_bytes(i, 1, HORIZONTAL_SYMBOL);
+        bytes += display_test_old_bytes(i, BORDER_SIZE, HORIZONTAL_SYMBOL);
+        bytes += display_test_old_bytes(1, i, vertical);
+        bytes += display_test_old_bytes(BORDER_SIZE, i, vertical);
+    }
+
+    bytes += display_test_old_bytes(KEY_PRESSED_X, KEY_PRESSED_Y, KEY_PRESSED_MSG);
+    bytes += display_test_old_bytes(INITIAL_X, INITIAL_Y, position);
+    bytes += display_test_old_bytes(INITIAL_X, INITIAL_Y, "");
+
+    return bytes;
+}
+
+/**
+ * Gets the time to send bytes on the debug UART.
+ * 
+ * bytes: the number of bytes.
+ * 
+ * Returns: the time (ms).
+ */
+int display_test_wire_time(int bytes) {
+
+    return (bytes * SIM_UART_BITS * 1000) / SIM_UART_BAUD;
+}
+
+/**
+ * Gets the bytes the display sent for a move along x before it kept a
+ * screen model.
+ * 
+ * oldX: the x position moved from.
+ * xPos: the x position moved to.
+ * key: the key shown.
+ * 
+ * Returns: the number of bytes.
+ */
+int display_test_old_move(int oldX, int xPos, char key) {
+
+    char text[2] = {key, '\0'};
+
+    return display_test_old_bytes(KEY_X, KEY_PRESSED_Y, text) +
+            display_test_old_bytes(INITIAL_X + (oldX / 2), INITIAL_Y, " ") +
+            display_test_old_bytes(INITIAL_X + (xPos / 2), INITIAL_Y, "+") +
+            display_test_old_bytes(INITIAL_X + (xPos / 2), INITIAL_Y, "");
+}
+
+/**
+ * Streams keys at 30 a second, then finds when the terminal first showed the
+ * position after each key, or a newer one, as positions it had not drawn
+ * yet are replaced.
+ * 
+ * from: the number of the first transfer not yet drawn, updated past
+ * the transfers drawn.
+ * xPos: the x position before the keys.
+ * yPos: the y position before the keys.
+ * 
+ * Returns: None
+ */
+void display_test_lag(int* from, int xPos, int yPos) {
+
+    static int columns[DISPLAY_TEST_STREAM];
+    static int rows[DISPLAY_TEST_STREAM];
+    static int lag[DISPLAY_TEST_STREAM];
+    int fine = s4743527RcmConfig.axis[AXIS_X].step[0];
+    int first = sim_uart_key_count();
+    int drawn = 0;
+    int bytes = 0;
+    int total = 0;
+    int most = 0;
+    int shown = 0;
+    const SimKey* key;
+
+    // Cell of the position after each key.
+    for (int i = 0; i < DISPLAY_TEST_STREAM; i++) {
+        xPos += (i % 2) ? 0 : fine;
+        yPos += (i % 2) ? fine : 0;
+        columns[i] = INITIAL_X + (xPos / 2);
+        rows[i] = INITIAL_Y - (yPos / 2);
+    }
+
+    for (int i = 0; i < DISPLAY_TEST_STREAM; i++) {
+        sim_uart_input(&DISPLAY_TEST_STREAM_KEYS[i % 2], 1);
+        vTaskDelay(DISPLAY_TEST_STREAM_PERIOD);
+    }
+    SIM_CHECK(sim_test_wait_idle(100, 5000));
+    vTaskDelay(DISPLAY_TEST_DRAW_TIME);
+    SIM_CHECK(sim_uart_key_count() == first + DISPLAY_TEST_STREAM);
+
+    // Draw each transfer in turn, and mark the keys up to the position drawn.
+    for (; *from < writeCount; (*from)++) {
+
+        display_test_draw(&output[writes[*from].offset], writes[*from].length);
+        bytes += writes[*from].length;
+
+        for (int i = DISPLAY_TEST_STREAM - 1; i >= drawn; i--) {
+            if (columns[i] == positionX && rows[i] == positionY) {
+                shown++;
+                for (; drawn <= i; drawn++) {
+                    key = sim_uart_key_get(first + drawn);
+                    lag[drawn] = (key == NULL) ? 0 : writes[*from].tick - key->tick;
+                }
+                break;
+            }
+        }
+    }
+
+    SIM_CHECK(drawn == DISPLAY_TEST_STREAM);
+    SIM_CHECK(display_test_wrong(xPos, yPos,
+            DISPLAY_TEST_STREAM_SHOWN[(DISPLAY_TEST_STREAM - 1) % 2]) == 0);
+
+    for (int i = 0; i < drawn; i++) {
+        total += lag[i];
+        most = (lag[i] > most) ? lag[i] : most;
+    }
+    SIM_CHECK(most <= DISPLAY_TEST_MAX_LAG);
+
+    sim_test_report("display: %d keys at 30 a second, %d positions drawn, lag mean %d "
+            "max %d ms, %d bytes", DISPLAY_TEST_STREAM, shown,
+            (drawn > 0) ? total / drawn : 0, most, bytes);
+}
+
+/**
+ * Draws the startup screen on the terminal, then moves along x by fine
+ * and medium steps in turn, checking the terminal after each move. Then
+ * streams keys to measure the lag of the display.
+ * 
+ * Returns: None
+ */
+void test_display(void) {
+
+    int fine = s4743527RcmConfig.axis[AXIS_X].step[0];
+    int medium = s4743527RcmConfig.axis[AXIS_X].step[1];
+    int oldTotal = 0;
+    int from = 0;
+    int startup = 0;
+    int startupWrites;
+    int bytes;
+    int most = 0;
+    int total = 0;
+    int wrong = 0;
+    int x = 0;
+
+    // The display draws its screen as it starts, before the test runs.
+    startupWrites = display_test_replay(&from, &startup);
+    SIM_CHECK(startupWrites > 0);
+    SIM_CHECK(display_test_wrong(0, 0, '\0') == 0);
+    SIM_CHECK(terminalX == INITIAL_X && terminalY == INITIAL_Y);
+    SIM_CHECK(startup < display_test_old_startup());
+
+    SIM_CHECK(sim_test_join());
+    SIM_CHECK(sim_test_wait_idle(100, 1000));
+    vTaskDelay(DISPLAY_TEST_DRAW_TIME);
+    bytes = 0;
+    display_test_replay(&from, &bytes);
+
+    for (int i = 0; i < DISPLAY_TEST_MOVES; i++) {
+
+        sim_uart_input(&DISPLAY_TEST_KEYS[i % 2], 1);
+        SIM_CHECK(sim_test_wait_idle(100, 2000));
+        vTaskDelay(DISPLAY_TEST_DRAW_TIME);
+        x += (i % 2) ? medium : fine;
+        oldTotal += display_test_old_move(x - ((i % 2) ? medium : fine), x,
+                DISPLAY_TEST_KEYS_SHOWN[i % 2]);
+
+        bytes = 0;
+        display_test_replay(&from, &bytes);
+        wrong += display_test_wrong(x, 0, DISPLAY_TEST_KEYS_SHOWN[i % 2]);
+        total += bytes;
+        most = (bytes > most) ? bytes : most;
+    }
+
+    SIM_CHECK(wrong == 0);
+    SIM_CHECK(terminalX == INITIAL_X + (x / 2) && terminalY == INITIAL_Y);
+    SIM_CHECK(most > 0 && total < oldTotal);
+
+    sim_test_report("display: startup %d bytes in %d transfers, %d ms on the wire "
+            "(%d bytes, %d ms one sequence per cell)", startup, startupWrites,
+            display_test_wire_time(startup), display_test_old_startup(),
+            display_test_wire_time(display_test_old_startup()));
+    sim_test_report("display: moves %d bytes each on average, at most %d "
+            "(%d bytes one sequence per cell)", total / DISPLAY_TEST_MOVES, most,
+            oldTotal / DISPLAY_TEST_MOVES);
+
+    display_test_lag(&from, x, 0);
+}
+
+int main(void) {
+
+    sim_output_hook(display_test_output);
+
+    sim_test_run(test_display);
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+/**
+ **************************************************************
+ * @file project/sim/test/test_escape.c
+ * @author agent
+ * @date 18102026
+ * @brief Checks escape sequences are timed by when their bytes arrive, not
+ * when the console gets to read them.
+ ***************************************************************
+ */
+
+#include "sim_test.h"
+#include "s4743527_console.h"
+#include "s4743527_rcmcont.h"
+
+// Name of the console task, held while bytes arrive.
+#define ESCAPE_TEST_CONSOLE "Console Input"
+
+// Time the console is held, longer than an escape sequence may stop (ms).
+#define ESCAPE_TEST_HOLD    (ESCAPE_TIMEOUT + 10)
+
+/**
+ * Gets the x and y position of the last frame sent, once the move has
+ * ended.
+ * 
+ * x: set to the x position.
+ * y: set to the y position.
+ * 
+ * Returns: 1 if a position was sent, 0 otherwise.
+ */
+int escape_test_position(int* x, int* y) {
+
+    int z;
+
+    return sim_test_wait_idle(250, 5000) &&
+            sim_test_frame_position(sim_radio_frame_get(sim_radio_frame_count() - 1),
+                    x, y, &z);
+}
+
+/**
+ * Sends bytes and waits until they have all arrived.
+ * 
+ * data: the bytes.
+ * length: the number of bytes.
+ * 
+ * Returns: None
+ */
+void escape_test_send(const char* data, int length) {
+
+    sim_uart_input(data, length);
+    while (sim_uart_pending() > 0) {
+        vTaskDelay(1);
+    }
+}
+
+/**
+ * Checks the escape sequence parser with given times, without the firmware
+ * running.
+ * 
+ * Returns: None
+ */
+void escape_test_parse(void) {
+
+    EscapeParser escape = {ESCAPE_IDLE, 0, 0};
+
+    // A whole sequence is an arrow, however long after it is parsed.
+    SIM_CHECK(s4743527_lib_console_escape(&escape, ESC, 100) == ESCAPE_MORE);
+    SIM_CHECK(s4743527_lib_console_escape(&escape, '[', 100) == ESCAPE_MORE);
+    SIM_CHECK(s4743527_lib_console_escape(&escape, 'A', 100 + ESCAPE_TIMEOUT) == KEY_INPUT(2));
+
+    // A gap longer than the timeout leaves plain keys.
+    SIM_CHECK(s4743527_lib_console_escape(&escape, ESC, 200) == ESCAPE_MORE);
+    SIM_CHECK(s4743527_lib_console_escape(&escape, '[', 201 + ESCAPE_TIMEOUT) == ESCAPE_PLAIN);
+    SIM_CHECK(s4743527_lib_console_escape(&escape, 'A', 201 + ESCAPE_TIMEOUT) == ESCAPE_PLAIN);
+}
+
+/**
+ * Holds the console while the bytes of escape sequences arrive, checking a
+ * lone ESC is still dropped and a whole sequence is still an arrow.
+ * 
+ * Returns: None
+ */
+void test_escape(void) {
+
+    TaskHandle_t console = xTaskGetHandle(ESCAPE_TEST_CONSOLE);
+    int fine = s4743527RcmConfig.axis[AXIS_Y].step[0];
+    int medium = s4743527RcmConfig.axis[AXIS_X].step[1];
+    int x = 0, y = 0;
+
+    SIM_CHECK(console != NULL);
+    SIM_CHECK(sim_test_join());
+    SIM_CHECK(sim_test_wait_idle(100, 1000));
+
+    // A lone ESC, then "[A" typed after the timeout, read together. The A
+    // is a plain key, moving x by the medium step.
+    vTaskSuspend(console);
+    escape_test_send("\x1B", 1);
+    vTaskDelay(ESCAPE_TEST_HOLD);
+    escape_test_send("[A", 2);
+    vTaskResume(console);
+    SIM_CHECK(escape_test_position(&x, &y));
+    SIM_CHECK(x == medium && y == 0);
+
+    // A whole sequence, the ESC read at once and the rest read after the
+    // timeout. It is the up arrow, moving y by the fine step.
+    escape_test_send("\x1B", 1);
+    vTaskDelay(2);
+    vTaskSuspend(console);
+    escape_test_send("[A", 2);
+    vTaskDelay(ESCAPE_TEST_HOLD);
+    vTaskResume(console);
+    SIM_CHECK(escape_test_position(&x, &y));
+    SIM_CHECK(x == medium && y == fine);
+
+    sim_test_report("escape: sequences held %d ms timed by arrival", ESCAPE_TEST_HOLD);
+}
+
+int main(void) {
+
+    escape_test_parse();
+
+    sim_test_run(test_escape);
+
+    return 0;
+}
\ No newline at end of file
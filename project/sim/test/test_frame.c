@@ -0,0 +1,281 @@
+/**
+ **************************************************************
+ * @file project/sim/test/test_frame.c
+ * @author agent
+ * @date 18102026
+ * @brief Checks X/Y jogs in the sample frame follow the stage rotation,
+ * and times the fixed point rotation against a float reference.
+ ***************************************************************
+ */
+
+#include "sim_test.h"
+#include "s4743527_rcmcont.h"
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Largest step checked for moves and their reverse cancelling.
+#define FRAME_TEST_MAX_STEP 50
+
+// Number of times every angle, step and axis is rotated when timed, and
+// the number of times each rotation is timed, taking the quickest so
+// another process running does not count against it.
+#define FRAME_TEST_PASSES   100
+#define FRAME_TEST_RUNS     5
+
+// Pi as a float, for the reference rotation.
+#define FRAME_TEST_PI       3.14159265f
+
+// Key that toggles the sample frame, and the time for it to be taken
+// (ms). It is a command, not a key event, so it is spaced from the keys
+// after it as a person would type them.
+#define FRAME_TEST_TOGGLE   "m"
+#define FRAME_TEST_TOGGLE_TIME  50
+
+// Keys that jog x and y by the fine step.
+#define FRAME_TEST_X        "q"
+#define FRAME_TEST_Y        "e"
+
+/**
+ * Sends a key and gets the x and y position once the move has ended.
+ * 
+ * key: the key to send.
+ * x: set to the x position.
+ * y: set to the y position.
+ * 
+ * Returns: 1 if a position was sent, 0 otherwise.
+ */
+int frame_test_key(const char* key, int* x, int* y) {
+
+    int z;
+
+    sim_uart_input(key, strlen(key));
+
+    return sim_test_wait_idle(250, 5000) &&
+            sim_test_frame_position(sim_radio_frame_get(sim_radio_frame_count() - 1),
+                    x, y, &z);
+}
+
+/**
+ * Checks the sine table and the rotation of moves without the firmware
+ * running.
+ * 
+ * Returns: None
+ */
+void frame_test_transform(void) {
+
+    int x, y;
+    int backX, backY;
+    int worst = 0;
+
+    SIM_CHECK(s4743527_lib_rcmcont_sin(0) == 0);
+    SIM_CHECK(s4743527_lib_rcmcont_sin(30) == (1 << TRIG_SHIFT) / 2);
+    SIM_CHECK(s4743527_lib_rcmcont_sin(90) == (1 << TRIG_SHIFT));
+    SIM_CHECK(s4743527_lib_rcmcont_sin(270) == -(1 << TRIG_SHIFT));
+    SIM_CHECK(s4743527_lib_rcmcont_sin(-90) == -(1 << TRIG_SHIFT));
+    SIM_CHECK(s4743527_lib_rcmcont_cos(180) == -(1 << TRIG_SHIFT));
+
+    // Quarter turns move exactly along the other axis.
+    x = 2, y = 0;
+    s4743527_lib_rcmcont_frame_transform(0, &x, &y);
+    SIM_CHECK(x == 2 && y == 0);
+    x = 2, y = 0;
+    s4743527_lib_rcmcont_frame_transform(90, &x, &y);
+    SIM_CHECK(x == 0 && y == 2);
+    x = 0, y = 2;
+    s4743527_lib_rcmcont_frame_transform(180, &x, &y);
+    SIM_CHECK(x == 0 && y == -2);
+
+    // Other angles round to the nearest step.
+    x = 10, y = 0;
+    s4743527_lib_rcmcont_frame_transform(30, &x, &y);
+    SIM_CHECK(x == 9 && y == 5);
+
+    // A move and its reverse cancel at every angle and step.
+    for (int degrees = ROTATE_MIN; degrees <= ROTATE_MAX; degrees++) {
+        for (int step = 1; step <= FRAME_TEST_MAX_STEP; step++) {
+            for (int axis = 0; axis < 2; axis++) {
+
+                x = (axis == 0) ? step : 0;
+                y = (axis == 1) ? step : 0;
+                backX = -x;
+                backY = -y;
+                s4743527_lib_rcmcont_frame_transform(degrees, &x, &y);
+                s4743527_lib_rcmcont_frame_transform(degrees, &backX, &backY);
+
+                if (abs(x + backX) + abs(y + backY) > worst) {
+                    worst = abs(x + backX) + abs(y + backY);
+                }
+            }
+        }
+    }
+    SIM_CHECK(worst == 0);
+}
+
+/**
+ * Rotates an X/Y move in floats, as the reference the fixed point rotation
+ * is timed and checked against.
+ * 
+ * degrees: the rotation of the sample.
+ * x: the X distance, replaced by the machine X distance.
+ * y: the Y distance, replaced by the machine Y distance.
+ * 
+ * Returns: None
+ */
+void frame_test_float(int degrees, int* x, int* y) {
+
+    float radians = (float) degrees * FRAME_TEST_PI / 180.0f;
+    float sine = sinf(radians);
+    float cosine = cosf(radians);
+    float machineX = (float) *x * cosine - (float) *y * sine;
+    float machineY = (float) *x * sine + (float) *y * cosine;
+
+    *x = (int) roundf(machineX);
+    *y = (int) roundf(machineY);
+}
+
+/**
+ * Gets the time in microseconds.
+ * 
+ * Returns: the time (us).
+ */
+long frame_test_now(void) {
+
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec * 1000000L) + (now.tv_nsec / 1000);
+}
+
+/**
+ * Rotates every angle, step and axis a number of times, timing it.
+ * 
+ * transform: the rotation to time.
+ * sum: added to with every result, so the rotations are not left out.
+ * 
+ * Returns: the time taken (us).
+ */
+long frame_test_time(void (*transform)(int, int*, int*), volatile int* sum) {
+
+    int x, y;
+    long start = frame_test_now();
+
+    for (int pass = 0; pass < FRAME_TEST_PASSES; pass++) {
+        for (int degrees = ROTATE_MIN; degrees <= ROTATE_MAX; degrees++) {
+            for (int step = 1; step <= FRAME_TEST_MAX_STEP; step++) {
+                for (int axis = 0; axis < 2; axis++) {
+
+                    x = (axis == 0) ? step : -step;
+                    y = (axis == 1) ? step : -step;
+                    transform(degrees, &x, &y);
+                    *sum += x + y;
+                }
+            }
+        }
+    }
+
+    return frame_test_now() - start;
+}
+
+/**
+ * Checks the fixed point rotation is within a step of the float reference
+ * at every angle and step, and is quicker than it.
+ * 
+ * Returns: None
+ */
+void frame_test_benchmark(void) {
+
+    volatile int sum = 0;
+    long fixedTime;
+    long floatTime;
+    long time;
+    int x, y;
+    int refX, refY;
+    int worst = 0;
+    int differ = 0;
+
+    for (int degrees = ROTATE_MIN; degrees <= ROTATE_MAX; degrees++) {
+        for (int step = 1; step <= FRAME_TEST_MAX_STEP; step++) {
+            for (int axis = 0; axis < 2; axis++) {
+
+                x = refX = (axis == 0) ? step : -step;
+                y = refY = (axis == 1) ? step : -step;
+                s4743527_lib_rcmcont_frame_transform(degrees, &x, &y);
+                frame_test_float(degrees, &refX, &refY);
+
+                if (abs(x - refX) > worst) {
+                    worst = abs(x - refX);
+                }
+                if (abs(y - refY) > worst) {
+                    worst = abs(y - refY);
+                }
+                if (x != refX || y != refY) {
+                    differ++;
+                }
+            }
+        }
+    }
+    SIM_CHECK(worst <= 1);
+
+    fixedTime = floatTime = LONG_MAX;
+    for (int run = 0; run < FRAME_TEST_RUNS; run++) {
+        time = frame_test_time(s4743527_lib_rcmcont_frame_transform, &sum);
+        fixedTime = (time < fixedTime) ? time : fixedTime;
+        time = frame_test_time(frame_test_float, &sum);
+        floatTime = (time < floatTime) ? time : floatTime;
+    }
+
+    SIM_CHECK(fixedTime < floatTime);
+
+    sim_test_report("frame: %d rotations, %ld us in fixed point, %ld us in floats at best "
+            "of %d, %d of %d a step from floats", FRAME_TEST_PASSES * (ROTATE_MAX - ROTATE_MIN + 1) *
+            FRAME_TEST_MAX_STEP * 2, fixedTime, floatTime, FRAME_TEST_RUNS, differ,
+            (ROTATE_MAX - ROTATE_MIN + 1) * FRAME_TEST_MAX_STEP * 2);
+}
+
+/**
+ * Turns the stage a quarter turn and jogs in the sample frame, then in the
+ * machine frame.
+ * 
+ * Returns: None
+ */
+void test_frame(void) {
+
+    int fine = s4743527RcmConfig.axis[AXIS_X].step[0];
+    int x = 0, y = 0;
+
+    SIM_CHECK(sim_test_join());
+    SIM_CHECK(frame_test_key("/G 100 100 0 1 90\r", &x, &y));
+    SIM_CHECK(x == 100 && y == 100);
+
+    // In the sample frame at 90 degrees, x moves along machine y and y
+    // moves back along machine x.
+    sim_uart_input(FRAME_TEST_TOGGLE, 1);
+    vTaskDelay(FRAME_TEST_TOGGLE_TIME);
+    SIM_CHECK(frame_test_key(FRAME_TEST_X, &x, &y));
+    SIM_CHECK(x == 100 && y == 100 + fine);
+    SIM_CHECK(frame_test_key(FRAME_TEST_Y, &x, &y));
+    SIM_CHECK(x == 100 - fine && y == 100 + fine);
+
+    // Back in the machine frame, keys move along their own axis.
+    sim_uart_input(FRAME_TEST_TOGGLE, 1);
+    vTaskDelay(FRAME_TEST_TOGGLE_TIME);
+    SIM_CHECK(frame_test_key(FRAME_TEST_X, &x, &y));
+    SIM_CHECK(x == 100 && y == 100 + fine);
+
+    sim_test_report("frame: moves and their reverse cancel for %d angles",
+            ROTATE_MAX - ROTATE_MIN + 1);
+}
+
+int main(void) {
+
+    frame_test_transform();
+    frame_test_benchmark();
+
+    sim_test_run(test_frame);
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,220 @@
+/**
+ **************************************************************
+ * @file project/sim/test/test_hex.c
+ * @author agent
+ * @date 18102026
+ * @brief Checks the bulk hex converters against the per-character one,
+ * and measures how much faster they are.
+ ***************************************************************
+ */
+
+#include "sim_test.h"
+#include "s4743527_console.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Number of bytes in each frame converted by the benchmark, as a frame of
+// the host protocol.
+#define HEX_TEST_FRAME  64
+
+// Number of frames converted by the benchmark.
+#define HEX_TEST_FRAMES 200000
+
+// Least speedup of the bulk converter over the branches, well under what
+// is measured so a busy machine still passes.
+#define HEX_TEST_MIN_SPEEDUP    2
+
+/**
+ * Converts a character as the per-character converter did before it used
+ * a table, for checking the table.
+ * 
+ * value: the character.
+ * 
+ * Returns: the value, or -1 if the character is not hexadecimal.
+ */
+int hex_test_branches(char value) {
+
+    if (value >= 'A' && value <= 'F') {
+        return value - 55;
+    } else if (value >= 'a' && value <= 'f') {
+        return value - 87;
+    } else if (value >= '0' && value <= '9') {
+        return value - 48;
+    }
+
+    return -1;
+}
+
+/**
+ * Converts hex text to bytes one character at a time, as callers did
+ * before the bulk converter.
+ * 
+ * convert: the per-character converter.
+ * hex: the text.
+ * length: the number of characters.
+ * bytes: where the bytes are written.
+ * 
+ * Returns: the number of bytes written, or -1 if the text is invalid.
+ */
+int hex_test_per_character(int (*convert)(char), const char* hex, int length,
+        uint8_t* bytes) {
+
+    int high;
+    int low;
+
+    for (int i = 0; i < length / 2; i++) {
+
+        high = convert(hex[i * 2]);
+        low = convert(hex[(i * 2) + 1]);
+
+        if (high < 0 || low < 0) {
+            return -1;
+        }
+
+        bytes[i] = (high << 4) | low;
+    }
+
+    return (length % 2) ? -1 : length / 2;
+}
+
+/**
+ * Gets the time in microseconds.
+ * 
+ * Returns: the time (us).
+ */
+long hex_test_now(void) {
+
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec * 1000000L) + (now.tv_nsec / 1000);
+}
+
+/**
+ * Checks the converters without the firmware running.
+ * 
+ * Returns: None
+ */
+void hex_test_convert(void) {
+
+    uint8_t bytes[256];
+    uint8_t back[256];
+    char hex[513];
+    int offset;
+    int wrong = 0;
+
+    // The table gives the same value as the branches for every character.
+    for (int i = 0; i < 256; i++) {
+        if (s4743527_lib_console_ascii2hex((char) i) != hex_test_branches((char) i)) {
+            wrong++;
+        }
+    }
+    SIM_CHECK(wrong == 0);
+
+    // Every byte converts to hex and back.
+    for (int i = 0; i < 256; i++) {
+        bytes[i] = i;
+    }
+    SIM_CHECK(s4743527_lib_console_bytes2hex(bytes, 256, hex) == 512 && hex[512] == '\0');
+    SIM_CHECK(strncmp(hex, "000102", 6) == 0 && strcmp(&hex[506], "FDFEFF") == 0);
+    SIM_CHECK(s4743527_lib_console_hex2bytes(hex, 512, back, &offset) == 256);
+    SIM_CHECK(memcmp(bytes, back, 256) == 0);
+
+    // Either case is taken.
+    SIM_CHECK(s4743527_lib_console_hex2bytes("aBcD", 4, back, &offset) == 2 &&
+            back[0] == 0xAB && back[1] == 0xCD);
+
+    // The first invalid character is found in either digit of a byte.
+    SIM_CHECK(s4743527_lib_console_hex2bytes("12G4", 4, back, &offset) == -1 && offset == 2);
+    SIM_CHECK(s4743527_lib_console_hex2bytes("123G", 4, back, &offset) == -1 && offset == 3);
+    SIM_CHECK(s4743527_lib_console_hex2bytes("1 GG", 4, back, &offset) == -1 && offset == 1);
+    SIM_CHECK(s4743527_lib_console_hex2bytes("12\xFF" "4", 4, back, &offset) == -1 &&
+            offset == 2);
+
+    // Odd lengths are invalid at the end, unless a character before is.
+    SIM_CHECK(s4743527_lib_console_hex2bytes("123", 3, back, &offset) == -1 && offset == 3);
+    SIM_CHECK(s4743527_lib_console_hex2bytes("1x3", 3, back, &offset) == -1 && offset == 1);
+    SIM_CHECK(s4743527_lib_console_hex2bytes("00G", 3, back, &offset) == -1 && offset == 2);
+    SIM_CHECK(s4743527_lib_console_hex2bytes("", 0, back, &offset) == 0);
+}
+
+/**
+ * Converts frames of hex text with a per-character converter, timing it.
+ * 
+ * convert: the per-character converter.
+ * hex: the frames.
+ * sum: added to with the bytes, so the conversion is not left out.
+ * 
+ * Returns: the time taken (us).
+ */
+long hex_test_time(int (*convert)(char), char hex[][(HEX_TEST_FRAME * 2) + 1],
+        volatile int* sum) {
+
+    uint8_t bytes[HEX_TEST_FRAME];
+    long start = hex_test_now();
+
+    for (int i = 0; i < HEX_TEST_FRAMES; i++) {
+        *sum += hex_test_per_character(convert, hex[i], HEX_TEST_FRAME * 2, bytes);
+        *sum += bytes[i % HEX_TEST_FRAME];
+    }
+
+    return hex_test_now() - start;
+}
+
+/**
+ * Converts frames of random hex text with the branches, the table one
+ * character at a time and the bulk converter, reporting the time of each.
+ * 
+ * Returns: None
+ */
+void hex_test_benchmark(void) {
+
+    static char hex[HEX_TEST_FRAMES][(HEX_TEST_FRAME * 2) + 1];
+    uint8_t bytes[HEX_TEST_FRAME];
+    volatile int sum = 0;
+    long bulkTime;
+    long branchTime;
+    long tableTime;
+    long start;
+    int offset;
+
+    srand(1);
+    for (int i = 0; i < HEX_TEST_FRAMES; i++) {
+        for (int j = 0; j < HEX_TEST_FRAME; j++) {
+            bytes[j] = rand();
+        }
+        s4743527_lib_console_bytes2hex(bytes, HEX_TEST_FRAME, hex[i]);
+        if (i % 2) {
+            for (int j = 0; j < HEX_TEST_FRAME * 2; j++) {
+                hex[i][j] = (hex[i][j] >= 'A') ? hex[i][j] + 32 : hex[i][j];
+            }
+        }
+    }
+
+    branchTime = hex_test_time(hex_test_branches, hex, &sum);
+    tableTime = hex_test_time(s4743527_lib_console_ascii2hex, hex, &sum);
+
+    start = hex_test_now();
+    for (int i = 0; i < HEX_TEST_FRAMES; i++) {
+        sum -= 2 * s4743527_lib_console_hex2bytes(hex[i], HEX_TEST_FRAME * 2, bytes, &offset);
+        sum -= 2 * bytes[i % HEX_TEST_FRAME];
+    }
+    bulkTime = hex_test_now() - start;
+
+    SIM_CHECK(sum == 0);
+    SIM_CHECK(bulkTime * HEX_TEST_MIN_SPEEDUP <= branchTime);
+
+    sim_test_report("hex: %d characters, %ld us with branches, %ld us with the table "
+            "per character, %ld us in bulk", HEX_TEST_FRAMES * HEX_TEST_FRAME * 2,
+            branchTime, tableTime, bulkTime);
+}
+
+int main(void) {
+
+    hex_test_convert();
+    hex_test_benchmark();
+
+    return sim_test_result();
+}
\ No newline at end of file
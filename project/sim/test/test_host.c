@@ -0,0 +1,191 @@
+/**
+ **************************************************************
+ * @file project/sim/test/test_host.c
+ * @author agent
+ * @date 18102026
+ * @brief Sends framed move lists and gotos as a host program would, and
+ * checks every move replied to as queued is reached in order, even with
+ * keys pressed meanwhile.
+ ***************************************************************
+ */
+
+#include "sim_test.h"
+#include "s4743527_hostproto.h"
+#include "s4743527_rcmcont.h"
+#include <string.h>
+
+// Number of moves in the move list.
+#define HOST_TEST_MOVES     8
+
+// Key that jogs x forward by the fine step.
+#define HOST_TEST_JOG       "q"
+
+// Global variables
+// Decoder of replies in the output, and the last reply decoded.
+static HostDecoder decoder;
+static uint8_t reply[HOST_PAYLOAD_MAX];
+static volatile int replyLength = 0;
+
+/**
+ * Output hook that decodes replies from the output.
+ * 
+ * text: the output.
+ * length: the number of bytes.
+ * 
+ * Returns: None
+ */
+void host_test_output(const char* text, int length) {
+
+    int decoded;
+
+    for (int i = 0; i < length; i++) {
+        decoded = s4743527_lib_hostproto_decode(&decoder, (uint8_t) text[i]);
+        if (decoded >= 3) {
+            memcpy(reply, decoder.payload, decoded);
+            replyLength = decoded;
+        }
+    }
+}
+
+/**
+ * Writes a position of a request, moving x and y.
+ * 
+ * data: where the position is written.
+ * x: the x position.
+ * y: the y position.
+ * 
+ * Returns: the number of bytes written.
+ */
+int host_test_position(uint8_t* data, int x, int y) {
+
+    memset(data, 0, HOST_POSITION_LENGTH);
+    data[0] = HOST_AXIS_X | HOST_AXIS_Y;
+    data[1] = x & 0xFF;
+    data[2] = (x >> 8) & 0xFF;
+    data[3] = y & 0xFF;
+    data[4] = (y >> 8) & 0xFF;
+
+    return HOST_POSITION_LENGTH;
+}
+
+/**
+ * Sends a request and waits for its reply.
+ * 
+ * request: the payload of the request.
+ * length: the length of the request.
+ * 
+ * Returns: the status of the reply, or -1 if there is none.
+ */
+int host_test_request(const uint8_t* request, int length) {
+
+    uint8_t frame[HOST_ENCODED_MAX];
+
+    replyLength = 0;
+    sim_uart_input((const char*) frame, s4743527_lib_hostproto_encode(request, length, frame));
+
+    for (int wait = 0; wait < 1000; wait++) {
+        if (replyLength >= 3 && reply[0] == (request[0] | HOST_REPLY) && 
+                reply[1] == request[1]) {
+            return reply[2];
+        }
+        vTaskDelay(1);
+    }
+
+    return -1;
+}
+
+/**
+ * Finds the first frame from a number that is at a position.
+ * 
+ * from: the number of the first frame to check.
+ * x: the x position.
+ * y: the y position.
+ * 
+ * Returns: the number of the frame, or -1 if there is none.
+ */
+int host_test_find(int from, int x, int y) {
+
+    int frameX, frameY, frameZ;
+
+    for (int i = from; i < sim_radio_frame_count(); i++) {
+        if (sim_test_frame_position(sim_radio_frame_get(i), &frameX, &frameY, &frameZ) &&
+                frameX == x && frameY == y) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Queues a move list, pressing a key once the first move is reached, then
+ * a goto behind them. Checks each move is reached in order, then the key,
+ * then the goto.
+ * 
+ * Returns: None
+ */
+void test_host(void) {
+
+    uint8_t request[3 + HOST_MAX_MOVES * HOST_POSITION_LENGTH];
+    int xs[HOST_TEST_MOVES] = {40, 80, 80, 40, 40, 120, 120, 40};
+    int ys[HOST_TEST_MOVES] = {40, 40, 80, 80, 120, 120, 160, 160};
+    int fine = s4743527RcmConfig.axis[AXIS_X].step[0];
+    int from, found, last = 0;
+    int reached = 0;
+    int x, y, z;
+
+    s4743527_lib_hostproto_decoder_init(&decoder);
+    sim_output_hook(host_test_output);
+    SIM_CHECK(sim_test_join());
+    SIM_CHECK(sim_test_wait_idle(100, 1000));
+
+    from = sim_radio_frame_count();
+    request[0] = HOST_MOVES;
+    request[1] = 1;
+    request[2] = HOST_TEST_MOVES;
+    for (int i = 0; i < HOST_TEST_MOVES; i++) {
+        host_test_position(&request[3 + i * HOST_POSITION_LENGTH], xs[i], ys[i]);
+    }
+    SIM_CHECK(host_test_request(request, 3 + HOST_TEST_MOVES * HOST_POSITION_LENGTH) == HOST_OK);
+    SIM_CHECK(replyLength == 4 && reply[3] == HOST_TEST_MOVES);
+
+    // A key pressed during the move list is taken once it is done.
+    for (int wait = 0; wait < 5000 && host_test_find(from, xs[0], ys[0]) < 0; wait++) {
+        vTaskDelay(1);
+    }
+    sim_uart_input(HOST_TEST_JOG, 1);
+
+    // A goto is queued behind the move list, not dropped.
+    request[0] = HOST_GOTO;
+    request[1] = 2;
+    host_test_position(&request[2], 20, 20);
+    SIM_CHECK(host_test_request(request, 2 + HOST_POSITION_LENGTH) == HOST_OK);
+    SIM_CHECK(sim_test_wait_idle(300, 10000));
+
+    for (int i = 0; i < HOST_TEST_MOVES; i++) {
+        found = host_test_find(last, xs[i], ys[i]);
+        if (found >= 0) {
+            reached++;
+            last = found;
+        }
+    }
+    SIM_CHECK(reached == HOST_TEST_MOVES);
+
+    // The key moved on from the move list and the goto came after it, in
+    // the order RCM control took them.
+    found = host_test_find(last, xs[HOST_TEST_MOVES - 1] + fine, ys[HOST_TEST_MOVES - 1]);
+    SIM_CHECK(found > last);
+    SIM_CHECK(host_test_find(found, 20, 20) > found);
+    SIM_CHECK(sim_test_frame_position(sim_radio_frame_get(sim_radio_frame_count() - 1),
+            &x, &y, &z) && x == 20 && y == 20);
+
+    sim_test_report("host: %d of %d queued moves reached in order with a key pressed",
+            reached, HOST_TEST_MOVES);
+}
+
+int main(void) {
+
+    sim_test_run(test_host);
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,155 @@
+/**
+ **************************************************************
+ * @file project/sim/test/test_jog.c
+ * @author agent
+ * @date 18102026
+ * @brief Checks held fine keys speed up along the jog curve, capped at the
+ * medium step, other step sizes never speed up, and repeats are timed by
+ * when the keys arrived rather than when they were handled.
+ ***************************************************************
+ */
+
+#include "sim_test.h"
+#include "s4743527_rcmcont.h"
+
+// Time between repeats of a held key (ms), as a terminal sends them.
+#define JOG_TEST_REPEAT 40
+
+// Number of repeats of a held key, past the end of the jog curve.
+#define JOG_TEST_REPEATS 12
+
+// Name of the console task, held while keys arrive.
+#define JOG_TEST_CONSOLE "Console Input"
+
+// Number of keys sent a pause apart while the console is held.
+#define JOG_TEST_PAUSED 4
+
+// Keys that move x forward by the fine and medium steps.
+#define JOG_TEST_FINE   "q"
+#define JOG_TEST_MEDIUM "a"
+
+/**
+ * Gets the x position of the last frame sent, once the move has ended.
+ * 
+ * Returns: the x position, or -1 if there is none.
+ */
+int jog_test_position(void) {
+
+    int x, y, z;
+
+    if (!sim_test_wait_idle(200, 5000) ||
+            !sim_test_frame_position(sim_radio_frame_get(sim_radio_frame_count() - 1),
+                    &x, &y, &z)) {
+        return -1;
+    }
+
+    return x;
+}
+
+/**
+ * Holds a key, sending it a number of times at the repeat rate.
+ * 
+ * key: the key.
+ * repeats: the number of times to send it.
+ * 
+ * Returns: None
+ */
+void jog_test_hold(const char* key, int repeats) {
+
+    for (int i = 0; i < repeats; i++) {
+        sim_uart_input(key, 1);
+        vTaskDelay(JOG_TEST_REPEAT);
+    }
+}
+
+/**
+ * Checks the step sizes of a held key without the firmware running.
+ * 
+ * Returns: None
+ */
+void jog_test_steps(void) {
+
+    int curve[JOG_CURVE_LENGTH] = JOG_CURVE;
+    JogState jog = {-1, 0, 0};
+    TickType_t tick = 1000;
+    int scaled;
+
+    // Each repeat follows the curve until it reaches the cap.
+    for (int i = 0; i < JOG_CURVE_LENGTH; i++) {
+        scaled = s4743527_lib_rcmcont_jog_step(&jog, 0, tick, 2, 10);
+        SIM_CHECK(scaled == ((2 * curve[i] > 10) ? 10 : 2 * curve[i]));
+        tick += JOG_TEST_REPEAT;
+    }
+
+    // Holding past the end of the curve stays at the cap.
+    SIM_CHECK(s4743527_lib_rcmcont_jog_step(&jog, 0, tick, 2, 10) == 10);
+
+    // Another key or a pause starts again from the first step.
+    SIM_CHECK(s4743527_lib_rcmcont_jog_step(&jog, 1, tick, 2, 10) == 2);
+    tick += JOG_TIMEOUT + 1;
+    SIM_CHECK(s4743527_lib_rcmcont_jog_step(&jog, 1, tick, 2, 10) == 2);
+
+    // A step larger than the cap is never cut.
+    jog.key = -1;
+    SIM_CHECK(s4743527_lib_rcmcont_jog_step(&jog, 0, tick, 20, 10) == 20);
+}
+
+/**
+ * Holds the fine and medium x keys in the simulation, checking where each
+ * move ends. Then sends fine keys a pause apart while the console is held,
+ * checking none is taken as a repeat.
+ * 
+ * Returns: None
+ */
+void test_jog(void) {
+
+    int curve[JOG_CURVE_LENGTH] = JOG_CURVE;
+    int fine = s4743527RcmConfig.axis[0].step[0];
+    int medium = s4743527RcmConfig.axis[0].step[1];
+    int expected = 0;
+    int repeat;
+
+    SIM_CHECK(sim_test_join());
+    SIM_CHECK(sim_test_wait_idle(100, 1000));
+
+    // A held fine key speeds up, but never past the medium step.
+    jog_test_hold(JOG_TEST_FINE, JOG_TEST_REPEATS);
+    for (int i = 0; i < JOG_TEST_REPEATS; i++) {
+        repeat = (i < JOG_CURVE_LENGTH) ? i : JOG_CURVE_LENGTH - 1;
+        expected += (fine * curve[repeat] > medium) ? medium : fine * curve[repeat];
+    }
+    SIM_CHECK(jog_test_position() == expected);
+
+    // After a pause it starts again from the fine step.
+    jog_test_hold(JOG_TEST_FINE, 1);
+    expected += fine;
+    SIM_CHECK(jog_test_position() == expected);
+
+    // A held medium key never speeds up.
+    jog_test_hold(JOG_TEST_MEDIUM, 5);
+    expected += 5 * medium;
+    SIM_CHECK(jog_test_position() == expected);
+
+    // Keys that arrived a pause apart each start again from the fine step,
+    // even when the console was held and handles them together.
+    vTaskSuspend(xTaskGetHandle(JOG_TEST_CONSOLE));
+    for (int i = 0; i < JOG_TEST_PAUSED; i++) {
+        sim_uart_input(JOG_TEST_FINE, 1);
+        vTaskDelay(JOG_TIMEOUT + JOG_TEST_REPEAT);
+    }
+    vTaskResume(xTaskGetHandle(JOG_TEST_CONSOLE));
+    expected += JOG_TEST_PAUSED * fine;
+    SIM_CHECK(jog_test_position() == expected);
+
+    sim_test_report("jog: %d fine repeats moved %d", JOG_TEST_REPEATS,
+            expected - fine - 5 * medium - JOG_TEST_PAUSED * fine);
+}
+
+int main(void) {
+
+    jog_test_steps();
+
+    sim_test_run(test_jog);
+
+    return 0;
+}
\ No newline at end of file
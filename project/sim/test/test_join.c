@@ -0,0 +1,40 @@
+/**
+ **************************************************************
+ * @file project/sim/test/test_join.c
+ * @author agent
+ * @date 18102026
+ * @brief Checks the simulation starts and sends JOIN for the pushbutton.
+ ***************************************************************
+ */
+
+#include "sim_test.h"
+#include <string.h>
+
+/**
+ * Presses the pushbutton, then checks JOIN is the first frame sent and
+ * nothing else follows without input.
+ * 
+ * Returns: None
+ */
+void test_join(void) {
+
+    char text[SIM_RADIO_PACKET_SIZE];
+
+    SIM_CHECK(sim_radio_frame_count() == 0);
+
+    sim_button_press();
+    SIM_CHECK(sim_test_wait_frames(1, 100));
+
+    sim_test_frame_text(sim_radio_frame_get(0), text);
+    SIM_CHECK(strcmp(text, "JOIN") == 0);
+
+    vTaskDelay(200);
+    SIM_CHECK(sim_radio_frame_count() == 1);
+}
+
+int main(void) {
+
+    sim_test_run(test_join);
+
+    return 0;
+}
\ No newline at end of file
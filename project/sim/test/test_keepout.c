@@ -0,0 +1,255 @@
+/**
+ **************************************************************
+ * @file project/sim/test/test_keepout.c
+ * @author agent
+ * @date 18102026
+ * @brief Checks paths are stopped at the last free point before a keep-out
+ * zone, on diagonals past a corner, leaving a zone and at the edges of the
+ * 4 unit cells, and that moves and setpoints stopped are counted. A
+ * setpoint stopped by the trajectory task becomes the state RCM control
+ * moves on from and saves.
+ ***************************************************************
+ */
+
+#include "sim_test.h"
+#include "s4743527_rcmkeepout.h"
+#include "s4743527_bkpsram.h"
+#include <string.h>
+
+// Zone the diagonals are checked against, covering whole cells.
+#define KEEPOUT_TEST_SQUARE {40, 40, 59, 59, 0, 99}
+
+// Zone in the way of a move from RCM control, and the x position the
+// move stops at, the last one before the cell the zone starts in.
+#define KEEPOUT_TEST_MOVE_ZONE  "/K ADD 90 90 110 110 0 99\r"
+#define KEEPOUT_TEST_MOVE_STOP  87
+
+// Zone added in the way of a move under way, and the x position the
+// trajectory task stops it at.
+#define KEEPOUT_TEST_SETPOINT_ZONE  "/K ADD 130 90 140 110 0 99\r"
+#define KEEPOUT_TEST_SETPOINT_STOP  127
+
+// Key that moves back from the zone by a fine step, and where it moves to.
+#define KEEPOUT_TEST_BACK_KEY   "w"
+#define KEEPOUT_TEST_BACK_X     (KEEPOUT_TEST_SETPOINT_STOP - 2)
+
+/**
+ * Sweeps a path, returning where it ends.
+ * 
+ * x1: the x position the path starts at.
+ * y1: the y position the path starts at.
+ * z1: the z position the path starts at.
+ * x2: the x position the path ends at.
+ * y2: the y position the path ends at.
+ * z2: the z position the path ends at.
+ * end: the position the path ends at, moved back if it is stopped.
+ * 
+ * Returns: 1 if the path was stopped, 0 otherwise.
+ */
+int keepout_test_sweep(int x1, int y1, int z1, int x2, int y2, int z2, RCMData* end) {
+
+    RCMData from;
+
+    memset(&from, 0, sizeof(from));
+    memset(end, 0, sizeof(*end));
+    from.xPos = x1;
+    from.yPos = y1;
+    from.zPos = z1;
+    end->xPos = x2;
+    end->yPos = y2;
+    end->zPos = z2;
+
+    return s4743527_lib_rcmkeepout_sweep(&from, end);
+}
+
+/**
+ * Adds a zone.
+ * 
+ * values: the minimum x and y, maximum x and y, and minimum and maximum z.
+ * 
+ * Returns: 0 if added, -1 otherwise.
+ */
+int keepout_test_add(const int values[6]) {
+
+    KeepoutZone zone = {values[0], values[1], values[2], values[3], values[4], values[5]};
+
+    return s4743527_lib_rcmkeepout_add(&zone);
+}
+
+/**
+ * Checks zones and sweeps without the firmware running.
+ * 
+ * Returns: None
+ */
+void keepout_test_sweeps(void) {
+
+    const int square[6] = KEEPOUT_TEST_SQUARE;
+    const int small[6] = {41, 41, 42, 42, 0, 9};
+    const int edge[6] = {198, 0, 250, 3, 0, 9};
+    const int beside[6] = {80, 40, 90, 59, 0, 99};
+    const int band[6] = {40, 40, 59, 59, 20, 29};
+    RCMData end;
+
+    s4743527_lib_rcmkeepout_clear();
+    SIM_CHECK(keepout_test_add(square) == 0);
+
+    // A diagonal across the corner stops on the last point before it.
+    SIM_CHECK(keepout_test_sweep(20, 20, 0, 80, 80, 0, &end) == 1 &&
+            end.xPos == 39 && end.yPos == 39 && end.zPos == 0);
+    SIM_CHECK(keepout_test_sweep(30, 50, 0, 50, 30, 0, &end) == 1 &&
+            end.xPos == 39 && end.yPos == 41);
+
+    // A diagonal past the corner, through the cells either side of it,
+    // is not stopped.
+    SIM_CHECK(keepout_test_sweep(20, 59, 0, 59, 20, 0, &end) == 0 &&
+            end.xPos == 59 && end.yPos == 20);
+
+    // A path from inside a zone may leave it, but not enter another.
+    SIM_CHECK(keepout_test_sweep(50, 50, 0, 100, 50, 0, &end) == 0 && end.xPos == 100);
+    SIM_CHECK(keepout_test_sweep(45, 45, 0, 55, 55, 0, &end) == 0 && end.xPos == 55);
+    SIM_CHECK(keepout_test_add(beside) == 0);
+    SIM_CHECK(keepout_test_sweep(50, 50, 0, 100, 50, 0, &end) == 1 &&
+            end.xPos == 79 && end.yPos == 50);
+
+    // A zone blocks every cell it touches, from the start of the cell its
+    // minimum is in to the end of the cell its maximum is in.
+    s4743527_lib_rcmkeepout_clear();
+    SIM_CHECK(keepout_test_add(small) == 0);
+    SIM_CHECK(s4743527_lib_rcmkeepout_blocked(40, 40, 0));
+    SIM_CHECK(s4743527_lib_rcmkeepout_blocked(43, 43, 9));
+    SIM_CHECK(!s4743527_lib_rcmkeepout_blocked(39, 41, 0));
+    SIM_CHECK(!s4743527_lib_rcmkeepout_blocked(44, 41, 0));
+    SIM_CHECK(!s4743527_lib_rcmkeepout_blocked(41, 41, 10));
+    SIM_CHECK(keepout_test_sweep(30, 41, 0, 60, 41, 0, &end) == 1 && end.xPos == 39);
+
+    // A zone past the grid is cut to its last cell, which is only partly
+    // inside the grid. Positions off the grid are never blocked.
+    SIM_CHECK(keepout_test_add(edge) == 0);
+    SIM_CHECK(!s4743527_lib_rcmkeepout_blocked(195, 0, 0));
+    SIM_CHECK(s4743527_lib_rcmkeepout_blocked(196, 3, 0));
+    SIM_CHECK(s4743527_lib_rcmkeepout_blocked(X_MAX, 0, 0));
+    SIM_CHECK(!s4743527_lib_rcmkeepout_blocked(X_MAX + 1, 0, 0));
+    SIM_CHECK(!s4743527_lib_rcmkeepout_blocked(-1, 0, 0));
+    SIM_CHECK(!s4743527_lib_rcmkeepout_blocked(196, 4, 0));
+    SIM_CHECK(keepout_test_sweep(180, 2, 0, X_MAX, 2, 0, &end) == 1 && end.xPos == 195);
+
+    // Z is checked by band, so moving up into a zone stops below its band.
+    s4743527_lib_rcmkeepout_clear();
+    SIM_CHECK(keepout_test_add(band) == 0);
+    SIM_CHECK(keepout_test_sweep(50, 50, 0, 50, 50, 50, &end) == 1 && end.zPos == 19);
+    SIM_CHECK(keepout_test_sweep(50, 50, 30, 50, 50, 50, &end) == 0 && end.zPos == 50);
+
+    // Zones with a minimum above their maximum are rejected.
+    SIM_CHECK(keepout_test_add((const int[6]) {10, 10, 5, 20, 0, 99}) == -1);
+
+    s4743527_lib_rcmkeepout_clear();
+}
+
+/**
+ * Finds the furthest x position of the frames from a number.
+ * 
+ * from: the number of the first frame to check.
+ * 
+ * Returns: the furthest x position, or -1 if there are no frames.
+ */
+int keepout_test_max_x(int from) {
+
+    int x, y, z;
+    int max = -1;
+
+    for (int i = from; i < sim_radio_frame_count(); i++) {
+        if (sim_test_frame_position(sim_radio_frame_get(i), &x, &y, &z) && x > max) {
+            max = x;
+        }
+    }
+
+    return max;
+}
+
+/**
+ * Gets the x position of the last frame sent.
+ * 
+ * Returns: the x position, or -1 if there are no frames.
+ */
+int keepout_test_last_x(void) {
+
+    int x, y, z;
+
+    if (!sim_test_frame_position(sim_radio_frame_get(sim_radio_frame_count() - 1),
+            &x, &y, &z)) {
+        return -1;
+    }
+
+    return x;
+}
+
+/**
+ * Moves into a zone, which RCM control stops, then adds a zone in the way
+ * of a move under way, which the trajectory task stops, checking where
+ * each stops and that each is counted. Then checks RCM control took and
+ * saved where the trajectory task stopped, and moves on from it.
+ * 
+ * Returns: None
+ */
+void test_keepout(void) {
+
+    uint32_t moves;
+    uint32_t setpoints;
+    RCMRecord record;
+    int from;
+
+    SIM_CHECK(sim_test_join());
+
+    sim_uart_input("/K CLEAR\r", 9);
+    sim_uart_input("/G 50 100 0\r", 12);
+    SIM_CHECK(sim_test_wait_idle(200, 5000));
+
+    moves = s4743527KeepoutStats.moves;
+    setpoints = s4743527KeepoutStats.setpoints;
+
+    // RCM control stops a move to a target past a zone.
+    from = sim_radio_frame_count();
+    sim_uart_input(KEEPOUT_TEST_MOVE_ZONE, strlen(KEEPOUT_TEST_MOVE_ZONE));
+    sim_uart_input("/G 150 100 0\r", 13);
+    SIM_CHECK(sim_test_wait_idle(200, 5000));
+
+    SIM_CHECK(keepout_test_max_x(from) == KEEPOUT_TEST_MOVE_STOP);
+    SIM_CHECK(s4743527KeepoutStats.moves == moves + 1);
+    SIM_CHECK(s4743527KeepoutStats.setpoints == setpoints);
+
+    // The trajectory task stops a move under way at a zone added after RCM
+    // control checked it.
+    from = sim_radio_frame_count();
+    sim_uart_input("/K CLEAR\r", 9);
+    sim_uart_input("/G 150 100 0\r", 13);
+    vTaskDelay(100);
+    sim_uart_input(KEEPOUT_TEST_SETPOINT_ZONE, strlen(KEEPOUT_TEST_SETPOINT_ZONE));
+    SIM_CHECK(sim_test_wait_idle(200, 5000));
+
+    SIM_CHECK(keepout_test_max_x(from) == KEEPOUT_TEST_SETPOINT_STOP);
+    SIM_CHECK(s4743527KeepoutStats.moves == moves + 1);
+    SIM_CHECK(s4743527KeepoutStats.setpoints == setpoints + 1);
+
+    // RCM control takes where the move stopped as its state, and saves it.
+    SIM_CHECK(s4743527RcmState.xPos == KEEPOUT_TEST_SETPOINT_STOP);
+    SIM_CHECK(s4743527_lib_bkpsram_read(&record, sizeof(RCMRecord)) == 0 &&
+            record.rcm.xPos == KEEPOUT_TEST_SETPOINT_STOP);
+
+    // A key moves on from there, not from the target that was stopped.
+    sim_uart_input(KEEPOUT_TEST_BACK_KEY, 1);
+    SIM_CHECK(sim_test_wait_idle(200, 5000));
+
+    SIM_CHECK(keepout_test_last_x() == KEEPOUT_TEST_BACK_X);
+    SIM_CHECK(s4743527RcmState.xPos == KEEPOUT_TEST_BACK_X);
+    SIM_CHECK(s4743527KeepoutStats.setpoints == setpoints + 1);
+
+    sim_uart_input("/K CLEAR\r", 9);
+}
+
+int main(void) {
+
+    keepout_test_sweeps();
+    sim_test_run(test_keepout);
+
+    return sim_test_result();
+}
\ No newline at end of file
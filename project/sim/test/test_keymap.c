@@ -0,0 +1,153 @@
+/**
+ **************************************************************
+ * @file project/sim/test/test_keymap.c
+ * @author agent
+ * @date 18102026
+ * @brief Checks keymaps are checked before they are loaded, and swapping
+ * keymaps at run time changes which keys move the RCM.
+ ***************************************************************
+ */
+
+#include "sim_test.h"
+#include "s4743527_console.h"
+#include "s4743527_rcmcont.h"
+#include <string.h>
+
+// Output kept to find keymap reports.
+#define KEYMAP_TEST_OUTPUT  4096
+
+// Global variables
+// Output since the last keymap command.
+static char output[KEYMAP_TEST_OUTPUT];
+static int outputLength = 0;
+
+/**
+ * Output hook that keeps the output.
+ * 
+ * text: the output.
+ * length: the number of bytes.
+ * 
+ * Returns: None
+ */
+void keymap_test_output(const char* text, int length) {
+
+    for (int i = 0; i < length && outputLength < KEYMAP_TEST_OUTPUT - 1; i++) {
+        output[outputLength++] = text[i];
+    }
+
+    output[outputLength] = '\0';
+}
+
+/**
+ * Sends a keymap command and checks whether it was reported as invalid.
+ * 
+ * command: the command line.
+ * 
+ * Returns: 1 if the keymap was loaded, 0 if it was invalid or not
+ * reported.
+ */
+int keymap_test_command(const char* command) {
+
+    outputLength = 0;
+    output[0] = '\0';
+
+    sim_uart_input(command, strlen(command));
+    for (int wait = 0; sim_uart_pending() > 0 || strstr(output, "Keymap: ") == NULL; wait++) {
+        if (wait >= 1000) {
+            return 0;
+        }
+        vTaskDelay(1);
+    }
+    vTaskDelay(20);
+
+    return strstr(output, "(invalid)") == NULL;
+}
+
+/**
+ * Sends a key and gets the x position once the move has ended.
+ * 
+ * key: the key to send.
+ * 
+ * Returns: the x position, or -1 if there is none.
+ */
+int keymap_test_key(const char* key) {
+
+    int x, y, z;
+
+    sim_uart_input(key, 1);
+
+    if (!sim_test_wait_idle(250, 5000) ||
+            !sim_test_frame_position(sim_radio_frame_get(sim_radio_frame_count() - 1),
+                    &x, &y, &z)) {
+        return -1;
+    }
+
+    return x;
+}
+
+/**
+ * Checks keymaps that cannot be loaded without the firmware running.
+ * 
+ * Returns: None
+ */
+void keymap_test_load(void) {
+
+    SIM_CHECK(s4743527_lib_console_keymap_load(KEYMAP_QWERTY) == 0);
+    SIM_CHECK(s4743527_lib_console_keymap_load(KEYMAP_AZERTY) == 0);
+
+    // A key bound twice, in either case.
+    SIM_CHECK(s4743527_lib_console_keymap_load("QQERTYASDFGHZXCVBN12345") == -1);
+    SIM_CHECK(s4743527_lib_console_keymap_load("QqERTYASDFGHZXCVBN12345") == -1);
+
+    // Too few or too many keys.
+    SIM_CHECK(s4743527_lib_console_keymap_load("QWERTYASDFGHZXCVBN1234") == -1);
+    SIM_CHECK(s4743527_lib_console_keymap_load("QWERTYASDFGHZXCVBN123456") == -1);
+
+    // Keys that are not printable or already have a fixed action.
+    SIM_CHECK(s4743527_lib_console_keymap_load("QWERTYASDFGHZXCVBN1234 ") == -1);
+    SIM_CHECK(s4743527_lib_console_keymap_load("QWERTYASDFGHZXCVBN1234\x7F") == -1);
+    SIM_CHECK(s4743527_lib_console_keymap_load("QWERTYASDFGHZXCVBN1234/") == -1);
+    SIM_CHECK(s4743527_lib_console_keymap_load("QWERTYASDFGHZXCVBN1234M") == -1);
+}
+
+/**
+ * Swaps keymaps with the console command, checking the keys that move x
+ * change with them and an invalid keymap leaves the keys as they were.
+ * 
+ * Returns: None
+ */
+void test_keymap(void) {
+
+    int fine = s4743527RcmConfig.axis[AXIS_X].step[0];
+    int medium = s4743527RcmConfig.axis[AXIS_X].step[1];
+    int x = 0;
+
+    sim_output_hook(keymap_test_output);
+    SIM_CHECK(sim_test_join());
+    SIM_CHECK(sim_test_wait_idle(100, 1000));
+
+    // In AZERTY, A moves x by the fine step and Q by the medium step.
+    SIM_CHECK(keymap_test_command("/L AZERTY\r"));
+    SIM_CHECK(keymap_test_key("a") == (x += fine));
+    SIM_CHECK(keymap_test_key("q") == (x += medium));
+
+    // An invalid keymap is reported and the keys stay as they were.
+    SIM_CHECK(!keymap_test_command("/L SET AAERTYQSDFGHWXCVBN12345\r"));
+    SIM_CHECK(!keymap_test_command("/L DVORAK\r"));
+    SIM_CHECK(keymap_test_key("a") == (x += fine));
+
+    // Back in QWERTY, Q moves x by the fine step again.
+    SIM_CHECK(keymap_test_command("/L QWERTY\r"));
+    SIM_CHECK(keymap_test_key("q") == (x += fine));
+
+    sim_test_report("keymap: swapped 2 keymaps at run time, 2 invalid rejected");
+}
+
+int main(void) {
+
+    keymap_test_load();
+
+    sim_test_run(test_keymap);
+
+    return 0;
+}
\ No newline at end of file
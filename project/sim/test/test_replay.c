@@ -0,0 +1,131 @@
+/**
+ **************************************************************
+ * @file project/sim/test/test_replay.c
+ * @author agent
+ * @date 18102026
+ * @brief Replays a keystroke trace and measures the latency of each key.
+ * The trace is test/trace_jog.txt, or any trace dumped with R DUMP named
+ * by RCMSIM_TRACE, e.g.
+ * 
+ *   RCMSIM_TRACE=trace.txt ./obj/test_replay > /dev/null 2> replay.log
+ * 
+ * Each key is logged to stderr as LATENCY with the time until the first
+ * radio frame sent after it, and a summary is reported.
+ ***************************************************************
+ */
+
+#include "sim_test.h"
+#include "board.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Trace replayed when none is named.
+#define REPLAY_TEST_TRACE   "test/trace_jog.txt"
+
+// Most time from a key to the frame it causes (ms), two trajectory periods
+// as a key may arrive just after a setpoint is sent.
+#define REPLAY_TEST_MAX_LATENCY 40
+
+// Global variables
+// Latency of each key with a frame (ms).
+static int latency[SIM_UART_LOG_LENGTH];
+
+/**
+ * Compares two latencies for sorting.
+ * 
+ * a: the first latency.
+ * b: the second latency.
+ * 
+ * Returns: less than, equal to, or greater than 0 as a is less than, equal
+ * to, or greater than b.
+ */
+int replay_test_compare(const void* a, const void* b) {
+
+    return *(const int*) a - *(const int*) b;
+}
+
+/**
+ * Finds the first frame sent after a key and before the next key.
+ * 
+ * number: the number of the key.
+ * from: the number of the first frame to check, updated past the frames
+ * before the key.
+ * 
+ * Returns: the frame, or NULL if the key caused none.
+ */
+const SimFrame* replay_test_frame(int number, int* from) {
+
+    const SimKey* key = sim_uart_key_get(number);
+    const SimKey* next = sim_uart_key_get(number + 1);
+    const SimFrame* frame;
+
+    while ((frame = sim_radio_frame_get(*from)) != NULL &&
+            (int32_t) (frame->tick - key->tick) < 0) {
+        (*from)++;
+    }
+
+    if (frame == NULL || (next != NULL && (int32_t) (frame->tick - next->tick) >= 0)) {
+        return NULL;
+    }
+
+    return frame;
+}
+
+/**
+ * Waits until the whole trace has been received and the stage has stopped,
+ * then matches each key with the first frame sent after it.
+ * 
+ * Returns: None
+ */
+void test_replay(void) {
+
+    const SimFrame* frame;
+    const SimKey* key;
+    int from = 0;
+    int count = 0;
+    int total = 0;
+
+    while (sim_uart_pending() > 0) {
+        vTaskDelay(10);
+    }
+    SIM_CHECK(sim_test_wait_idle(300, 10000));
+    SIM_CHECK(sim_uart_key_count() > 0);
+
+    for (int i = 0; i < sim_uart_key_count(); i++) {
+
+        key = sim_uart_key_get(i);
+
+        if ((frame = replay_test_frame(i, &from)) == NULL) {
+            fprintf(stderr, "LATENCY %d KEY %02X none\n", i, key->key);
+            continue;
+        }
+
+        latency[count] = frame->tick - key->tick;
+        fprintf(stderr, "LATENCY %d KEY %02X %d ms\n", i, key->key, latency[count]);
+        total += latency[count];
+        count++;
+    }
+
+    SIM_CHECK(count > 0);
+    if (count == 0) {
+        return;
+    }
+
+    qsort(latency, count, sizeof(latency[0]), replay_test_compare);
+    SIM_CHECK(latency[count - 1] <= REPLAY_TEST_MAX_LATENCY);
+
+    sim_test_report("replay: %d keys, %d with frames, latency min %d mean %d "
+            "95th %d max %d ms", sim_uart_key_count(), count, latency[0], total / count,
+            latency[(count * 95) / 100], latency[count - 1]);
+}
+
+int main(void) {
+
+    if (getenv(SIM_TRACE_ENV) == NULL) {
+        setenv(SIM_TRACE_ENV, REPLAY_TEST_TRACE, 1);
+    }
+
+    sim_test_run(test_replay);
+
+    return 0;
+}
\ No newline at end of file
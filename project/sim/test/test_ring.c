@@ -0,0 +1,123 @@
+/**
+ **************************************************************
+ * @file project/sim/test/test_ring.c
+ * @author agent
+ * @date 18102026
+ * @brief Checks the UART receive ring buffer with a producer and consumer
+ * running at the same time.
+ ***************************************************************
+ */
+
+#include "sim_test.h"
+#include "s4743527_uartrx.h"
+#include <pthread.h>
+#include <sched.h>
+
+// Number of bytes passed through the ring buffer.
+#define RING_TEST_COUNT 4000000
+
+// Global variables
+// Ring buffer shared by the two threads.
+static UartRxRing ring;
+
+// Number of times each side found the ring buffer full or empty.
+static int fullCount = 0;
+static int emptyCount = 0;
+
+// Number of bytes the consumer received out of order or with the wrong
+// time.
+static int wrongCount = 0;
+
+/**
+ * Gets the byte sent as a number in the sequence, which does not repeat
+ * with the size of the ring buffer.
+ * 
+ * number: the number in the sequence.
+ * 
+ * Returns: the byte.
+ */
+uint8_t ring_test_value(int number) {
+
+    return (uint8_t) ((number * 7) ^ (number >> 8));
+}
+
+/**
+ * Thread that adds the sequence to the ring buffer, as the interrupt does,
+ * retrying while the ring buffer is full.
+ * 
+ * arg: unused.
+ * 
+ * Returns: NULL
+ */
+void* ring_test_producer(void* arg) {
+
+    for (int i = 0; i < RING_TEST_COUNT; i++) {
+        while (s4743527_lib_uartrx_ring_put(&ring, ring_test_value(i), i) != 0) {
+            fullCount++;
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Thread that removes the sequence from the ring buffer, as the console
+ * does, counting bytes that are not next in the sequence.
+ * 
+ * arg: unused.
+ * 
+ * Returns: NULL
+ */
+void* ring_test_consumer(void* arg) {
+
+    uint8_t value;
+    uint32_t tick;
+
+    for (int i = 0; i < RING_TEST_COUNT; i++) {
+
+        while (s4743527_lib_uartrx_ring_get(&ring, &value, &tick) != 0) {
+            emptyCount++;
+            sched_yield();
+        }
+
+        if (value != ring_test_value(i) || tick != (uint32_t) i) {
+            wrongCount++;
+        }
+    }
+
+    return NULL;
+}
+
+int main(void) {
+
+    pthread_t producer;
+    pthread_t consumer;
+    uint8_t value;
+    uint32_t tick;
+
+    // The ring buffer holds one less byte than its size.
+    for (int i = 0; i < UARTRX_RING_SIZE - 1; i++) {
+        SIM_CHECK(s4743527_lib_uartrx_ring_put(&ring, i, 1000 + i) == 0);
+    }
+    SIM_CHECK(s4743527_lib_uartrx_ring_put(&ring, 0, 0) == -1);
+
+    for (int i = 0; i < UARTRX_RING_SIZE - 1; i++) {
+        SIM_CHECK(s4743527_lib_uartrx_ring_get(&ring, &value, &tick) == 0 &&
+                value == i && tick == 1000 + i);
+    }
+    SIM_CHECK(s4743527_lib_uartrx_ring_get(&ring, &value, &tick) == -1);
+
+    pthread_create(&consumer, NULL, ring_test_consumer, NULL);
+    pthread_create(&producer, NULL, ring_test_producer, NULL);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+
+    SIM_CHECK(wrongCount == 0);
+    SIM_CHECK(s4743527_lib_uartrx_ring_get(&ring, &value, &tick) == -1);
+
+    sim_test_report("ring: %d bytes, %d wrong, %d full waits, %d empty waits",
+            RING_TEST_COUNT, wrongCount, fullCount, emptyCount);
+
+    return sim_test_result();
+}
@@ -0,0 +1,481 @@
+/**
+ **************************************************************
+ * @file project/sim/test/test_scan.c
+ * @author agent
+ * @date 18102026
+ * @brief Checks the serpentine order of scans, and that a scan paused
+ * part-way stops releasing moves and an abort ends it, reporting the time
+ * of each move. Checks Z stacks sweep in either direction and return to
+ * where they started, even when aborted, and time-lapses visit their
+ * positions nearest first and report how late each cycle started.
+ ***************************************************************
+ */
+
+#include "sim_test.h"
+#include "s4743527_rcmscan.h"
+#include "s4743527_rcmtraj.h"
+#include <stdio.h>
+#include <string.h>
+
+// Scan of a rectangle with a step that does not divide its width and an
+// odd number of rows, and the positions it visits in order.
+#define SCAN_TEST_TILE      "/S 0 0 25 20 10 0 50\r"
+#define SCAN_TEST_TILE_MOVES    9
+#define SCAN_TEST_TILE_X    {0, 10, 20, 20, 10, 0, 0, 10, 20}
+#define SCAN_TEST_TILE_Y    {0, 0, 0, 10, 10, 10, 20, 20, 20}
+
+// Scan paused part-way, with a dwell long enough to pause it during.
+#define SCAN_TEST_LONG      "/S 0 0 40 40 10 0 200\r"
+#define SCAN_TEST_LONG_MOVES    25
+
+// Number of moves released before the long scan is paused, and the time
+// it is left paused (ms).
+#define SCAN_TEST_PAUSE_AFTER   3
+#define SCAN_TEST_PAUSE_TIME    600
+
+// Z stack swept down, from above the z position it starts at, and a Z
+// stack swept up that is aborted part-way.
+#define SCAN_TEST_ZSTACK_START  20
+#define SCAN_TEST_ZSTACK_DOWN   "/Z 40 10 10 50\r"
+#define SCAN_TEST_ZSTACK_DOWN_Z {40, 30, 20, 10, SCAN_TEST_ZSTACK_START}
+#define SCAN_TEST_ZSTACK_DOWN_MOVES 5
+#define SCAN_TEST_ZSTACK_UP     "/Z 30 90 10 200\r"
+#define SCAN_TEST_ZSTACK_UP_MOVES   8
+
+// Time-lapse positions, added out of order, and the order they are
+// visited in from the origin.
+#define SCAN_TEST_LAPSE_COUNT   3
+#define SCAN_TEST_LAPSE_X   {100, 20, 60}
+#define SCAN_TEST_LAPSE_NEAREST {1, 2, 0}
+
+// Time-lapse run on time, with a period longer than its cycles, and run
+// late, with dwells that make its cycles longer than its period.
+#define SCAN_TEST_LAPSE_ON_TIME "/T RUN 800 0 2\r"
+#define SCAN_TEST_LAPSE_LATE    "/T RUN 100 100 3\r"
+#define SCAN_TEST_LAPSE_LATE_PERIOD 100
+#define SCAN_TEST_LAPSE_LATE_DWELL  100
+
+// Shortest cycle of the late time-lapse (ms), a dwell at each position.
+#define SCAN_TEST_LAPSE_LATE_CYCLE  (SCAN_TEST_LAPSE_COUNT * SCAN_TEST_LAPSE_LATE_DWELL)
+
+// Most a cycle run on time may start late (ms), a period of the trajectory
+// task for the ticks taken to queue the moves of the cycle before and for
+// the host running the simulation's threads late.
+#define SCAN_TEST_LAPSE_MAX_DRIFT   TRAJ_PERIOD
+
+/**
+ * Checks scan paths without the firmware running.
+ * 
+ * Returns: None
+ */
+void scan_test_path(void) {
+
+    int xs[SCAN_TEST_TILE_MOVES] = SCAN_TEST_TILE_X;
+    int ys[SCAN_TEST_TILE_MOVES] = SCAN_TEST_TILE_Y;
+    ScanConfig config;
+    ScanPath path;
+    RCMData target;
+    int count = 0;
+    int wrong = 0;
+
+    memset(&config, 0, sizeof(config));
+    config.xStart = 0;
+    config.yStart = 0;
+    config.xEnd = 25;
+    config.yEnd = 20;
+    config.step = 10;
+    config.zPos = 7;
+
+    // The last column is the last whole step inside the rectangle, and
+    // each row runs the other way to the last.
+    s4743527_lib_rcmscan_path_init(&path, &config);
+    while (s4743527_lib_rcmscan_path_next(&path, &target)) {
+        if (count >= SCAN_TEST_TILE_MOVES || target.xPos != xs[count] ||
+                target.yPos != ys[count] || target.zPos != 7) {
+            wrong++;
+        }
+        count++;
+    }
+    SIM_CHECK(count == SCAN_TEST_TILE_MOVES && wrong == 0);
+    SIM_CHECK(!s4743527_lib_rcmscan_path_next(&path, &target));
+
+    // Corners given the other way round scan the same rectangle.
+    config.xStart = 25;
+    config.xEnd = 0;
+    config.yStart = 20;
+    config.yEnd = 0;
+    s4743527_lib_rcmscan_path_init(&path, &config);
+    count = 0;
+    wrong = 0;
+    while (s4743527_lib_rcmscan_path_next(&path, &target)) {
+        if (count >= SCAN_TEST_TILE_MOVES || target.xPos != xs[count] ||
+                target.yPos != ys[count]) {
+            wrong++;
+        }
+        count++;
+    }
+    SIM_CHECK(count == SCAN_TEST_TILE_MOVES && wrong == 0);
+
+    // A step below 1 is taken as 1, and a single point is one move.
+    config.xStart = config.xEnd = 5;
+    config.yStart = config.yEnd = 5;
+    config.step = 0;
+    s4743527_lib_rcmscan_path_init(&path, &config);
+    SIM_CHECK(s4743527_lib_rcmscan_path_next(&path, &target) &&
+            target.xPos == 5 && target.yPos == 5);
+    SIM_CHECK(!s4743527_lib_rcmscan_path_next(&path, &target));
+}
+
+/**
+ * Checks Z stack plans without the firmware running.
+ * 
+ * Returns: None
+ */
+void scan_test_zstack_plan(void) {
+
+    int zList[ZSTACK_MAX_MOVES];
+
+    // Up and down, ending on the last whole step.
+    SIM_CHECK(s4743527_lib_rcmscan_zstack_plan(10, 35, 10, zList, ZSTACK_MAX_MOVES) == 3 &&
+            zList[0] == 10 && zList[1] == 20 && zList[2] == 30);
+    SIM_CHECK(s4743527_lib_rcmscan_zstack_plan(35, 10, 10, zList, ZSTACK_MAX_MOVES) == 3 &&
+            zList[0] == 35 && zList[1] == 25 && zList[2] == 15);
+
+    // Ends past the z range are clamped to it.
+    SIM_CHECK(s4743527_lib_rcmscan_zstack_plan(90, 150, 5, zList, ZSTACK_MAX_MOVES) == 2 &&
+            zList[0] == 90 && zList[1] == 95);
+    SIM_CHECK(s4743527_lib_rcmscan_zstack_plan(-20, 0, 10, zList, ZSTACK_MAX_MOVES) == 1 &&
+            zList[0] == 0);
+
+    // A step below 1 is taken as 1, and no more moves are planned than fit.
+    SIM_CHECK(s4743527_lib_rcmscan_zstack_plan(0, 99, 0, zList, ZSTACK_MAX_MOVES - 1) ==
+            ZSTACK_MAX_MOVES - 1 && zList[ZSTACK_MAX_MOVES - 2] == ZSTACK_MAX_MOVES - 2);
+    SIM_CHECK(s4743527_lib_rcmscan_zstack_plan(50, 50, 10, zList, ZSTACK_MAX_MOVES) == 1 &&
+            zList[0] == 50);
+}
+
+/**
+ * Checks the nearest neighbour order of time-lapse positions without the
+ * firmware running.
+ * 
+ * Returns: None
+ */
+void scan_test_order(void) {
+
+    RCMData start = {0, 0, 0, 0, 0};
+    RCMData positions[4] = {{100, 0, 0, 0, 0}, {10, 0, 0, 0, 0}, {50, 0, 0, 0, 0},
+            {20, 0, 0, 0, 0}};
+    int order[4];
+
+    // Along a line, each next position is the nearest one left.
+    s4743527_lib_rcmscan_order(&start, positions, 4, order);
+    SIM_CHECK(order[0] == 1 && order[1] == 3 && order[2] == 2 && order[3] == 0);
+
+    // From the far end, the order reverses.
+    start.xPos = 100;
+    s4743527_lib_rcmscan_order(&start, positions, 4, order);
+    SIM_CHECK(order[0] == 0 && order[1] == 2 && order[2] == 3 && order[3] == 1);
+
+    // Distance counts every axis, so a position off in z is visited last.
+    start.xPos = 0;
+    positions[1].zPos = 95;
+    s4743527_lib_rcmscan_order(&start, positions, 4, order);
+    SIM_CHECK(order[0] == 3 && order[1] == 2 && order[2] == 0 && order[3] == 1);
+
+    // Equally near positions are taken in the order they were added.
+    positions[0].xPos = 20;
+    s4743527_lib_rcmscan_order(&start, positions, 2, order);
+    SIM_CHECK(order[0] == 0 && order[1] == 1);
+}
+
+/**
+ * Finds the first frame from a number that is at a z position.
+ * 
+ * from: the number of the first frame to check.
+ * z: the z position.
+ * 
+ * Returns: the number of the frame, or -1 if there is none.
+ */
+int scan_test_find_z(int from, int z) {
+
+    int frameX, frameY, frameZ;
+
+    for (int i = from; i < sim_radio_frame_count(); i++) {
+        if (sim_test_frame_position(sim_radio_frame_get(i), &frameX, &frameY, &frameZ) &&
+                frameZ == z) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Gets the z position of the last frame sent.
+ * 
+ * Returns: the z position, or -1 if there is none.
+ */
+int scan_test_last_z(void) {
+
+    int x, y, z;
+
+    if (!sim_test_frame_position(sim_radio_frame_get(sim_radio_frame_count() - 1),
+            &x, &y, &z)) {
+        return -1;
+    }
+
+    return z;
+}
+
+/**
+ * Finds the first frame from a number that is at a position.
+ * 
+ * from: the number of the first frame to check.
+ * x: the x position.
+ * y: the y position.
+ * 
+ * Returns: the number of the frame, or -1 if there is none.
+ */
+int scan_test_find(int from, int x, int y) {
+
+    int frameX, frameY, frameZ;
+
+    for (int i = from; i < sim_radio_frame_count(); i++) {
+        if (sim_test_frame_position(sim_radio_frame_get(i), &frameX, &frameY, &frameZ) &&
+                frameX == x && frameY == y) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Waits until no scan is running.
+ * 
+ * wait: the most time to wait (ms).
+ * 
+ * Returns: 1 if the scan ended, 0 otherwise.
+ */
+int scan_test_wait_done(TickType_t wait) {
+
+    for (TickType_t waited = 0; waited < wait; waited++) {
+        if (s4743527ScanStats.state == SCAN_IDLE) {
+            return 1;
+        }
+        vTaskDelay(1);
+    }
+
+    return 0;
+}
+
+/**
+ * Runs a Z stack swept down and checks each z position is reached in
+ * order before it returns to the start, then aborts a Z stack swept up
+ * part-way and checks it still returns.
+ * 
+ * Returns: None
+ */
+void scan_test_zstack(void) {
+
+    int zs[SCAN_TEST_ZSTACK_DOWN_MOVES] = SCAN_TEST_ZSTACK_DOWN_Z;
+    int from, found;
+    int reached = 0;
+    int moves;
+    int stackTime;
+
+    sim_uart_input("/G 50 50 20\r", 12);
+    SIM_CHECK(sim_test_wait_idle(200, 5000));
+    SIM_CHECK(scan_test_last_z() == SCAN_TEST_ZSTACK_START);
+
+    from = sim_radio_frame_count();
+    sim_uart_input(SCAN_TEST_ZSTACK_DOWN, strlen(SCAN_TEST_ZSTACK_DOWN));
+    vTaskDelay(100);
+    SIM_CHECK(scan_test_wait_done(5000));
+    SIM_CHECK(sim_test_wait_idle(200, 5000));
+
+    for (int i = 0; i < SCAN_TEST_ZSTACK_DOWN_MOVES; i++) {
+        found = scan_test_find_z(from, zs[i]);
+        if (found >= from) {
+            reached++;
+            from = found;
+        }
+    }
+    SIM_CHECK(reached == SCAN_TEST_ZSTACK_DOWN_MOVES);
+    SIM_CHECK(scan_test_last_z() == SCAN_TEST_ZSTACK_START);
+    SIM_CHECK(s4743527ScanStats.moves == SCAN_TEST_ZSTACK_DOWN_MOVES &&
+            s4743527ScanStats.totalMoves == SCAN_TEST_ZSTACK_DOWN_MOVES);
+    stackTime = s4743527ScanStats.elapsed;
+
+    // Aborted part-way, it still makes the move back to the start.
+    sim_uart_input(SCAN_TEST_ZSTACK_UP, strlen(SCAN_TEST_ZSTACK_UP));
+    for (int wait = 0; wait < 5000 && (s4743527ScanStats.state != SCAN_RUNNING ||
+            s4743527ScanStats.moves < SCAN_TEST_PAUSE_AFTER); wait++) {
+        vTaskDelay(1);
+    }
+    moves = s4743527ScanStats.moves;
+    sim_uart_input("/A\r", 3);
+    SIM_CHECK(scan_test_wait_done(1000));
+    SIM_CHECK(sim_test_wait_idle(200, 5000));
+    SIM_CHECK(s4743527ScanStats.moves == moves + 1 && moves + 1 < SCAN_TEST_ZSTACK_UP_MOVES);
+    SIM_CHECK(s4743527ScanStats.totalMoves == SCAN_TEST_ZSTACK_UP_MOVES);
+    SIM_CHECK(scan_test_last_z() == SCAN_TEST_ZSTACK_START);
+
+    sim_test_report("scan: Z stack of %d moves in %d ms; aborted after %d of %d moves "
+            "and returned to z %d", SCAN_TEST_ZSTACK_DOWN_MOVES, stackTime, moves,
+            SCAN_TEST_ZSTACK_UP_MOVES, SCAN_TEST_ZSTACK_START);
+}
+
+/**
+ * Runs a time-lapse on time and checks its positions are reached nearest
+ * first each cycle, then runs one with cycles longer than its period and
+ * checks it reports them starting later each time.
+ * 
+ * Returns: None
+ */
+void scan_test_timelapse(void) {
+
+    int xs[SCAN_TEST_LAPSE_COUNT] = SCAN_TEST_LAPSE_X;
+    int nearest[SCAN_TEST_LAPSE_COUNT] = SCAN_TEST_LAPSE_NEAREST;
+    char line[32];
+    int from, found;
+    int reached = 0;
+    int onTimeDrift, onTimeCycle;
+
+    sim_uart_input("/G 0 0 0\r", 9);
+    SIM_CHECK(sim_test_wait_idle(200, 5000));
+
+    sim_uart_input("/T CLEAR\r", 9);
+    for (int i = 0; i < SCAN_TEST_LAPSE_COUNT; i++) {
+        snprintf(line, sizeof(line), "/T ADD %d %d 0\r", xs[i], xs[i]);
+        sim_uart_input(line, strlen(line));
+    }
+
+    // The first cycle goes out from the origin, nearest first, and the
+    // second comes back from the last position.
+    from = sim_radio_frame_count();
+    sim_uart_input(SCAN_TEST_LAPSE_ON_TIME, strlen(SCAN_TEST_LAPSE_ON_TIME));
+    vTaskDelay(100);
+    SIM_CHECK(scan_test_wait_done(5000));
+    SIM_CHECK(sim_test_wait_idle(200, 5000));
+
+    for (int i = 0; i < SCAN_TEST_LAPSE_COUNT; i++) {
+        found = scan_test_find(from, xs[nearest[i]], xs[nearest[i]]);
+        if (found >= from) {
+            reached++;
+            from = found;
+        }
+    }
+    for (int i = SCAN_TEST_LAPSE_COUNT - 2; i >= 0; i--) {
+        found = scan_test_find(from, xs[nearest[i]], xs[nearest[i]]);
+        if (found >= from) {
+            reached++;
+            from = found;
+        }
+    }
+    SIM_CHECK(reached == (2 * SCAN_TEST_LAPSE_COUNT) - 1);
+    SIM_CHECK(s4743527ScanStats.cycles == 2);
+    SIM_CHECK(s4743527ScanStats.moves == 2 * SCAN_TEST_LAPSE_COUNT);
+    SIM_CHECK(s4743527ScanStats.drift <= SCAN_TEST_LAPSE_MAX_DRIFT);
+    onTimeDrift = s4743527ScanStats.drift;
+    onTimeCycle = s4743527ScanStats.cycleTime;
+
+    // Cycles longer than the period start later each time, so the third
+    // starts at least two cycles' overrun late.
+    sim_uart_input(SCAN_TEST_LAPSE_LATE, strlen(SCAN_TEST_LAPSE_LATE));
+    vTaskDelay(100);
+    SIM_CHECK(scan_test_wait_done(5000));
+    SIM_CHECK(s4743527ScanStats.cycles == 3);
+    SIM_CHECK(s4743527ScanStats.cycleTime >= SCAN_TEST_LAPSE_LATE_CYCLE);
+    SIM_CHECK(s4743527ScanStats.drift >=
+            2 * (SCAN_TEST_LAPSE_LATE_CYCLE - SCAN_TEST_LAPSE_LATE_PERIOD));
+
+    sim_test_report("scan: time-lapse cycles of %d ms with drift %d ms on time, "
+            "%d ms with drift %d ms by the third cycle late", onTimeCycle, onTimeDrift,
+            (int) s4743527ScanStats.cycleTime, s4743527ScanStats.drift);
+}
+
+/**
+ * Runs a scan and checks its positions are reached in serpentine order,
+ * then pauses and aborts a scan part-way.
+ * 
+ * Returns: None
+ */
+void test_scan(void) {
+
+    int xs[SCAN_TEST_TILE_MOVES] = SCAN_TEST_TILE_X;
+    int ys[SCAN_TEST_TILE_MOVES] = SCAN_TEST_TILE_Y;
+    int from, found;
+    int reached = 0;
+    int moves;
+    int tileTime;
+
+    SIM_CHECK(sim_test_join());
+    SIM_CHECK(sim_test_wait_idle(100, 1000));
+
+    // Start away from the first position, so the move to it is sent.
+    sim_uart_input("/G 50 50 0\r", 11);
+    SIM_CHECK(sim_test_wait_idle(200, 5000));
+
+    // Every position is reached, in order.
+    from = sim_radio_frame_count();
+    sim_uart_input(SCAN_TEST_TILE, strlen(SCAN_TEST_TILE));
+    vTaskDelay(100);
+    SIM_CHECK(scan_test_wait_done(5000));
+    SIM_CHECK(sim_test_wait_idle(200, 5000));
+
+    for (int i = 0; i < SCAN_TEST_TILE_MOVES; i++) {
+        found = scan_test_find(from, xs[i], ys[i]);
+        if (found >= from) {
+            reached++;
+            from = found;
+        }
+    }
+    SIM_CHECK(reached == SCAN_TEST_TILE_MOVES);
+    SIM_CHECK(s4743527ScanStats.moves == SCAN_TEST_TILE_MOVES &&
+            s4743527ScanStats.totalMoves == SCAN_TEST_TILE_MOVES);
+    tileTime = s4743527ScanStats.elapsed;
+
+    // Pausing stops moves being released until it is aborted.
+    sim_uart_input(SCAN_TEST_LONG, strlen(SCAN_TEST_LONG));
+    for (int wait = 0; wait < 5000 && (s4743527ScanStats.state != SCAN_RUNNING ||
+            s4743527ScanStats.moves < SCAN_TEST_PAUSE_AFTER); wait++) {
+        vTaskDelay(1);
+    }
+    sim_uart_input("/P\r", 3);
+    vTaskDelay(100);
+    SIM_CHECK(s4743527ScanStats.state == SCAN_PAUSED);
+    moves = s4743527ScanStats.moves;
+
+    vTaskDelay(SCAN_TEST_PAUSE_TIME);
+    SIM_CHECK(s4743527ScanStats.state == SCAN_PAUSED && s4743527ScanStats.moves == moves);
+
+    sim_uart_input("/A\r", 3);
+    SIM_CHECK(scan_test_wait_done(1000));
+    SIM_CHECK(s4743527ScanStats.moves == moves && moves < SCAN_TEST_LONG_MOVES);
+    SIM_CHECK(s4743527ScanStats.totalMoves == SCAN_TEST_LONG_MOVES);
+
+    // The abort is not kept for the next scan.
+    sim_uart_input(SCAN_TEST_TILE, strlen(SCAN_TEST_TILE));
+    vTaskDelay(100);
+    SIM_CHECK(scan_test_wait_done(5000));
+    SIM_CHECK(s4743527ScanStats.moves == SCAN_TEST_TILE_MOVES);
+
+    sim_test_report("scan: %d moves in %d ms, %d ms each with a 50 ms dwell; "
+            "aborted after %d of %d moves", SCAN_TEST_TILE_MOVES, tileTime,
+            tileTime / SCAN_TEST_TILE_MOVES, moves, SCAN_TEST_LONG_MOVES);
+
+    scan_test_zstack();
+    scan_test_timelapse();
+}
+
+int main(void) {
+
+    scan_test_path();
+    scan_test_zstack_plan();
+    scan_test_order();
+
+    sim_test_run(test_scan);
+
+    return 0;
+}
\ No newline at end of file
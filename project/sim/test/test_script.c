@@ -0,0 +1,217 @@
+/**
+ **************************************************************
+ * @file project/sim/test/test_script.c
+ * @author agent
+ * @date 18102026
+ * @brief Streams scripts as a host would, honouring XON/XOFF, and checks
+ * every command runs and loops too long to repeat are reported.
+ ***************************************************************
+ */
+
+#include "sim_test.h"
+#include "s4743527_rcmscript.h"
+#include "s4743527_uartrx.h"
+#include <stdio.h>
+#include <string.h>
+
+// Number of moves in the streamed script.
+#define SCRIPT_TEST_MOVES   200
+
+// Number of lines the host sends before it next checks for XOFF, as bytes
+// already buffered in a USB serial adapter still go out.
+#define SCRIPT_TEST_HOST_LAG    4
+
+// Number of moves in the body of the long loop.
+#define SCRIPT_TEST_LONG_LOOP   (SCRIPT_LOOP_LENGTH + 8)
+
+// Most bytes of output kept for checks.
+#define SCRIPT_TEST_OUTPUT  (1 << 20)
+
+// Global variables
+// Output sent to the host, and flow control characters seen in it.
+static char output[SCRIPT_TEST_OUTPUT];
+static int outputLength = 0;
+static int paused = 0;
+static int xoffCount = 0;
+static int xonCount = 0;
+
+// Greatest number of commands seen in the lookahead buffer.
+static int greatestFill = 0;
+
+/**
+ * Output hook that keeps the output and follows XON/XOFF, as the host's
+ * serial port does.
+ * 
+ * text: the output.
+ * length: the number of bytes.
+ * 
+ * Returns: None
+ */
+void script_test_output(const char* text, int length) {
+
+    for (int i = 0; i < length; i++) {
+
+        if (text[i] == SCRIPT_XOFF) {
+            paused = 1;
+            xoffCount++;
+        } else if (text[i] == SCRIPT_XON) {
+            paused = 0;
+            xonCount++;
+        }
+
+        if (outputLength < SCRIPT_TEST_OUTPUT - 1) {
+            output[outputLength++] = text[i];
+            output[outputLength] = '\0';
+        }
+    }
+}
+
+/**
+ * Waits a tick, noting how full the lookahead buffer is.
+ * 
+ * Returns: None
+ */
+void script_test_tick(void) {
+
+    int fill = uxQueueMessagesWaiting(s4743527QueueScript);
+
+    if (fill > greatestFill) {
+        greatestFill = fill;
+    }
+
+    vTaskDelay(1);
+}
+
+/**
+ * Sends lines as a host would, checking for XOFF only every few lines and
+ * waiting until XON before sending more.
+ * 
+ * lines: the lines, each ending in a newline.
+ * count: the number of lines.
+ * 
+ * Returns: None
+ */
+void script_test_stream(char lines[][16], int count) {
+
+    for (int i = 0; i < count; i++) {
+
+        if ((i % SCRIPT_TEST_HOST_LAG) == 0) {
+            while (paused) {
+                script_test_tick();
+            }
+        }
+
+        sim_uart_input(lines[i], strlen(lines[i]));
+        while (sim_uart_pending() > 0) {
+            script_test_tick();
+        }
+    }
+}
+
+/**
+ * Waits for the report at the end of a script, reading its counts.
+ * 
+ * from: the output offset to search from.
+ * commands: set to the number of commands run.
+ * bad: set to the number of bad lines.
+ * longLoops: set to the number of loops run once.
+ * time: set to the time taken (ms).
+ * 
+ * Returns: 1 if the report was read, 0 otherwise.
+ */
+int script_test_report(int from, int* commands, int* bad, int* longLoops, int* time) {
+
+    const char* report;
+
+    for (int wait = 0; wait < 20000; wait++) {
+
+        report = strstr(&output[from], "Script: ");
+        while (report != NULL) {
+            if (sscanf(report, "Script: %d commands, %d bad lines, %d long loops in %d ms",
+                    commands, bad, longLoops, time) == 4) {
+                return 1;
+            }
+            report = strstr(report + 1, "Script: ");
+        }
+
+        script_test_tick();
+    }
+
+    return 0;
+}
+
+/**
+ * Streams a long script through flow control, then a script with a loop
+ * too long to repeat.
+ * 
+ * Returns: None
+ */
+void test_script(void) {
+
+    static char lines[SCRIPT_TEST_MOVES + SCRIPT_TEST_LONG_LOOP + 8][16];
+    int count = 0;
+    int from;
+    int commands, bad, longLoops, time;
+    int x, y, z;
+
+    sim_output_hook(script_test_output);
+    SIM_CHECK(sim_test_join());
+    SIM_CHECK(sim_test_wait_idle(100, 1000));
+
+    // Short moves, each sent as one setpoint, so the script runs at the
+    // rate of the trajectory task and the lookahead buffer fills.
+    for (int i = 0; i < SCRIPT_TEST_MOVES; i++) {
+        snprintf(lines[count++], 16, "G1 X%d Y%d\n", (i % 5) * 2, ((i / 5) % 5) * 2);
+    }
+
+    from = outputLength;
+    sim_uart_input("~", 1);
+    script_test_stream(lines, count);
+    sim_uart_input("~", 1);
+
+    SIM_CHECK(script_test_report(from, &commands, &bad, &longLoops, &time));
+    SIM_CHECK(commands == SCRIPT_TEST_MOVES && bad == 0 && longLoops == 0);
+    SIM_CHECK(xoffCount > 0 && xonCount == xoffCount && !paused);
+    SIM_CHECK(greatestFill < SCRIPT_LOOKAHEAD);
+    SIM_CHECK(s4743527UartRxStats.ringOverruns == 0);
+
+    SIM_CHECK(sim_test_wait_idle(200, 5000));
+    SIM_CHECK(sim_test_frame_position(sim_radio_frame_get(sim_radio_frame_count() - 1),
+            &x, &y, &z) && x == 8 && y == 8);
+
+    sim_test_report("script: %d moves in %d ms, %d XOFF, lookahead at most %d of %d",
+            commands, time, xoffCount, greatestFill, SCRIPT_LOOKAHEAD);
+
+    // A loop longer than can be kept runs once and is reported, and the
+    // loop after it still repeats.
+    count = 0;
+    snprintf(lines[count++], 16, "L3\n");
+    for (int i = 0; i < SCRIPT_TEST_LONG_LOOP; i++) {
+        snprintf(lines[count++], 16, "G1 X%d\n", (i % 2) * 2);
+    }
+    snprintf(lines[count++], 16, "E\n");
+    snprintf(lines[count++], 16, "L2\n");
+    snprintf(lines[count++], 16, "G1 X6\n");
+    snprintf(lines[count++], 16, "G1 X8\n");
+    snprintf(lines[count++], 16, "E\n");
+
+    from = outputLength;
+    sim_uart_input("~", 1);
+    script_test_stream(lines, count);
+    sim_uart_input("~", 1);
+
+    SIM_CHECK(script_test_report(from, &commands, &bad, &longLoops, &time));
+    SIM_CHECK(commands == SCRIPT_TEST_LONG_LOOP + 2 * 2 && bad == 0 && longLoops == 1);
+    SIM_CHECK(strstr(&output[from], "loop longer than") != NULL);
+    SIM_CHECK(xonCount == xoffCount && !paused);
+
+    sim_test_report("script: long loop of %d ran once, %d commands",
+            SCRIPT_TEST_LONG_LOOP, commands);
+}
+
+int main(void) {
+
+    sim_test_run(test_script);
+
+    return 0;
+}
\ No newline at end of file
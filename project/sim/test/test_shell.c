@@ -0,0 +1,224 @@
+/**
+ **************************************************************
+ * @file project/sim/test/test_shell.c
+ * @author agent
+ * @date 18102026
+ * @brief Runs every shell command and command line, measuring the most
+ * stack the console task used, and checks the task list when there are
+ * more tasks than it can hold. The stack used by printf alone is measured
+ * in another task and taken off, as the C library here is not the one on
+ * the board.
+ ***************************************************************
+ */
+
+#include "sim_test.h"
+#include "s4743527_console.h"
+#include "s4743527_rcmcont.h"
+#include "s4743527_uarttx.h"
+#include <stdio.h>
+#include <string.h>
+
+// Name of the console task, whose stack is measured.
+#define SHELL_TEST_CONSOLE  "Console Input"
+
+// Most stack the console's own frames may use (bytes), leaving the rest of
+// the board's stack for printf and the saved context.
+#define SHELL_TEST_OWN_STACK    1536
+
+// Output kept to find shell reports.
+#define SHELL_TEST_OUTPUT   16384
+
+// Shell command that writes a part of the axis config, called directly to
+// check parts past the last axis.
+extern int shell_config(char* output, int size, const char* line, int part);
+
+// Global variables
+// Output since the last command.
+static char output[SHELL_TEST_OUTPUT];
+static int outputLength = 0;
+
+// Least free stack of the task that only prints, once it has printed.
+static volatile UBaseType_t printFree = 0;
+
+/**
+ * Output hook that keeps the output.
+ * 
+ * text: the output.
+ * length: the number of bytes.
+ * 
+ * Returns: None
+ */
+void shell_test_output(const char* text, int length) {
+
+    for (int i = 0; i < length && outputLength < SHELL_TEST_OUTPUT - 1; i++) {
+        output[outputLength++] = text[i];
+    }
+
+    output[outputLength] = '\0';
+}
+
+/**
+ * Sends a line and waits until the console has taken it and its output
+ * has been sent.
+ * 
+ * line: the line, with its ending.
+ * 
+ * Returns: None
+ */
+void shell_test_send(const char* line) {
+
+    int length;
+
+    outputLength = 0;
+    output[0] = '\0';
+
+    sim_uart_input(line, strlen(line));
+    while (sim_uart_pending() > 0) {
+        vTaskDelay(1);
+    }
+
+    // Output reaches the terminal a transfer at a time, so wait for the
+    // console to write and for what it wrote to be sent.
+    do {
+        length = outputLength;
+        vTaskDelay(20);
+        s4743527_lib_uarttx_flush(portMAX_DELAY);
+    } while (outputLength != length);
+}
+
+/**
+ * Task that prints a line of the task list and notes its least free stack.
+ * 
+ * Returns: None
+ */
+void shell_test_print(void) {
+
+    s4743527_lib_uarttx_printf("%-16s %c     %8lu %5u\n\r", SHELL_TEST_CONSOLE, 'B', 
+            (unsigned long) TASK_CONSOLE_PRIORITY, (unsigned int) printFree);
+    printFree = uxTaskGetStackHighWaterMark(NULL);
+
+    for (;;) {
+        vTaskDelay(1000);
+    }
+}
+
+/**
+ * Task that does nothing, added so there are more tasks than the shell can
+ * list.
+ * 
+ * Returns: None
+ */
+void shell_test_idle(void) {
+
+    for (;;) {
+        vTaskDelay(1000);
+    }
+}
+
+/**
+ * Checks the config command writes no part past the last axis, without
+ * the firmware running.
+ * 
+ * Returns: None
+ */
+void shell_test_config(void) {
+
+    char text[configCOMMAND_INT_MAX_OUTPUT_SIZE];
+
+    text[0] = '\0';
+    SIM_CHECK(shell_config(text, sizeof(text), "", NUM_OF_AXES) == 0);
+    SIM_CHECK(text[0] == '\0');
+    SIM_CHECK(shell_config(text, sizeof(text), "", -1) == 0);
+    SIM_CHECK(text[0] == '\0');
+}
+
+/**
+ * Runs every shell command and each kind of command line, then reports
+ * the stack the console used. Then adds tasks until the shell cannot list
+ * them all.
+ * 
+ * Returns: None
+ */
+void test_shell(void) {
+
+    TaskHandle_t console = xTaskGetHandle(SHELL_TEST_CONSOLE);
+    const char* commands[] = {
+        "help\r", "status\r", "stats\r", "tasks\r", "radio\r", "goto 10 10 0\r",
+        "config x 0 200 2 10 50\r", "config\r", "nothing\r",
+        "\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\r",
+    };
+    const char* lines[] = {
+        "/G 20 20 0 1 0\r", "/C Y 0 200 2 10 50\r", "/B SAVE 1 HOME\r", "/B LIST\r",
+        "/B 1\r", "/B DEL 1\r", "/K ADD 150 150 160 160 0 10\r", "/K LIST\r",
+        "/K CLEAR\r", "/T ADD 30 30 0\r", "/T CLEAR\r", "/L AZERTY\r", "/L QWERTY\r",
+        "/L\r", "/R REC\r", "/R STOP\r", "/R DUMP\r", "/S 0 0 4 4 2 0 0\r", "/A\r",
+        "/Z 0 4 2 0\r", "/A\r", "\x1B[A", "\x1B[1;5C", "\x1BOP",
+        "/12345678901234567890123456789012345678901234567890\r",
+    };
+    int count;
+    UBaseType_t used;
+    UBaseType_t printUsed;
+
+    sim_output_hook(shell_test_output);
+    SIM_CHECK(console != NULL);
+    SIM_CHECK(sim_test_join());
+    SIM_CHECK(sim_test_wait_idle(100, 1000));
+
+    shell_test_send("\t");
+    for (int i = 0; i < sizeof(commands) / sizeof(commands[0]); i++) {
+        shell_test_send(commands[i]);
+        SIM_CHECK(strstr(output, SHELL_PROMPT) != NULL);
+    }
+
+    // Every axis is listed.
+    shell_test_send("config\r");
+    SIM_CHECK(strstr(output, "ROT") != NULL);
+
+    // Every task is listed while they fit.
+    shell_test_send("tasks\r");
+    SIM_CHECK(strstr(output, SHELL_TEST_CONSOLE) != NULL);
+    shell_test_send("\t");
+
+    for (int i = 0; i < sizeof(lines) / sizeof(lines[0]); i++) {
+        shell_test_send(lines[i]);
+    }
+    SIM_CHECK(sim_test_wait_idle(200, 10000));
+
+    // The console's own frames are what it used less what printf alone
+    // uses, with the same stack.
+    xTaskCreate((void*) &shell_test_print, (const signed char*) "Shell Print", 
+            TASK_CONSOLE_STACK_SIZE, NULL, TASK_CONSOLE_PRIORITY, NULL);
+    while (printFree == 0) {
+        vTaskDelay(1);
+    }
+    used = (TASK_CONSOLE_STACK_SIZE - uxTaskGetStackHighWaterMark(console)) * 
+            sizeof(StackType_t);
+    printUsed = (TASK_CONSOLE_STACK_SIZE - printFree) * sizeof(StackType_t);
+    SIM_CHECK(used > printUsed && used - printUsed <= SHELL_TEST_OWN_STACK);
+
+    sim_test_report("shell: console used %lu stack bytes, %lu of them in printf",
+            (unsigned long) used, (unsigned long) printUsed);
+
+    // With more tasks than can be listed, the count is shown instead.
+    count = uxTaskGetNumberOfTasks();
+    for (int i = count; i <= SHELL_MAX_TASKS; i++) {
+        xTaskCreate((void*) &shell_test_idle, (const signed char*) "Shell Test", 
+                configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY, NULL);
+    }
+    shell_test_send("\t");
+    shell_test_send("tasks\r");
+    SIM_CHECK(strstr(output, "more than") != NULL);
+    SIM_CHECK(strstr(output, SHELL_TEST_CONSOLE) == NULL);
+    shell_test_send("\t");
+
+    sim_test_report("shell: %d tasks listed before the list was full", count);
+}
+
+int main(void) {
+
+    shell_test_config();
+
+    sim_test_run(test_shell);
+
+    return 0;
+}
\ No newline at end of file
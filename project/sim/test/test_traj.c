@@ -0,0 +1,343 @@
+/**
+ **************************************************************
+ * @file project/sim/test/test_traj.c
+ * @author agent
+ * @date 18102026
+ * @brief Checks queued waypoints are each reached in turn before keys
+ * pressed meanwhile, a jog during a jog keeps its speed or slows down
+ * rather than stopping, and a single move heads straight for its target
+ * within its planned time, sooner than the sleeps it replaced.
+ ***************************************************************
+ */
+
+#include "sim_test.h"
+#include "s4743527_rcmtraj.h"
+#include "s4743527_rcmcont.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Greatest change in distance moved between setpoints, one unit of
+// acceleration with a unit for rounding.
+#define TRAJ_TEST_MAX_CHANGE    ((TRAJ_ACCEL >> TRAJ_FRACTION_BITS) + 1)
+
+// Greatest distance moved between setpoints.
+#define TRAJ_TEST_MAX_STEP      (TRAJ_MAX_SPEED >> TRAJ_FRACTION_BITS)
+
+// Time the origin reset slept between its packets before the trajectory
+// task (ms).
+#define TRAJ_TEST_OLD_RESET_TIME    (300 + 500)
+
+// Key that resets the position to the origin.
+#define TRAJ_TEST_HOME          "\x1b[H"
+
+// Keys that jog x forward and back by the coarse step.
+#define TRAJ_TEST_JOG_FORWARD   "z"
+#define TRAJ_TEST_JOG_BACK      "x"
+
+/**
+ * Finds the first frame from a number that is at a position.
+ * 
+ * from: the number of the first frame to check.
+ * x: the x position.
+ * y: the y position.
+ * 
+ * Returns: the number of the frame, or -1 if there is none.
+ */
+int traj_test_find(int from, int x, int y) {
+
+    int frameX, frameY, frameZ;
+
+    for (int i = from; i < sim_radio_frame_count(); i++) {
+        if (sim_test_frame_position(sim_radio_frame_get(i), &frameX, &frameY, &frameZ) &&
+                frameX == x && frameY == y) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Checks the x speed between position frames changes by no more than the
+ * acceleration allows, so the stage never stops or starts suddenly, and
+ * never passes the maximum speed. The last step may be short, as it lands
+ * on the target.
+ * 
+ * from: the number of the first frame to check.
+ * 
+ * Returns: the greatest change in x speed seen.
+ */
+int traj_test_smooth(int from) {
+
+    int x, y, z;
+    int lastX = 0, lastSpeed = 0;
+    int started = 0;
+    int change = 0;
+    int count = sim_radio_frame_count();
+
+    for (int i = from; i < count; i++) {
+
+        if (!sim_test_frame_position(sim_radio_frame_get(i), &x, &y, &z)) {
+            continue;
+        }
+
+        if (started) {
+            SIM_CHECK(abs(x - lastX) <= TRAJ_TEST_MAX_STEP);
+
+            if (i < count - 1 && abs((x - lastX) - lastSpeed) > change) {
+                change = abs((x - lastX) - lastSpeed);
+            }
+            lastSpeed = x - lastX;
+        }
+
+        lastX = x;
+        started = 1;
+    }
+
+    return change;
+}
+
+/**
+ * Waits until the last two position frames show the stage moving at the
+ * maximum speed along x.
+ * 
+ * Returns: 1 if it reached the maximum speed, 0 otherwise.
+ */
+int traj_test_wait_speed(void) {
+
+    int count;
+    int x0, x1, y, z;
+
+    for (int wait = 0; wait < 1000; wait++) {
+
+        count = sim_radio_frame_count();
+
+        if (count >= 2 &&
+                sim_test_frame_position(sim_radio_frame_get(count - 2), &x0, &y, &z) &&
+                sim_test_frame_position(sim_radio_frame_get(count - 1), &x1, &y, &z) &&
+                abs(x1 - x0) == TRAJ_TEST_MAX_STEP) {
+            return 1;
+        }
+
+        vTaskDelay(1);
+    }
+
+    return 0;
+}
+
+/**
+ * Gets the time a trapezoid at the maximum speed and acceleration takes to
+ * cover a distance, rounded up to a whole period.
+ * 
+ * distance: the distance to move.
+ * 
+ * Returns: the time in periods.
+ */
+int traj_test_planned(int distance) {
+
+    int speed = TRAJ_MAX_SPEED >> TRAJ_FRACTION_BITS;
+    int accel = TRAJ_ACCEL >> TRAJ_FRACTION_BITS;
+    int periods = 0;
+
+    // Long enough to reach the maximum speed, so it accelerates, cruises
+    // and decelerates. Otherwise it only accelerates then decelerates.
+    if (distance * accel >= speed * speed) {
+        return ((distance + speed - 1) / speed) + (speed / accel);
+    }
+
+    while (accel * periods * periods < 4 * distance) {
+        periods++;
+    }
+
+    return periods;
+}
+
+/**
+ * Checks a single move from rest is monotonic toward its target along each
+ * axis and ends on it within its planned time, without the firmware
+ * running.
+ * 
+ * Returns: None
+ */
+void traj_test_profile(void) {
+
+    const int distances[] = {5, 11, 40, 64, 150, 200};
+    Trajectory traj;
+    RCMData setpoint;
+    RCMData target;
+    RCMData last;
+    int periods;
+    int monotonic;
+
+    for (int i = 0; i < (int) (sizeof(distances) / sizeof(distances[0])); i++) {
+
+        memset(&traj, 0, sizeof(traj));
+        memset(&setpoint, 0, sizeof(setpoint));
+        target = setpoint;
+        target.xPos = distances[i];
+        target.yPos = distances[i] / 2;
+        target.zPos = distances[i] / 3;
+        traj.start = setpoint;
+        traj.end = setpoint;
+
+        SIM_CHECK(s4743527_lib_rcmtraj_plan(&traj, &setpoint, &target) == 1);
+
+        periods = 0;
+        monotonic = 1;
+        do {
+            last = setpoint;
+            periods++;
+            if (!s4743527_lib_rcmtraj_next(&traj, &setpoint)) {
+                break;
+            }
+            monotonic &= setpoint.xPos > last.xPos && setpoint.yPos >= last.yPos &&
+                    setpoint.zPos >= last.zPos;
+        } while (periods <= traj_test_planned(distances[i]));
+
+        SIM_CHECK(monotonic);
+        SIM_CHECK(setpoint.xPos == target.xPos && setpoint.yPos == target.yPos &&
+                setpoint.zPos == target.zPos);
+        SIM_CHECK(periods <= traj_test_planned(distances[i]));
+    }
+}
+
+/**
+ * Resets a move from the far corner to the origin and checks each axis
+ * only moves toward the origin, and that its setpoints arrive within its
+ * planned time and sooner than the old reset slept.
+ * 
+ * Returns: None
+ */
+void traj_test_reset(void) {
+
+    int x, y, z;
+    int lastX = X_MAX, lastY = Y_MAX, lastZ = Z_MAX;
+    int monotonic = 1;
+    int setpoints = 0;
+    int from;
+    TickType_t start;
+    TickType_t arrival = 0;
+    TickType_t planned = traj_test_planned(X_MAX) * TRAJ_PERIOD;
+
+    sim_uart_input("/G 200 200 99\r", 14);
+    SIM_CHECK(sim_test_wait_idle(200, 5000));
+
+    from = sim_radio_frame_count();
+    start = xTaskGetTickCount();
+    sim_uart_input(TRAJ_TEST_HOME, strlen(TRAJ_TEST_HOME));
+    SIM_CHECK(sim_test_wait_idle(200, 5000));
+
+    for (int i = from; i < sim_radio_frame_count(); i++) {
+        if (sim_test_frame_position(sim_radio_frame_get(i), &x, &y, &z)) {
+            monotonic &= x <= lastX && y <= lastY && z <= lastZ;
+            lastX = x, lastY = y, lastZ = z;
+            setpoints++;
+            arrival = sim_radio_frame_get(i)->tick;
+        }
+    }
+
+    SIM_CHECK(setpoints > 0 && monotonic);
+    SIM_CHECK(lastX == X_MIN && lastY == Y_MIN && lastZ == Z_MIN);
+
+    // The first setpoint is sent at once and each after it a period later,
+    // so the move takes a period less than the setpoints it sends. Frames
+    // reach the radio later than that on a loaded host, so the setpoints
+    // are counted rather than timed.
+    SIM_CHECK((setpoints - 1) * TRAJ_PERIOD < planned);
+    SIM_CHECK((setpoints - 1) * TRAJ_PERIOD < TRAJ_TEST_OLD_RESET_TIME);
+
+    sim_test_report("traj: reset from (%d,%d,%d) in %d setpoints, %d ms apart, planned %lu ms, "
+            "%lu ms from the key, %d ms slept before", X_MAX, Y_MAX, Z_MAX, setpoints,
+            TRAJ_PERIOD, (unsigned long) planned, (unsigned long) (arrival - start),
+            TRAJ_TEST_OLD_RESET_TIME);
+}
+
+/**
+ * Queues three waypoints with goto commands and checks each corner is
+ * reached in order, and a key pressed during a goto waits for it. Then
+ * jogs ahead of and behind a fast jog, and checks the speed carries over
+ * or slows down smoothly.
+ * 
+ * Returns: None
+ */
+void test_traj(void) {
+
+    const char* path = "/G 60 0 0\r/G 60 60 0\r/G 0 60 0\r";
+    int from, first, second, third;
+    int change, greatest = 0;
+    int x, y, z;
+    TickType_t start;
+
+    SIM_CHECK(sim_test_join());
+    SIM_CHECK(sim_test_wait_idle(100, 1000));
+
+    // Each waypoint is queued behind the last, not dropped or replaced.
+    from = sim_radio_frame_count();
+    start = xTaskGetTickCount();
+    sim_uart_input(path, strlen(path));
+    SIM_CHECK(sim_test_wait_idle(200, 5000));
+
+    first = traj_test_find(from, 60, 0);
+    second = traj_test_find(from, 60, 60);
+    third = traj_test_find(from, 0, 60);
+    SIM_CHECK(first >= 0 && second > first && third > second);
+    SIM_CHECK(third == sim_radio_frame_count() - 1);
+    change = traj_test_smooth(from);
+    SIM_CHECK(change <= TRAJ_TEST_MAX_CHANGE);
+    greatest = (change > greatest) ? change : greatest;
+
+    if (third >= 0) {
+        sim_test_report("traj: 3 waypoints in %lu ms, %d frames",
+                (unsigned long) (sim_radio_frame_get(third)->tick - start), third - from + 1);
+    }
+
+    // A key pressed during a goto waits until the goto is reached.
+    from = sim_radio_frame_count();
+    sim_uart_input("/G 150 60 0\r", 12);
+    SIM_CHECK(traj_test_wait_speed());
+    sim_uart_input(TRAJ_TEST_JOG_FORWARD, 1);
+    SIM_CHECK(sim_test_wait_idle(200, 5000));
+
+    SIM_CHECK(traj_test_find(from, 150, 60) >= 0);
+    SIM_CHECK(sim_test_frame_position(sim_radio_frame_get(sim_radio_frame_count() - 1),
+            &x, &y, &z) && x == 200 && y == 60);
+
+    // A jog ahead while at full speed carries the speed into the new move.
+    from = sim_radio_frame_count();
+    sim_uart_input(TRAJ_TEST_JOG_BACK TRAJ_TEST_JOG_BACK, 2);
+    SIM_CHECK(traj_test_wait_speed());
+    sim_uart_input(TRAJ_TEST_JOG_BACK, 1);
+    SIM_CHECK(sim_test_wait_idle(200, 5000));
+
+    SIM_CHECK(sim_test_frame_position(sim_radio_frame_get(sim_radio_frame_count() - 1),
+            &x, &y, &z) && x == 50 && y == 60);
+    change = traj_test_smooth(from);
+    SIM_CHECK(change <= TRAJ_TEST_MAX_CHANGE);
+    greatest = (change > greatest) ? change : greatest;
+
+    // A jog behind while at full speed slows down before turning around.
+    from = sim_radio_frame_count();
+    sim_uart_input(TRAJ_TEST_JOG_FORWARD TRAJ_TEST_JOG_FORWARD TRAJ_TEST_JOG_FORWARD, 3);
+    SIM_CHECK(traj_test_wait_speed());
+    sim_uart_input(TRAJ_TEST_JOG_BACK TRAJ_TEST_JOG_BACK TRAJ_TEST_JOG_BACK, 3);
+    SIM_CHECK(sim_test_wait_idle(200, 5000));
+
+    SIM_CHECK(sim_test_frame_position(sim_radio_frame_get(sim_radio_frame_count() - 1),
+            &x, &y, &z) && x == 50 && y == 60);
+    change = traj_test_smooth(from);
+    SIM_CHECK(change <= TRAJ_TEST_MAX_CHANGE);
+    greatest = (change > greatest) ? change : greatest;
+
+    sim_test_report("traj: greatest change in speed %d units per period", greatest);
+
+    traj_test_reset();
+}
+
+int main(void) {
+
+    traj_test_profile();
+
+    sim_test_run(test_traj);
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+/**
+ **************************************************************
+ * @file project/sim/test/test_uart.c
+ * @author agent
+ * @date 18102026
+ * @brief Checks debug UART input arrives through the receive interrupt at
+ * its line rate, without losing bytes.
+ ***************************************************************
+ */
+
+#include "sim_test.h"
+#include "board.h"
+#include "s4743527_uartrx.h"
+#include <string.h>
+
+// Number of bytes in the burst, longer than the ring buffer.
+#define UART_TEST_BURST 2000
+
+// Key that moves x forward by the fine step.
+#define UART_TEST_KEY   "q"
+
+/**
+ * Types a position key and measures the time until its frame is sent, then
+ * sends a burst of unmapped keys longer than the ring buffer and checks
+ * each is received and none are lost.
+ * 
+ * Returns: None
+ */
+void test_uart(void) {
+
+    char burst[UART_TEST_BURST];
+    uint32_t received = s4743527UartRxStats.received;
+    TickType_t start;
+    TickType_t arrival;
+    int frames;
+    int x, y, z;
+
+    SIM_CHECK(sim_test_join());
+    SIM_CHECK(sim_test_wait_idle(100, 1000));
+    frames = sim_radio_frame_count();
+
+    // A key arrives at the next tick and wakes the console at once.
+    start = xTaskGetTickCount();
+    sim_uart_input(UART_TEST_KEY, 1);
+    if (!sim_test_wait_frames(frames + 1, 100)) {
+        SIM_CHECK(0);
+        return;
+    }
+
+    SIM_CHECK(sim_test_frame_position(sim_radio_frame_get(frames), &x, &y, &z));
+    SIM_CHECK(x > 0 && y == 0 && z == 0);
+    SIM_CHECK(s4743527UartRxStats.received == received + 1);
+
+    sim_test_report("uart: key to frame %lu ms",
+            (unsigned long) (sim_radio_frame_get(frames)->tick - start));
+
+    // A burst takes as long as the line rate needs.
+    memset(burst, 'k', sizeof(burst));
+    received = s4743527UartRxStats.received;
+    start = xTaskGetTickCount();
+    SIM_CHECK(sim_uart_input(burst, sizeof(burst)) == sizeof(burst));
+
+    while (sim_uart_pending() > 0) {
+        vTaskDelay(1);
+    }
+    arrival = xTaskGetTickCount() - start;
+
+    SIM_CHECK(s4743527UartRxStats.received == received + UART_TEST_BURST);
+    SIM_CHECK(s4743527UartRxStats.ringOverruns == 0);
+    // The idle line may have a tick of bytes ready when the burst starts.
+    SIM_CHECK(arrival >= UART_TEST_BURST * SIM_UART_BITS * configTICK_RATE_HZ / SIM_UART_BAUD - 1);
+
+    sim_test_report("uart: %d bytes in %lu ms, %lu ring overruns",
+            UART_TEST_BURST, (unsigned long) arrival,
+            (unsigned long) s4743527UartRxStats.ringOverruns);
+}
+
+int main(void) {
+
+    sim_test_run(test_uart);
+
+    return 0;
+}
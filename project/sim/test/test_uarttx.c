@@ -0,0 +1,141 @@
+/**
+ **************************************************************
+ * @file project/sim/test/test_uarttx.c
+ * @author agent
+ * @date 18102026
+ * @brief Checks debug UART output sent by DMA at its line rate loses no
+ * bytes when written slower than the line carries them, counts the bytes
+ * it drops when written faster, and that a flush waits for both buffers.
+ ***************************************************************
+ */
+
+#include "sim_test.h"
+#include "board.h"
+#include "s4743527_uarttx.h"
+#include <string.h>
+
+// Byte the test writes, which the firmware never sends.
+#define UARTTX_TEST_BYTE    '~'
+
+// Bytes in each write, and the time between writes below the line rate
+// (ms), at 70% of it.
+#define UARTTX_TEST_WRITE   64
+#define UARTTX_TEST_SLOW_PERIOD 8
+#define UARTTX_TEST_SLOW_WRITES 100
+
+// Number of writes sent a tick apart, above the line rate at over five
+// times it.
+#define UARTTX_TEST_FAST_WRITES 300
+
+// Gets the time to send bytes on the line (ms).
+#define UARTTX_TEST_WIRE_TIME(bytes) (((bytes) * SIM_UART_BITS * 1000) / SIM_UART_BAUD)
+
+// Global variables
+// Number of the test's bytes sent on the line.
+static volatile int received = 0;
+
+/**
+ * Output hook that counts the test's bytes.
+ * 
+ * text: the output.
+ * length: the number of bytes.
+ * 
+ * Returns: None
+ */
+void uarttx_test_output(const char* text, int length) {
+
+    for (int i = 0; i < length; i++) {
+        if (text[i] == UARTTX_TEST_BYTE) {
+            received++;
+        }
+    }
+}
+
+/**
+ * Writes at a rate below the line rate, then above it, checking bytes are
+ * only dropped above it, each dropped byte is counted and those sent take
+ * as long as the line needs to carry them. Then fills both buffers and
+ * checks a flush returns only once both have been sent.
+ * 
+ * Returns: None
+ */
+void test_uarttx(void) {
+
+    char data[UARTTX_BUFFER_SIZE];
+    uint32_t dropped;
+    uint32_t transfers;
+    TickType_t start;
+    TickType_t slowTime;
+    TickType_t fastTime;
+    TickType_t flushTime;
+    int written;
+    int fastReceived;
+
+    memset(data, UARTTX_TEST_BYTE, sizeof(data));
+    sim_output_hook(uarttx_test_output);
+
+    SIM_CHECK(s4743527_lib_uarttx_flush(1000) == 0);
+    received = 0;
+
+    // Below the line rate, every byte is sent.
+    dropped = s4743527UartTxStats.dropped;
+    start = xTaskGetTickCount();
+    for (int i = 0; i < UARTTX_TEST_SLOW_WRITES; i++) {
+        SIM_CHECK(s4743527_lib_uarttx_write(data, UARTTX_TEST_WRITE) == 0);
+        vTaskDelay(UARTTX_TEST_SLOW_PERIOD);
+    }
+    SIM_CHECK(s4743527_lib_uarttx_flush(1000) == 0);
+    slowTime = xTaskGetTickCount() - start;
+
+    SIM_CHECK(received == UARTTX_TEST_SLOW_WRITES * UARTTX_TEST_WRITE);
+    SIM_CHECK(s4743527UartTxStats.dropped == dropped);
+
+    // Above the line rate, whole writes are dropped and counted, and every
+    // byte written is either sent or counted.
+    received = 0;
+    written = 0;
+    start = xTaskGetTickCount();
+    for (int i = 0; i < UARTTX_TEST_FAST_WRITES; i++) {
+        s4743527_lib_uarttx_write(data, UARTTX_TEST_WRITE);
+        written += UARTTX_TEST_WRITE;
+        vTaskDelay(1);
+    }
+    SIM_CHECK(s4743527_lib_uarttx_flush(1000) == 0);
+    fastTime = xTaskGetTickCount() - start;
+    fastReceived = received;
+
+    SIM_CHECK(s4743527UartTxStats.dropped > dropped);
+    SIM_CHECK((s4743527UartTxStats.dropped - dropped) % UARTTX_TEST_WRITE == 0);
+    SIM_CHECK(fastReceived + (int) (s4743527UartTxStats.dropped - dropped) == written);
+
+    // Bytes are never sent faster than the line carries them.
+    SIM_CHECK(UARTTX_TEST_WIRE_TIME(fastReceived) <= fastTime);
+
+    // A flush with both buffers full returns once both have been sent.
+    received = 0;
+    transfers = s4743527UartTxStats.transfers;
+    start = xTaskGetTickCount();
+    SIM_CHECK(s4743527_lib_uarttx_write(data, UARTTX_BUFFER_SIZE) == 0);
+    SIM_CHECK(s4743527_lib_uarttx_write(data, UARTTX_BUFFER_SIZE) == 0);
+    SIM_CHECK(s4743527_lib_uarttx_free() == 0);
+    SIM_CHECK(s4743527_lib_uarttx_flush(1000) == 0);
+    flushTime = xTaskGetTickCount() - start;
+
+    SIM_CHECK(received == 2 * UARTTX_BUFFER_SIZE);
+    SIM_CHECK(s4743527UartTxStats.transfers == transfers + 2);
+    SIM_CHECK(flushTime >= UARTTX_TEST_WIRE_TIME(2 * UARTTX_BUFFER_SIZE));
+    SIM_CHECK(s4743527_lib_uarttx_free() == UARTTX_BUFFER_SIZE);
+
+    sim_test_report("uarttx: %d bytes in %lu ms below the line rate with none dropped, "
+            "%d of %d sent above it in %lu ms, two full buffers flushed in %lu ms (%d ms on the wire)",
+            UARTTX_TEST_SLOW_WRITES * UARTTX_TEST_WRITE, (unsigned long) slowTime,
+            fastReceived, written, (unsigned long) fastTime, (unsigned long) flushTime,
+            UARTTX_TEST_WIRE_TIME(2 * UARTTX_BUFFER_SIZE));
+}
+
+int main(void) {
+
+    sim_test_run(test_uarttx);
+
+    return sim_test_result();
+}
\ No newline at end of file
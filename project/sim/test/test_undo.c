@@ -0,0 +1,118 @@
+/**
+ **************************************************************
+ * @file project/sim/test/test_undo.c
+ * @author agent
+ * @date 18102026
+ * @brief Checks undo and redo return to where each move actually ended,
+ * including moves stopped short by a keep-out zone, and that undo after
+ * scans and scripts returns to where each started.
+ ***************************************************************
+ */
+
+#include "sim_test.h"
+#include "s4743527_rcmcont.h"
+#include <string.h>
+
+// Keys that undo and redo a move.
+#define UNDO_TEST_UNDO      "u"
+#define UNDO_TEST_REDO      "i"
+
+// Zone added over a state in history, and the x position an undo to it
+// stops at, the first one past the cell the zone ends in.
+#define UNDO_TEST_ZONE      "/K ADD 96 40 110 60 0 99\r"
+#define UNDO_TEST_STOP      112
+
+// Scans run one after another, and the x and y position each ends at.
+#define UNDO_TEST_SCAN      "/S 0 0 25 20 10 0 50\r"
+#define UNDO_TEST_SCAN_END  20
+#define UNDO_TEST_NEXT_SCAN "/S 60 60 85 80 10 0 50\r"
+#define UNDO_TEST_NEXT_END  80
+
+// Script of two moves, and the x and y position it ends at.
+#define UNDO_TEST_SCRIPT    "~G1 X30 Y30\nG1 X40 Y30\n~"
+#define UNDO_TEST_SCRIPT_X  40
+#define UNDO_TEST_SCRIPT_Y  30
+
+/**
+ * Sends a key or command and gets the x and y position once the move has
+ * ended.
+ * 
+ * input: the key or command to send.
+ * x: set to the x position.
+ * y: set to the y position.
+ * 
+ * Returns: 1 if a position was sent, 0 otherwise.
+ */
+int undo_test_send(const char* input, int* x, int* y) {
+
+    int z;
+
+    sim_uart_input(input, strlen(input));
+
+    return sim_test_wait_idle(200, 5000) &&
+            sim_test_frame_position(sim_radio_frame_get(sim_radio_frame_count() - 1),
+                    x, y, &z);
+}
+
+/**
+ * Moves, undoes and redoes, then undoes to a state a zone now covers, and
+ * undoes after scans and a script.
+ * 
+ * Returns: None
+ */
+void test_undo(void) {
+
+    int x = 0, y = 0;
+
+    SIM_CHECK(sim_test_join());
+    SIM_CHECK(sim_test_wait_idle(100, 1000));
+    sim_uart_input("/K CLEAR\r", 9);
+
+    // Undo and redo step back and forth through gotos.
+    SIM_CHECK(undo_test_send("/G 50 50 0\r", &x, &y) && x == 50);
+    SIM_CHECK(undo_test_send("/G 100 50 0\r", &x, &y) && x == 100);
+    SIM_CHECK(undo_test_send(UNDO_TEST_UNDO, &x, &y) && x == 50 && y == 50);
+    SIM_CHECK(undo_test_send(UNDO_TEST_REDO, &x, &y) && x == 100 && y == 50);
+
+    // An undo stopped by a zone keeps where it stopped, so undo after a
+    // redo returns there rather than to the state it was stopped from.
+    SIM_CHECK(undo_test_send("/G 150 50 0\r", &x, &y) && x == 150);
+    sim_uart_input(UNDO_TEST_ZONE, strlen(UNDO_TEST_ZONE));
+    SIM_CHECK(undo_test_send(UNDO_TEST_UNDO, &x, &y) && x == UNDO_TEST_STOP);
+    sim_uart_input("/K CLEAR\r", 9);
+    SIM_CHECK(undo_test_send(UNDO_TEST_REDO, &x, &y) && x == 150);
+    SIM_CHECK(undo_test_send(UNDO_TEST_UNDO, &x, &y) && x == UNDO_TEST_STOP);
+    SIM_CHECK(s4743527RcmState.xPos == UNDO_TEST_STOP);
+
+    // Undo after scans run one after another returns to where each
+    // started, and redo to where each ended.
+    SIM_CHECK(undo_test_send(UNDO_TEST_SCAN, &x, &y) &&
+            x == UNDO_TEST_SCAN_END && y == UNDO_TEST_SCAN_END);
+    SIM_CHECK(undo_test_send(UNDO_TEST_NEXT_SCAN, &x, &y) &&
+            x == UNDO_TEST_NEXT_END && y == UNDO_TEST_NEXT_END);
+    SIM_CHECK(undo_test_send(UNDO_TEST_UNDO, &x, &y) &&
+            x == UNDO_TEST_SCAN_END && y == UNDO_TEST_SCAN_END);
+    SIM_CHECK(undo_test_send(UNDO_TEST_UNDO, &x, &y) && x == UNDO_TEST_STOP && y == 50);
+    SIM_CHECK(undo_test_send(UNDO_TEST_REDO, &x, &y) &&
+            x == UNDO_TEST_SCAN_END && y == UNDO_TEST_SCAN_END);
+    SIM_CHECK(undo_test_send(UNDO_TEST_REDO, &x, &y) &&
+            x == UNDO_TEST_NEXT_END && y == UNDO_TEST_NEXT_END);
+
+    // Undo after a script run where a scan ended returns to where the
+    // script started, then to where the scan started.
+    SIM_CHECK(undo_test_send(UNDO_TEST_SCAN, &x, &y) &&
+            x == UNDO_TEST_SCAN_END && y == UNDO_TEST_SCAN_END);
+    SIM_CHECK(undo_test_send(UNDO_TEST_SCRIPT, &x, &y) &&
+            x == UNDO_TEST_SCRIPT_X && y == UNDO_TEST_SCRIPT_Y);
+    SIM_CHECK(undo_test_send(UNDO_TEST_UNDO, &x, &y) &&
+            x == UNDO_TEST_SCAN_END && y == UNDO_TEST_SCAN_END);
+    SIM_CHECK(undo_test_send(UNDO_TEST_UNDO, &x, &y) &&
+            x == UNDO_TEST_NEXT_END && y == UNDO_TEST_NEXT_END);
+}
+
+int main(void) {
+
+    sim_test_run(test_undo);
+
+    return 0;
+}
\ No newline at end of file